@@ -0,0 +1,103 @@
+#pragma once
+
+/*! \file bench.h
+  \brief Helpers shared by the benchmark drivers.
+  Drivers generate their own input from a fixed seed, so runs are reproducible without any data file.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_PATH_SIZE 32                        //!< Size of buffers receiving paths of generated files.
+
+/*! \brief Current time.
+  \return Monotonic time in milliseconds.
+*/
+static inline double getMilliseconds(void) {
+  struct timespec tsNow;
+  clock_gettime(CLOCK_MONOTONIC, &tsNow);
+  return tsNow.tv_sec * 1000.0 + tsNow.tv_nsec / 1000000.0;
+}
+
+/*! \brief Next random number.
+  Advances a xorshift64 generator.
+  \param puiState State of generator, must not be 0.
+  \return Next random number.
+*/
+static inline uint64_t nextRandom(uint64_t * puiState) {
+  uint64_t uiValue = *puiState;
+  uiValue ^= uiValue << 13;
+  uiValue ^= uiValue >> 7;
+  uiValue ^= uiValue << 17;
+  return *puiState = uiValue;
+}
+
+/*! \brief Random word.
+  Fills a buffer with random lower case letters and terminates it.
+  \param puiState State of generator.
+  \param caWord Buffer receiving word, must hold 'uiMaxLength' + 1 characters.
+  \param uiMinLength Least amount of letters.
+  \param uiMaxLength Most amount of letters.
+  \return Amount of letters written.
+*/
+static inline uint32_t randomWord(uint64_t * puiState, char * caWord, uint32_t uiMinLength, uint32_t uiMaxLength) {
+  uint32_t uiLength = uiMinLength + nextRandom(puiState) % (uiMaxLength - uiMinLength + 1);
+  uint32_t i;
+  for (i = 0; i < uiLength; ++i) {
+    caWord[i] = 'a' + nextRandom(puiState) % 26;
+  }
+  caWord[uiLength] = '\0';
+  return uiLength;
+}
+
+/*! \brief Creates a temporary file.
+  Creates a new empty file in /tmp, the caller removes it with 'unlink' when done.
+  \param caPath Receives path of file, must hold BENCH_PATH_SIZE characters.
+  \return 1 on success, else 0.
+*/
+static inline int8_t createTempFile(char * caPath) {
+  snprintf(caPath, BENCH_PATH_SIZE, "/tmp/benchXXXXXX");
+  int iFile = mkstemp(caPath);
+  if (iFile < 0) {
+    return 0;
+  }
+  close(iFile);
+  return 1;
+}
+
+/*! \brief Writes a word file.
+  Writes random lower case words in word list format, one 'word;' per line, to a file created by 'createTempFile'.
+  \param caPath Receives path of file, must hold BENCH_PATH_SIZE characters.
+  \param uiWords Amount of words.
+  \param uiMinLength Least amount of letters of a word.
+  \param uiMaxLength Most amount of letters of a word, at most 62.
+  \param uiSeed Seed of generator, must not be 0.
+  \return Size of file in bytes, 0 on failure.
+*/
+static inline size_t writeWordFile(char * caPath, uint64_t uiWords, uint32_t uiMinLength, uint32_t uiMaxLength, uint64_t uiSeed) {
+  char caWord[64];
+  size_t szSize = 0;
+  uint64_t i;
+  if (!createTempFile(caPath)) {
+    return 0;
+  }
+  FILE * file = fopen(caPath, "w");
+  if (!file) {
+    unlink(caPath);
+    return 0;
+  }
+  for (i = 0; i < uiWords; ++i) {
+    uint32_t uiLength = randomWord(&uiSeed, caWord, uiMinLength, uiMaxLength);
+    caWord[uiLength] = ';';
+    caWord[uiLength + 1] = '\n';
+    szSize += fwrite(caWord, 1, uiLength + 2, file);
+  }
+  if (fclose(file) != 0) {
+    unlink(caPath);
+    return 0;
+  }
+  return szSize;
+}
@@ -0,0 +1,131 @@
+/*! \file dictionary.c
+  \brief Dictionary lookup benchmark.
+  Looks up random existing words in a dictionary and, for comparison, by walking a list of the words with 'strcmp'.
+  Walks are linear in the amount of words, so they only run until a time budget is used up.
+  Usage: dictionary [lookups].
+*/
+
+#include "../src/array.h"
+#include "../src/dictionary.h"
+#include "../src/list.h"
+#include "../src/word.h"
+#include "bench.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_LOOKUPS 4000000                     //!< Default amount of dictionary lookups per size.
+#define BENCH_WALK_BUDGET 500.0                   //!< Time in milliseconds list walks run per size.
+
+// ----------------- Local Variables --------------------------------------
+
+static const uint32_t cauiSizes[] = { 1000, 100000, 1000000 }; //!< Amounts of words benchmarked.
+
+// ----------------- Local Function declarations --------------------------
+
+/*! \brief Walks list for word.
+  Compares every entry to the word until it is found, like membership checks did before dictionaries.
+  \param lWords List of words.
+  \param ccaWord Word to find.
+  \return 1 when found, 0 otherwise.
+*/
+static int8_t walkList(List lWords, const char * ccaWord);
+/*! \brief Benchmarks one size.
+  \param uiWords Amount of distinct words.
+  \param uiLookups Amount of dictionary lookups.
+  \return 1 on success, 0 when memory could not be allocated or a lookup failed.
+*/
+static int8_t benchSize(uint32_t uiWords, uint64_t uiLookups);
+
+// ----------------- Global Function definitions --------------------------
+
+int main(int argc, char ** argv) {
+  uint64_t uiLookups = argc > 1 ? strtoull(argv[1], NULL, 10) : BENCH_LOOKUPS;
+  uint32_t i;
+  printf("dictionary: lookups of random existing words per second\n");
+  printf("  %8s %14s %14s\n", "words", "dictionary", "list walk");
+  for (i = 0; i < sizeof(cauiSizes) / sizeof(cauiSizes[0]); ++i) {
+    if (!benchSize(cauiSizes[i], uiLookups)) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+// ----------------- Local Function definitions ---------------------------
+
+static int8_t walkList(List lWords, const char * ccaWord) {
+  Iterator it;
+  for (it = getBegin(lWords); it; moveNext(&it)) {
+    if (strcmp((const char *)getCurrent(it), ccaWord) == 0) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static int8_t benchSize(uint32_t uiWords, uint64_t uiLookups) {
+  // distinct words are drawn from the packed word space, so the dictionary keeps all of them
+  char * pText = (char *)malloc((size_t)uiWords * (WORD_LENGTH + 1));
+  uint8_t * puiSeen = (uint8_t *)calloc(WORD_SPACE / 8, 1);
+  Array aWords = createArrayWithOptions(AOBorrowedEntries);
+  List lWords = createListWithOptions(LOPooledNodes | LOBorrowedItems);
+  uint64_t uiLookup;
+  uint32_t i;
+  if (!pText || !puiSeen || !aWords || !lWords) {
+    free(pText);
+    free(puiSeen);
+    destroyArray(aWords);
+    destroyList(lWords);
+    fprintf(stderr, "Failed to allocate memory\n");
+    return 0;
+  }
+  uint64_t uiState = 0x9E3779B97F4A7C15ULL;
+  Iterator itLast = NULL;
+  int8_t iResult = 1;
+  for (i = 0; i < uiWords && iResult; ) {
+    char * pWord = pText + (size_t)i * (WORD_LENGTH + 1);
+    randomWord(&uiState, pWord, WORD_LENGTH, WORD_LENGTH);
+    PackedWord pwWord = encodeWord(pWord);
+    if (puiSeen[pwWord / 8] & (1u << (pwWord % 8))) {
+      continue;
+    }
+    puiSeen[pwWord / 8] |= 1u << (pwWord % 8);
+    iResult = appendArrayEntry(aWords, pWord) && addEntry(lWords, itLast, pWord);
+    itLast = getEnd(lWords);
+    ++i;
+  }
+  Dictionary dWords = iResult ? createDictionary(aWords) : NULL;
+  if (!dWords) {
+    iResult = 0;
+    fprintf(stderr, "Failed to allocate memory\n");
+  } else {
+    uint64_t uiFound = 0;
+    double dStart = getMilliseconds();
+    for (uiLookup = 0; uiLookup < uiLookups; ++uiLookup) {
+      uiFound += containsWord(dWords, pText + (size_t)(nextRandom(&uiState) % uiWords) * (WORD_LENGTH + 1));
+    }
+    double dDictionary = getMilliseconds() - dStart;
+    uint64_t uiWalks = 0;
+    double dWalk;
+    dStart = getMilliseconds();
+    do {
+      uiFound += walkList(lWords, pText + (size_t)(nextRandom(&uiState) % uiWords) * (WORD_LENGTH + 1));
+      ++uiWalks;
+      dWalk = getMilliseconds() - dStart;
+    } while (dWalk < BENCH_WALK_BUDGET);
+    if (uiFound != uiLookups + uiWalks) {
+      fprintf(stderr, "Lookup missed an existing word\n");
+      iResult = 0;
+    }
+    printf("  %8u %12.0f/s %12.0f/s\n", uiWords, uiLookups * 1000.0 / dDictionary, uiWalks * 1000.0 / dWalk);
+    destroyDictionary(dWords);
+  }
+  destroyList(lWords);
+  destroyArray(aWords);
+  free(puiSeen);
+  free(pText);
+  return iResult;
+}
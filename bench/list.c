@@ -0,0 +1,136 @@
+/*! \file list.c
+  \brief List benchmark.
+  Compares regular, pooled and unrolled lists of 8 byte payloads.
+  Each list is built by appending, traversed, grown by inserts at random 'getEntry' positions and destroyed.
+  Usage: list [inserts].
+*/
+
+#include "../src/list.h"
+#include "bench.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_INSERTS 1000                        //!< Default amount of indexed inserts per list.
+#define BENCH_TRAVERSALS 10                       //!< Amount of traversals averaged.
+
+// ----------------- Local Variables --------------------------------------
+
+static const uint32_t cauiSizes[] = { 10000, 100000, 1000000 }; //!< Amounts of entries benchmarked.
+static const char * ccaKinds[] = { "regular", "pooled", "unrolled" }; //!< Names of benchmarked kinds of list.
+
+// ----------------- Local Function declarations --------------------------
+
+/*! \brief Creates list of kind.
+  \param uiKind Index into 'ccaKinds'.
+  \return Created list or NULL when memory could not be allocated.
+*/
+static List createKind(uint32_t uiKind);
+/*! \brief Adds payload.
+  Unrolled lists copy the payload, other lists get a heap copy they own.
+  \param lList List to add to.
+  \param uiKind Kind of list.
+  \param iterator Entry preceding new entry, NULL for the beginning.
+  \param uiValue Payload.
+  \return 1 on success, else 0.
+*/
+static int8_t addValue(List lList, uint32_t uiKind, Iterator iterator, uint64_t uiValue);
+/*! \brief Benchmarks one kind and size.
+  \param uiKind Kind of list.
+  \param uiEntries Amount of appended entries.
+  \param uiInserts Amount of indexed inserts.
+  \return 1 on success, 0 when memory could not be allocated or entries were lost.
+*/
+static int8_t benchList(uint32_t uiKind, uint32_t uiEntries, uint32_t uiInserts);
+
+// ----------------- Global Function definitions --------------------------
+
+int main(int argc, char ** argv) {
+  uint32_t uiInserts = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : BENCH_INSERTS;
+  uint32_t uiKind;
+  uint32_t i;
+  printf("list: 8 byte payloads, times in ms, %u inserts at random indices\n", uiInserts);
+  printf("  %8s %-9s %9s %9s %9s %9s\n", "entries", "kind", "append", "traverse", "insert", "destroy");
+  for (i = 0; i < sizeof(cauiSizes) / sizeof(cauiSizes[0]); ++i) {
+    for (uiKind = 0; uiKind < sizeof(ccaKinds) / sizeof(ccaKinds[0]); ++uiKind) {
+      if (!benchList(uiKind, cauiSizes[i], uiInserts)) {
+	fprintf(stderr, "Failed to allocate memory\n");
+	return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+// ----------------- Local Function definitions ---------------------------
+
+static List createKind(uint32_t uiKind) {
+  switch (uiKind) {
+  case 0:
+    return createList();
+  case 1:
+    return createListWithOptions(LOPooledNodes);
+  default:
+    return createUnrolledList(sizeof(uint64_t));
+  }
+}
+
+static int8_t addValue(List lList, uint32_t uiKind, Iterator iterator, uint64_t uiValue) {
+  if (uiKind == 2) {
+    return addEntry(lList, iterator, &uiValue);
+  }
+  uint64_t * puiValue = (uint64_t *)malloc(sizeof(uint64_t));
+  if (!puiValue) {
+    return 0;
+  }
+  *puiValue = uiValue;
+  if (!addEntry(lList, iterator, puiValue)) {
+    free(puiValue);
+    return 0;
+  }
+  return 1;
+}
+
+static int8_t benchList(uint32_t uiKind, uint32_t uiEntries, uint32_t uiInserts) {
+  List lList = createKind(uiKind);
+  Iterator it;
+  uint32_t i;
+  if (!lList) {
+    fprintf(stderr, "Failed to allocate memory\n");
+    return 0;
+  }
+  int8_t iResult = 1;
+  double dStart = getMilliseconds();
+  for (i = 0; i < uiEntries && iResult; ++i) {
+    iResult = addValue(lList, uiKind, getEnd(lList), i);
+  }
+  double dAppend = getMilliseconds() - dStart;
+  uint64_t uiSum = 0;
+  dStart = getMilliseconds();
+  for (i = 0; i < BENCH_TRAVERSALS; ++i) {
+    for (it = getBegin(lList); it; moveNext(&it)) {
+      uiSum += *(const uint64_t *)getCurrent(it);
+    }
+  }
+  double dTraverse = (getMilliseconds() - dStart) / BENCH_TRAVERSALS;
+  // every insert looks its position up first, so this mostly measures 'getEntry'
+  uint64_t uiState = 0xA0761D6478BD642FULL;
+  dStart = getMilliseconds();
+  for (i = 0; i < uiInserts && iResult; ++i) {
+    iResult = addValue(lList, uiKind, getEntry(lList, nextRandom(&uiState) % uiEntries), i);
+  }
+  double dInsert = getMilliseconds() - dStart;
+  dStart = getMilliseconds();
+  destroyList(lList);
+  double dDestroy = getMilliseconds() - dStart;
+  if (!iResult) {
+    fprintf(stderr, "Failed to allocate memory\n");
+  } else if (uiSum != (uint64_t)uiEntries * (uiEntries - 1) / 2 * BENCH_TRAVERSALS) {
+    fprintf(stderr, "Traversal missed entries\n");
+    iResult = 0;
+  } else {
+    printf("  %8u %-9s %9.2f %9.2f %9.2f %9.2f\n", uiEntries, ccaKinds[uiKind], dAppend, dTraverse, dInsert, dDestroy);
+  }
+  return iResult;
+}
@@ -0,0 +1,124 @@
+/*! \file patterns.c
+  \brief Pattern matrix build benchmark.
+  Builds the pattern matrix of random words with 1, 2, 4, ... threads up to one per core and reports how the build scales.
+  Every matrix is compared with the single threaded one, so a faster build can not hide a wrong one.
+  Usage: patterns [words].
+*/
+
+#include "../src/dictionary.h"
+#include "../src/parallel.h"
+#include "../src/patterns.h"
+#include "../src/word.h"
+#include "bench.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_WORDS 8000                          //!< Default amount of words, the matrix holds their square in bytes.
+#define BENCH_ROUNDS 3                            //!< Builds per thread count, the fastest is reported.
+
+// ----------------- Local Function declarations --------------------------
+
+/*! \brief Creates random dictionary.
+  \param uiWords Amount of random words, repeats are dropped by the dictionary.
+  \return Created dictionary or NULL when memory could not be allocated.
+*/
+static Dictionary createRandomDictionary(uint32_t uiWords);
+/*! \brief Benchmarks one thread count.
+  \param dWords Dictionary to build matrix for.
+  \param uiThreads Amount of threads.
+  \param pmReference Single threaded matrix to compare with, or NULL.
+  \param pdMilliseconds Receives time of fastest build.
+  \return Matrix of last build or NULL when memory could not be allocated or the matrix differs from the reference.
+*/
+static PatternMatrix benchThreads(Dictionary dWords, uint32_t uiThreads, PatternMatrix pmReference, double * pdMilliseconds);
+
+// ----------------- Global Function definitions --------------------------
+
+int main(int argc, char ** argv) {
+  uint32_t uiWords = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : BENCH_WORDS;
+  uint32_t uiCores = getCoreCount();
+  uint32_t uiThreads;
+  double dSingle = 0.0;
+  double dTime;
+  Dictionary dWords = createRandomDictionary(uiWords);
+  if (!dWords) {
+    fprintf(stderr, "Failed to allocate memory\n");
+    return 1;
+  }
+  uint64_t uiCells = (uint64_t)getWordCount(dWords) * getWordCount(dWords);
+  printf("patterns: %u words, %lu cells, %u core(s)\n", getWordCount(dWords), (unsigned long)uiCells, uiCores);
+  printf("  %8s %12s %14s %9s\n", "threads", "time", "cells", "speedup");
+  PatternMatrix pmReference = NULL;
+  // powers of two, and the core count itself when it is none
+  for (uiThreads = 1;; uiThreads = uiThreads * 2 < uiCores ? uiThreads * 2 : uiCores) {
+    PatternMatrix pmPatterns = benchThreads(dWords, uiThreads, pmReference, &dTime);
+    if (!pmPatterns) {
+      destroyPatternMatrix(pmReference);
+      destroyDictionary(dWords);
+      return 1;
+    }
+    if (!pmReference) {
+      pmReference = pmPatterns;
+      dSingle = dTime;
+    } else {
+      destroyPatternMatrix(pmPatterns);
+    }
+    printf("  %8u %9.1f ms %12.0f/s %8.2fx\n", uiThreads, dTime, uiCells * 1000.0 / dTime, dSingle / dTime);
+    if (uiThreads >= uiCores) {
+      break;
+    }
+  }
+  destroyPatternMatrix(pmReference);
+  destroyDictionary(dWords);
+  return 0;
+}
+
+// ----------------- Local Function definitions ---------------------------
+
+static Dictionary createRandomDictionary(uint32_t uiWords) {
+  PackedWord * pwWords = (PackedWord *)malloc(sizeof(PackedWord) * (uiWords ? uiWords : 1));
+  char caWord[WORD_LENGTH + 1];
+  uint64_t uiState = 0x9E3779B97F4A7C15ULL;
+  uint32_t i;
+  if (!pwWords) {
+    return NULL;
+  }
+  for (i = 0; i < uiWords; ++i) {
+    randomWord(&uiState, caWord, WORD_LENGTH, WORD_LENGTH);
+    pwWords[i] = encodeWord(caWord);
+  }
+  Dictionary dWords = createPackedDictionary(pwWords, uiWords);
+  free(pwWords);
+  return dWords;
+}
+
+static PatternMatrix benchThreads(Dictionary dWords, uint32_t uiThreads, PatternMatrix pmReference, double * pdMilliseconds) {
+  PatternMatrix pmPatterns = NULL;
+  uint32_t uiRound;
+  uint32_t i;
+  *pdMilliseconds = 0.0;
+  for (uiRound = 0; uiRound < BENCH_ROUNDS; ++uiRound) {
+    destroyPatternMatrix(pmPatterns);
+    double dStart = getMilliseconds();
+    pmPatterns = buildPatternMatrix(dWords, uiThreads);
+    double dTime = getMilliseconds() - dStart;
+    if (!pmPatterns) {
+      fprintf(stderr, "Failed to allocate memory\n");
+      return NULL;
+    }
+    if (!uiRound || dTime < *pdMilliseconds) {
+      *pdMilliseconds = dTime;
+    }
+  }
+  for (i = 0; pmReference && i < getWordCount(dWords); ++i) {
+    if (memcmp(getPatternRow(pmPatterns, i), getPatternRow(pmReference, i), getWordCount(dWords) * sizeof(Pattern))) {
+      fprintf(stderr, "Matrix built with %u threads differs\n", uiThreads);
+      destroyPatternMatrix(pmPatterns);
+      return NULL;
+    }
+  }
+  return pmPatterns;
+}
@@ -0,0 +1,132 @@
+/*! \file startup.c
+  \brief Dictionary startup benchmark.
+  Measures the time from a dictionary file to the first lookup, for a text list that is parsed and indexed like '--run-game' does, and for binary dictionaries with and without index.
+  Usage: startup [words].
+*/
+
+#include "../src/array.h"
+#include "../src/dictionary.h"
+#include "../src/strpool.h"
+#include "../src/tokenizer.h"
+#include "../src/word.h"
+#include "bench.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_WORDS 1000000                       //!< Default amount of words in list.
+#define BENCH_RUNS 5                              //!< Amount of runs per format, the fastest is reported.
+
+// ----------------- Struct definitions -----------------------------------
+
+/*! \struct TextList
+  \brief Words collected while parsing a text list.
+*/
+struct TextList {
+  StringPool spPool;                              //!< Pool holding the words.
+  Array aWords;                                   //!< Words, borrowed from 'spPool'.
+};
+
+// ----------------- Local Variables --------------------------------------
+
+static const struct ParseOptions poWords = { WORD_LENGTH, WORD_LENGTH, CCAny }; //!< Filter passing only five letter tokens.
+static const char * ccaBatchWords[TOKEN_BATCH_SIZE]; //!< Words of the batch 'collectTokens' appends, kept off its stack like in 'main.c'.
+
+// ----------------- Local Function declarations --------------------------
+
+/*! \brief Collects tokens of text list.
+  \param pContext Text list to store words in.
+  \param ttType Type of the tokens.
+  \param cptvTokens Token data.
+  \param uiTokens Amount of tokens.
+  \return 0 when tokens can not be stored, otherwise 1.
+*/
+static int8_t collectTokens(void * pContext, enum TokenType ttType, const struct TokenView * cptvTokens, uint32_t uiTokens);
+/*! \brief Starts from text list.
+  Parses a text list and indexes its words.
+  \param ccaPath Path of text list.
+  \return Dictionary or NULL on failure.
+*/
+static Dictionary startFromText(const char * ccaPath);
+/*! \brief Benchmarks one format.
+  Starts a dictionary from a file several times and prints the fastest time to the first lookup.
+  \param ccaName Name of format.
+  \param ccaPath Path of file.
+  \param iText 1 for a text list, 0 for a binary dictionary.
+  \return 1 on success, 0 when the dictionary could not be started.
+*/
+static int8_t benchFormat(const char * ccaName, const char * ccaPath, int8_t iText);
+
+// ----------------- Global Function definitions --------------------------
+
+int main(int argc, char ** argv) {
+  uint64_t uiWords = argc > 1 ? strtoull(argv[1], NULL, 10) : BENCH_WORDS;
+  char caText[BENCH_PATH_SIZE];
+  char caBinary[BENCH_PATH_SIZE] = "";
+  char caCompact[BENCH_PATH_SIZE] = "";
+  if (!writeWordFile(caText, uiWords, WORD_LENGTH, WORD_LENGTH, 0xD1B54A32D192ED03ULL)) {
+    fprintf(stderr, "Failed to write word list\n");
+    return 1;
+  }
+  Dictionary dWords = startFromText(caText);
+  int8_t iResult = dWords && createTempFile(caBinary) && createTempFile(caCompact);
+  printf("startup: %llu words, %u distinct, time to first lookup\n", (unsigned long long)uiWords, dWords ? getWordCount(dWords) : 0);
+  iResult = iResult && writeDictionary(dWords, caBinary, 1) && writeDictionary(dWords, caCompact, 0);
+  destroyDictionary(dWords);
+  iResult = iResult
+    && benchFormat("text list", caText, 1)
+    && benchFormat("binary", caBinary, 0)
+    && benchFormat("compact", caCompact, 0);
+  unlink(caText);
+  unlink(caBinary);
+  unlink(caCompact);
+  if (!iResult) {
+    fprintf(stderr, "Failed to start dictionary\n");
+  }
+  return iResult ? 0 : 1;
+}
+
+// ----------------- Local Function definitions ---------------------------
+
+static int8_t collectTokens(void * pContext, enum TokenType ttType, const struct TokenView * cptvTokens, uint32_t uiTokens) {
+  struct TextList * ptlList = (struct TextList *)pContext;
+  uint32_t i;
+  for (i = 0; i < uiTokens; ++i) {
+    if (!(ccaBatchWords[i] = storeString(ptlList->spPool, cptvTokens[i].pText, cptvTokens[i].uiLength))) {
+      return 0;
+    }
+  }
+  return !uiTokens || appendArrayEntries(ptlList->aWords, (void * const *)ccaBatchWords, uiTokens);
+}
+
+static Dictionary startFromText(const char * ccaPath) {
+  struct TextList tlList = { createStringPool(), createArrayWithOptions(AOBorrowedEntries) };
+  Dictionary dWords = NULL;
+  if (tlList.spPool && tlList.aWords && parseFileBatchedWithOptions(ccaPath, collectTokens, &tlList, &poWords) == ROk) {
+    dWords = createDictionary(tlList.aWords);
+  }
+  destroyArray(tlList.aWords);
+  destroyStringPool(tlList.spPool);
+  return dWords;
+}
+
+static int8_t benchFormat(const char * ccaName, const char * ccaPath, int8_t iText) {
+  double dBest = 0;
+  uint32_t i;
+  for (i = 0; i < BENCH_RUNS; ++i) {
+    double dStart = getMilliseconds();
+    Dictionary dWords = iText ? startFromText(ccaPath) : loadDictionary(ccaPath);
+    int8_t iFound = dWords && containsPackedWord(dWords, getWord(dWords, getWordCount(dWords) / 2));
+    double dTime = getMilliseconds() - dStart;
+    destroyDictionary(dWords);
+    if (!iFound) {
+      return 0;
+    }
+    if (!i || dTime < dBest) {
+      dBest = dTime;
+    }
+  }
+  printf("  %-10s %10.3f ms\n", ccaName, dBest);
+  return 1;
+}
@@ -0,0 +1,289 @@
+/*! \file tokenizer.c
+  \brief Tokenizer benchmark.
+  Parses a generated word list with a copy of the original parse loop and with the callback, view and batch interfaces of the tokenizer.
+  The original loop reads a character at a time and keeps every letter of a token in a list entry of its own, it is the baseline of the comparison.
+  Reports throughput and the amount of allocations of each run, counted by a memory counter installed as default allocator.
+  Usage: tokenizer [words], the default of 4M words gives a list of about 48 MB.
+*/
+
+#include "../src/alloc.h"
+#include "../src/list.h"
+#include "../src/tokenizer.h"
+#include "bench.h"
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_WORDS 4000000                       //!< Default amount of words in list.
+
+// ----------------- Struct definitions -----------------------------------
+
+/*! \struct BaselineContext
+  \brief Context of the original parse loop.
+*/
+struct BaselineContext {
+  FILE * file;                                    //!< File parsed by tokenizer.
+  List list;                                      //!< List to mimic dynamic string.
+  int iLine;                                      //!< Line number of tokenizer.
+  int iColumn;                                    //!< Column number of tokenizer.
+  parserCallback fnCallback;                      //!< Callback for external token processing.
+};
+
+// ----------------- Local Variables --------------------------------------
+
+static MemoryCounter mcCounter;                   //!< Counter of all allocations.
+static uint64_t uiTokens;                         //!< Amount of tokens received in current run.
+static uint64_t uiBaselineAllocations;            //!< Amount of letters and tokens the original loop took from malloc, the counter does not see them.
+
+// ----------------- Local Function declarations --------------------------
+
+/*! \brief Parse file with the original loop.
+  Works like 'parseFile' did before tokens were collected in a reusable buffer.
+  \param path Path to a text file.
+  \param fnCallback Pointer to function called when a new token is available, tokens come from malloc.
+  \return ROk on success, error code otherwise.
+*/
+static enum ParseResults parseBaseline(const char * path, parserCallback fnCallback);
+/*! \brief Parse new line char with the original loop.
+  \param pbcContext Context of tokenizer.
+  \return Parse result.
+*/
+static enum ParseResults parseBaselineNewLine(struct BaselineContext * pbcContext);
+/*! \brief Parse expression with the original loop.
+  \param pbcContext Context of tokenizer.
+  \return Parse result.
+*/
+static enum ParseResults parseBaselineExpression(struct BaselineContext * pbcContext);
+/*! \brief Report error of the original loop and clean up.
+  \param ccaMessage Message to print.
+  \param pbcContext Context of tokenizer.
+*/
+static void reportBaselineError(const char * ccaMessage, struct BaselineContext * pbcContext);
+/*! \brief Counts token of the original loop.
+  \param ttType Type of token.
+  \param token Token, released with 'free'.
+  \return Always 1.
+*/
+static int8_t countBaselineToken(enum TokenType ttType, Token token);
+/*! \brief Counts token of callback interface.
+  \param ttType Type of token.
+  \param token Token, released through the counter.
+  \return Always 1.
+*/
+static int8_t countToken(enum TokenType ttType, Token token);
+/*! \brief Counts token of view interface.
+  \param ttType Type of token.
+  \param ptvToken View of token.
+  \return Always 1.
+*/
+static int8_t countView(enum TokenType ttType, const struct TokenView * ptvToken);
+/*! \brief Counts tokens of batch interface.
+  \param pContext Unused.
+  \param ttType Type of tokens.
+  \param ptvTokens Views of tokens.
+  \param uiCount Amount of tokens.
+  \return Always 1.
+*/
+static int8_t countBatch(void * pContext, enum TokenType ttType, const struct TokenView * ptvTokens, uint32_t uiCount);
+/*! \brief Amount of allocations.
+  \return Amount of allocations of all tags so far.
+*/
+static uint64_t getAllocations(void);
+/*! \brief Prints result of run.
+  \param ccaName Name of run.
+  \param result Result of parse function.
+  \param szSize Size of list in bytes.
+  \param dTime Duration of run in milliseconds.
+  \param uiAllocations Amount of allocations of run.
+*/
+static void printRun(const char * ccaName, enum ParseResults result, size_t szSize, double dTime, uint64_t uiAllocations);
+
+// ----------------- Global Function definitions --------------------------
+
+int main(int argc, char ** argv) {
+  uint64_t uiWords = argc > 1 ? strtoull(argv[1], NULL, 10) : BENCH_WORDS;
+  char caPath[BENCH_PATH_SIZE];
+  uint64_t uiStart;
+  double dStart;
+  enum ParseResults result;
+  mcCounter = createMemoryCounter(NULL);
+  if (!mcCounter) {
+    return 1;
+  }
+  setDefaultAllocator(getCounterAllocator(mcCounter));
+  size_t szSize = writeWordFile(caPath, uiWords, 4, 16, 0x2545F4914F6CDD1DULL);
+  if (!szSize) {
+    fprintf(stderr, "Failed to write word list\n");
+    return 1;
+  }
+  printf("tokenizer: %llu words, %.1f MB\n", (unsigned long long)uiWords, szSize / 1e6);
+  uiStart = getAllocations();
+  dStart = getMilliseconds();
+  result = parseBaseline(caPath, countBaselineToken);
+  printRun("baseline", result, szSize, getMilliseconds() - dStart, getAllocations() - uiStart + uiBaselineAllocations);
+  struct ParseOptions poCounted = { 0, 0, CCAny, getCounterAllocator(mcCounter) };
+  uiStart = getAllocations();
+  dStart = getMilliseconds();
+  result = parseFileWithOptions(caPath, countToken, &poCounted);
+  printRun("callback", result, szSize, getMilliseconds() - dStart, getAllocations() - uiStart);
+  uiStart = getAllocations();
+  dStart = getMilliseconds();
+  result = parseFileMapped(caPath, countView);
+  printRun("view", result, szSize, getMilliseconds() - dStart, getAllocations() - uiStart);
+  uiStart = getAllocations();
+  dStart = getMilliseconds();
+  result = parseFileBatched(caPath, countBatch, NULL);
+  printRun("batch", result, szSize, getMilliseconds() - dStart, getAllocations() - uiStart);
+  unlink(caPath);
+  setDefaultAllocator(NULL);
+  destroyMemoryCounter(mcCounter);
+  return 0;
+}
+
+// ----------------- Local Function definitions ---------------------------
+
+static enum ParseResults parseBaseline(const char * path, parserCallback fnCallback) {
+  struct BaselineContext bcContext;
+  bcContext.file = fopen(path, "r");
+  if (!bcContext.file) {
+    return RErrFileAccess;
+  }
+  bcContext.list = createList();
+  bcContext.iLine = 1;
+  bcContext.iColumn = 0;
+  bcContext.fnCallback = fnCallback;
+  enum ParseResults result = ROk;
+
+  int iRead;
+  while ((iRead = fgetc(bcContext.file)) != EOF) {
+    ++bcContext.iColumn;
+
+    switch (iRead) {
+    case '\n':
+      {
+	fpos_t pPos;
+	fgetpos(bcContext.file, &pPos);
+	int iTmpRead = fgetc(bcContext.file);
+	if (iTmpRead == EOF) {
+	  destroyList(bcContext.list);
+	  fclose(bcContext.file);
+	  return ROk;
+	}
+	if (iTmpRead != '\r') {
+	  fsetpos(bcContext.file, &pPos);
+	}
+      }
+    case '\r':
+      if ((result = parseBaselineNewLine(&bcContext))) {
+	reportBaselineError("Unexpected newline", &bcContext);
+	return result;
+      }
+      break;
+
+    case ';':
+      if ((result = parseBaselineExpression(&bcContext))) {
+	reportBaselineError("Unexpected ';'", &bcContext);
+	return result;
+      }
+      break;
+
+    default:
+      if ((iRead >= 'a' && iRead <= 'z') || (iRead >= 'A' && iRead <= 'Z')) {
+	char * buf = (char *)malloc(sizeof(char));
+	++uiBaselineAllocations;
+	*buf = (char)iRead;
+	addEntry(bcContext.list, getEnd(bcContext.list), (void *)buf);
+      } else if (isspace((char)iRead)) {
+	if (getSize(bcContext.list) > 0) {
+	  reportBaselineError("Missing ';'", &bcContext);
+	  return RErrMissingToken;
+	}
+      }
+      break;
+    }
+  }
+
+  destroyList(bcContext.list);
+  fclose(bcContext.file);
+  return ROk;
+}
+
+static enum ParseResults parseBaselineNewLine(struct BaselineContext * pbcContext) {
+  if (getSize(pbcContext->list) > 0) {
+    return RErrInvalidToken;
+  }
+  ++pbcContext->iLine;
+  pbcContext->iColumn = 0;
+  return ROk;
+}
+
+static enum ParseResults parseBaselineExpression(struct BaselineContext * pbcContext) {
+  int iSize;
+  if ((iSize = getSize(pbcContext->list)) > 0) {
+    char * token = (char *)malloc(sizeof(char) * (iSize + 1));
+    int i;
+    Iterator iter;
+    ++uiBaselineAllocations;
+    for (i = 0, iter = getBegin(pbcContext->list); i < iSize && iter; ++i, moveNext(&iter)) {
+      token[i] = *(char *)getCurrent(iter);
+    }
+    token[i] = '\0';
+    clearList(pbcContext->list);
+    if (!(*pbcContext->fnCallback)(TTText, (Token)token)) {
+      return RErrCanceled;
+    }
+    return ROk;
+  } else {
+    return RErrInvalidToken;
+  }
+}
+
+static void reportBaselineError(const char * ccaMessage, struct BaselineContext * pbcContext) {
+  printf("Error: %s at line %d[%d]\n", ccaMessage, pbcContext->iLine, pbcContext->iColumn);
+  destroyList(pbcContext->list);
+  fclose(pbcContext->file);
+}
+
+static int8_t countBaselineToken(enum TokenType ttType, Token token) {
+  ++uiTokens;
+  free((void *)token);
+  return 1;
+}
+
+static int8_t countToken(enum TokenType ttType, Token token) {
+  ++uiTokens;
+  freeMemory(getCounterAllocator(mcCounter), (void *)token);
+  return 1;
+}
+
+static int8_t countView(enum TokenType ttType, const struct TokenView * ptvToken) {
+  ++uiTokens;
+  return 1;
+}
+
+static int8_t countBatch(void * pContext, enum TokenType ttType, const struct TokenView * ptvTokens, uint32_t uiCount) {
+  uiTokens += uiCount;
+  return 1;
+}
+
+static uint64_t getAllocations(void) {
+  struct MemoryStats msStats;
+  uint64_t uiAllocations = 0;
+  uint32_t i;
+  for (i = 0; i < ALLOCATION_TAGS; ++i) {
+    getMemoryStats(mcCounter, (enum AllocationTags)i, &msStats);
+    uiAllocations += msStats.uiAllocations;
+  }
+  return uiAllocations;
+}
+
+static void printRun(const char * ccaName, enum ParseResults result, size_t szSize, double dTime, uint64_t uiAllocations) {
+  if (result != ROk) {
+    printf("  %-10s failed with %d\n", ccaName, result);
+  } else {
+    printf("  %-10s %10llu tokens %10llu allocations %8.1f ms %7.1f MB/s\n", ccaName, (unsigned long long)uiTokens, (unsigned long long)uiAllocations, dTime, szSize / 1e3 / dTime);
+  }
+  uiTokens = 0;
+}
@@ -0,0 +1,508 @@
+#include "alloc.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define ARENA_BLOCK_SIZE (64 * 1024)
+#define ALLOCATION_ALIGNMENT 16
+
+// ----------------- Struct definitions -----------------------------------
+
+/*! \struct AllocationHeader
+  \brief Header in front of memory of arenas and memory counters.
+  It is padded to the alignment of malloc, so the memory behind it stays aligned for any type.
+*/
+struct AllocationHeader {
+  size_t szSize;                                  //!< Amount of bytes requested.
+  uint32_t uiTag;                                 //!< Tag of allocation, as 'enum AllocationTags'.
+} __attribute__((aligned(ALLOCATION_ALIGNMENT)));
+
+/*! \struct _arena_block_
+  \brief Block of an arena.
+  Allocations larger than a regular block get a block of their own.
+*/
+struct _arena_block_ {
+  struct _arena_block_ * next;                    //!< Previously allocated block, or NULL.
+  size_t szCapacity;                              //!< Amount of bytes 'aData' can hold.
+  unsigned char aData[] __attribute__((aligned(ALLOCATION_ALIGNMENT))); //!< Allocations, each behind its header, and bytes without header.
+};
+
+/*! \struct _arena_
+  \brief Implementation of 'Arena' type.
+*/
+struct _arena_ {
+  struct Allocator aAllocator;                    //!< Hooks of arena.
+  struct _arena_block_ * blocks;                  //!< Block allocations are taken from, linked to older blocks.
+  size_t szBlockUsed;                             //!< Amount of bytes used in head block.
+  size_t szBlockSize;                             //!< Size of regular blocks.
+  size_t szSize;                                  //!< Amount of bytes of all blocks.
+  struct AllocationHeader * pahLast;              //!< Header of last allocation from head block, which can grow in place, or NULL.
+  enum AllocationTags atTag;                      //!< Tag blocks are accounted to.
+  const struct Allocator * cpaBacking;            //!< Default allocator when the arena was created, blocks come from it, NULL for malloc.
+};
+
+/*! \struct _memory_counter_
+  \brief Implementation of 'MemoryCounter' type.
+  Counters are updated atomically, so the counter can be shared by all threads.
+*/
+struct _memory_counter_ {
+  struct Allocator aAllocator;                    //!< Hooks of counter.
+  const struct Allocator * cpaBacking;            //!< Allocator memory is passed on to, or NULL for malloc.
+  struct MemoryStats amsStats[ALLOCATION_TAGS];   //!< Stats per tag.
+};
+
+
+// ----------------- Local Variables --------------------------------------
+static const struct Allocator * defaultAllocator = NULL; //!< Allocator used when NULL is passed, NULL for malloc.
+
+
+// ----------------- Local Function declarations --------------------------
+
+/*! \brief Allocate from backing allocator.
+  A NULL backing means malloc, not the default, which may have changed or be the allocator itself.
+  \param cpaBacking Allocator to allocate from, NULL for malloc.
+  \param szSize Amount of bytes.
+  \param atTag Tag of allocation.
+  \param iZeroed 1 to allocate zeroed memory, else 0.
+  \return Memory or NULL when memory could not be allocated.
+*/
+static void * allocateBacked(const struct Allocator * cpaBacking, size_t szSize, enum AllocationTags atTag, int8_t iZeroed);
+/*! \brief Free to backing allocator.
+  \param cpaBacking Allocator memory came from, NULL for malloc.
+  \param pMemory Memory to free.
+*/
+static void freeBacked(const struct Allocator * cpaBacking, void * pMemory);
+/*! \brief Take space from arena.
+  Takes space from the head block, starting a new block when it does not fit.
+  \param aArena Arena to take space from.
+  \param szNeeded Amount of bytes.
+  \param szAlignment Alignment of space within its block, a power of two up to ALLOCATION_ALIGNMENT.
+  \return Space or NULL when memory could not be allocated.
+*/
+static void * takeArenaSpace(Arena aArena, size_t szNeeded, size_t szAlignment);
+/*! \brief Allocate from arena.
+  \param pContext Arena, as 'Arena'.
+  \param szSize Amount of bytes.
+  \param atTag Tag of allocation, kept in its header.
+  \return Memory or NULL when memory could not be allocated.
+*/
+static void * allocateArena(void * pContext, size_t szSize, enum AllocationTags atTag);
+/*! \brief Resize memory of arena.
+  The last allocation grows in place while it fits its block, others are copied.
+  \param pContext Arena, as 'Arena'.
+  \param pMemory Memory to resize.
+  \param szSize Amount of bytes.
+  \param atTag Tag of allocation, unused.
+  \return Memory or NULL when memory could not be allocated.
+*/
+static void * reallocateArena(void * pContext, void * pMemory, size_t szSize, enum AllocationTags atTag);
+/*! \brief Free memory of arena.
+  Does nothing, memory is released with the arena.
+  \param pContext Arena, unused.
+  \param pMemory Memory, unused.
+*/
+static void freeArena(void * pContext, void * pMemory);
+/*! \brief Allocate through memory counter.
+  \param pContext Counter, as 'MemoryCounter'.
+  \param szSize Amount of bytes.
+  \param atTag Tag of allocation.
+  \return Memory or NULL when memory could not be allocated.
+*/
+static void * allocateCounted(void * pContext, size_t szSize, enum AllocationTags atTag);
+/*! \brief Allocate zeroed memory through memory counter.
+  \param pContext Counter, as 'MemoryCounter'.
+  \param szSize Amount of bytes.
+  \param atTag Tag of allocation.
+  \return Zeroed memory or NULL when memory could not be allocated.
+*/
+static void * allocateZeroedCounted(void * pContext, size_t szSize, enum AllocationTags atTag);
+/*! \brief Count allocation.
+  Allocates memory behind a header from the backing allocator and adds it to the stats of its tag.
+  \param mcCounter Counter to allocate through.
+  \param szSize Amount of bytes.
+  \param atTag Tag of allocation.
+  \param iZeroed 1 to allocate zeroed memory, else 0.
+  \return Memory or NULL when memory could not be allocated.
+*/
+static void * countAllocation(MemoryCounter mcCounter, size_t szSize, enum AllocationTags atTag, int8_t iZeroed);
+/*! \brief Resize memory of memory counter.
+  The memory stays accounted to the tag it was allocated with.
+  \param pContext Counter, as 'MemoryCounter'.
+  \param pMemory Memory to resize.
+  \param szSize Amount of bytes.
+  \param atTag Tag of allocation, unused.
+  \return Memory or NULL when memory could not be allocated.
+*/
+static void * reallocateCounted(void * pContext, void * pMemory, size_t szSize, enum AllocationTags atTag);
+/*! \brief Free memory of memory counter.
+  \param pContext Counter, as 'MemoryCounter'.
+  \param pMemory Memory to free.
+*/
+static void freeCounted(void * pContext, void * pMemory);
+/*! \brief Count bytes.
+  Adds bytes to the stats of a tag and raises their peak.
+  \param pmsStats Stats of tag.
+  \param szBytes Amount of bytes added.
+*/
+static inline void countBytes(struct MemoryStats * pmsStats, size_t szBytes);
+
+
+// ----------------- Global Function definitions --------------------------
+void setDefaultAllocator(const struct Allocator * cpaAllocator) {
+  defaultAllocator = cpaAllocator;
+}
+
+void * allocateMemory(const struct Allocator * cpaAllocator, size_t szSize, enum AllocationTags atTag) {
+  if (!cpaAllocator) {
+    cpaAllocator = defaultAllocator;
+  }
+  return cpaAllocator ? (*cpaAllocator->fnAllocate)(cpaAllocator->pContext, szSize, atTag) : malloc(szSize);
+}
+
+void * allocateZeroedMemory(const struct Allocator * cpaAllocator, size_t szSize, enum AllocationTags atTag) {
+  if (!cpaAllocator) {
+    cpaAllocator = defaultAllocator;
+  }
+  if (!cpaAllocator) {
+    return calloc(1, szSize);
+  }
+  if (cpaAllocator->fnAllocateZeroed) {
+    return (*cpaAllocator->fnAllocateZeroed)(cpaAllocator->pContext, szSize, atTag);
+  }
+  void * pMemory = (*cpaAllocator->fnAllocate)(cpaAllocator->pContext, szSize, atTag);
+  if (pMemory) {
+    memset(pMemory, 0, szSize);
+  }
+  return pMemory;
+}
+
+void * reallocateMemory(const struct Allocator * cpaAllocator, void * pMemory, size_t szSize, enum AllocationTags atTag) {
+  if (!cpaAllocator) {
+    cpaAllocator = defaultAllocator;
+  }
+  if (!cpaAllocator) {
+    return realloc(pMemory, szSize);
+  }
+  if (!pMemory) {
+    return (*cpaAllocator->fnAllocate)(cpaAllocator->pContext, szSize, atTag);
+  }
+  return (*cpaAllocator->fnReallocate)(cpaAllocator->pContext, pMemory, szSize, atTag);
+}
+
+void freeMemory(const struct Allocator * cpaAllocator, void * pMemory) {
+  if (!cpaAllocator) {
+    cpaAllocator = defaultAllocator;
+  }
+  if (!cpaAllocator) {
+    free(pMemory);
+  } else if (pMemory) {
+    (*cpaAllocator->fnFree)(cpaAllocator->pContext, pMemory);
+  }
+}
+
+void * allocateAlignedMemory(const struct Allocator * cpaAllocator, size_t szAlignment, size_t szSize, enum AllocationTags atTag) {
+  if (!cpaAllocator) {
+    cpaAllocator = defaultAllocator;
+  }
+  if (szAlignment < sizeof(void *) || (szAlignment & (szAlignment - 1)) || szSize % szAlignment || szSize > SIZE_MAX - szAlignment - sizeof(void *)) {
+    return NULL;
+  }
+  if (!cpaAllocator) {
+    return aligned_alloc(szAlignment, szSize);
+  }
+  // the memory the allocator returned is kept in front of the aligned memory, there is always room for it
+  unsigned char * pBlock = (unsigned char *)(*cpaAllocator->fnAllocate)(cpaAllocator->pContext, szSize + szAlignment + sizeof(void *), atTag);
+  if (!pBlock) {
+    return NULL;
+  }
+  void ** ppMemory = (void **)(((uintptr_t)pBlock + sizeof(void *) + szAlignment - 1) & ~(uintptr_t)(szAlignment - 1));
+  ppMemory[-1] = pBlock;
+  return ppMemory;
+}
+
+void freeAlignedMemory(const struct Allocator * cpaAllocator, void * pMemory) {
+  if (!cpaAllocator) {
+    cpaAllocator = defaultAllocator;
+  }
+  if (!cpaAllocator) {
+    free(pMemory);
+  } else if (pMemory) {
+    (*cpaAllocator->fnFree)(cpaAllocator->pContext, ((void **)pMemory)[-1]);
+  }
+}
+
+Arena createArena(size_t szBlockSize, enum AllocationTags atTag) {
+  // blocks keep coming from the allocator the arena started with, so they are freed where they came from
+  Arena aArena = (Arena)allocateBacked(defaultAllocator, sizeof(struct _arena_), atTag, 0);
+  if (!aArena) {
+    return NULL;
+  }
+  aArena->aAllocator.fnAllocate = &allocateArena;
+  // blocks are reused after clearing, so zeroed memory is always cleared
+  aArena->aAllocator.fnAllocateZeroed = NULL;
+  aArena->aAllocator.fnReallocate = &reallocateArena;
+  aArena->aAllocator.fnFree = &freeArena;
+  aArena->aAllocator.pContext = aArena;
+  aArena->blocks = NULL;
+  aArena->szBlockUsed = 0;
+  aArena->szBlockSize = szBlockSize ? (szBlockSize + ALLOCATION_ALIGNMENT - 1) & ~(size_t)(ALLOCATION_ALIGNMENT - 1) : ARENA_BLOCK_SIZE;
+  aArena->szSize = 0;
+  aArena->pahLast = NULL;
+  aArena->atTag = atTag;
+  aArena->cpaBacking = defaultAllocator;
+  return aArena;
+}
+
+void clearArena(Arena aArena) {
+  if (!aArena) {
+    return;
+  }
+  // keep the oldest block, it is a regular one unless the first allocation was oversized
+  struct _arena_block_ * block = aArena->blocks;
+  while (block && block->next) {
+    struct _arena_block_ * next = block->next;
+    freeBacked(aArena->cpaBacking, block);
+    block = next;
+  }
+  if (block && block->szCapacity != aArena->szBlockSize) {
+    freeBacked(aArena->cpaBacking, block);
+    block = NULL;
+  }
+  aArena->blocks = block;
+  aArena->szBlockUsed = 0;
+  aArena->szSize = block ? sizeof(struct _arena_block_) + block->szCapacity : 0;
+  aArena->pahLast = NULL;
+}
+
+void destroyArena(Arena aArena) {
+  if (!aArena) {
+    return;
+  }
+  while (aArena->blocks) {
+    struct _arena_block_ * block = aArena->blocks;
+    aArena->blocks = block->next;
+    freeBacked(aArena->cpaBacking, block);
+  }
+  freeBacked(aArena->cpaBacking, aArena);
+}
+
+void * allocateArenaBytes(Arena aArena, size_t szSize) {
+  if (!aArena || szSize > SIZE_MAX / 2) {
+    return NULL;
+  }
+  void * pBytes = takeArenaSpace(aArena, szSize, 1);
+  // the bytes may follow the last allocation, which then can not grow in place any more
+  if (pBytes) {
+    aArena->pahLast = NULL;
+  }
+  return pBytes;
+}
+
+const struct Allocator * getArenaAllocator(Arena aArena) {
+  return aArena ? &aArena->aAllocator : NULL;
+}
+
+size_t getArenaSize(Arena aArena) {
+  return aArena ? aArena->szSize : 0;
+}
+
+MemoryCounter createMemoryCounter(const struct Allocator * cpaBacking) {
+  MemoryCounter mcCounter = (MemoryCounter)calloc(1, sizeof(struct _memory_counter_));
+  if (!mcCounter) {
+    return NULL;
+  }
+  mcCounter->aAllocator.fnAllocate = &allocateCounted;
+  mcCounter->aAllocator.fnAllocateZeroed = &allocateZeroedCounted;
+  mcCounter->aAllocator.fnReallocate = &reallocateCounted;
+  mcCounter->aAllocator.fnFree = &freeCounted;
+  mcCounter->aAllocator.pContext = mcCounter;
+  mcCounter->cpaBacking = cpaBacking;
+  return mcCounter;
+}
+
+void destroyMemoryCounter(MemoryCounter mcCounter) {
+  free(mcCounter);
+}
+
+const struct Allocator * getCounterAllocator(MemoryCounter mcCounter) {
+  return mcCounter ? &mcCounter->aAllocator : NULL;
+}
+
+void getMemoryStats(MemoryCounter mcCounter, enum AllocationTags atTag, struct MemoryStats * pmsStats) {
+  if (!pmsStats) {
+    return;
+  }
+  memset(pmsStats, 0, sizeof(struct MemoryStats));
+  if (!mcCounter || (uint32_t)atTag >= ALLOCATION_TAGS) {
+    return;
+  }
+  const struct MemoryStats * cpmsStats = &mcCounter->amsStats[atTag];
+  pmsStats->szBytes = __atomic_load_n(&cpmsStats->szBytes, __ATOMIC_RELAXED);
+  pmsStats->szPeakBytes = __atomic_load_n(&cpmsStats->szPeakBytes, __ATOMIC_RELAXED);
+  pmsStats->uiAllocations = __atomic_load_n(&cpmsStats->uiAllocations, __ATOMIC_RELAXED);
+  pmsStats->uiLive = __atomic_load_n(&cpmsStats->uiLive, __ATOMIC_RELAXED);
+}
+
+
+// ----------------- Local Function definitions ---------------------------
+static void * allocateBacked(const struct Allocator * cpaBacking, size_t szSize, enum AllocationTags atTag, int8_t iZeroed) {
+  if (cpaBacking) {
+    return iZeroed ? allocateZeroedMemory(cpaBacking, szSize, atTag) : allocateMemory(cpaBacking, szSize, atTag);
+  }
+  return iZeroed ? calloc(1, szSize) : malloc(szSize);
+}
+
+static void freeBacked(const struct Allocator * cpaBacking, void * pMemory) {
+  if (cpaBacking) {
+    freeMemory(cpaBacking, pMemory);
+  } else {
+    free(pMemory);
+  }
+}
+
+static void * takeArenaSpace(Arena aArena, size_t szNeeded, size_t szAlignment) {
+  struct _arena_block_ * block = aArena->blocks;
+  size_t szStart = (aArena->szBlockUsed + szAlignment - 1) & ~(szAlignment - 1);
+  if (block && szStart <= block->szCapacity && szNeeded <= block->szCapacity - szStart) {
+    aArena->szBlockUsed = szStart + szNeeded;
+    return block->aData + szStart;
+  }
+  size_t szCapacity = szNeeded > aArena->szBlockSize ? szNeeded : aArena->szBlockSize;
+  block = (struct _arena_block_ *)allocateBacked(aArena->cpaBacking, sizeof(struct _arena_block_) + szCapacity, aArena->atTag, 0);
+  if (!block) {
+    return NULL;
+  }
+  block->szCapacity = szCapacity;
+  aArena->szSize += sizeof(struct _arena_block_) + szCapacity;
+  // an oversized allocation fills its block, it is linked behind the head so the head keeps taking small allocations
+  if (szCapacity != aArena->szBlockSize && aArena->blocks) {
+    block->next = aArena->blocks->next;
+    aArena->blocks->next = block;
+    return block->aData;
+  }
+  block->next = aArena->blocks;
+  aArena->blocks = block;
+  aArena->szBlockUsed = szNeeded;
+  return block->aData;
+}
+
+static void * allocateArena(void * pContext, size_t szSize, enum AllocationTags atTag) {
+  Arena aArena = (Arena)pContext;
+  if (szSize > SIZE_MAX / 2) {
+    return NULL;
+  }
+  size_t szNeeded = sizeof(struct AllocationHeader) + ((szSize + ALLOCATION_ALIGNMENT - 1) & ~(size_t)(ALLOCATION_ALIGNMENT - 1));
+  struct AllocationHeader * pahHeader = (struct AllocationHeader *)takeArenaSpace(aArena, szNeeded, ALLOCATION_ALIGNMENT);
+  if (!pahHeader) {
+    return NULL;
+  }
+  pahHeader->szSize = szSize;
+  pahHeader->uiTag = (uint32_t)atTag;
+  // an allocation in a block of its own can not grow in place, the last one of the head block still can
+  if ((unsigned char *)pahHeader + szNeeded == aArena->blocks->aData + aArena->szBlockUsed) {
+    aArena->pahLast = pahHeader;
+  }
+  return pahHeader + 1;
+}
+
+static void * reallocateArena(void * pContext, void * pMemory, size_t szSize, enum AllocationTags atTag) {
+  Arena aArena = (Arena)pContext;
+  struct AllocationHeader * pahHeader = (struct AllocationHeader *)pMemory - 1;
+  if (szSize > SIZE_MAX / 2) {
+    return NULL;
+  }
+  // growing token buffers are usually the last allocation, which only has to move the end of the used part of its block
+  if (pahHeader == aArena->pahLast) {
+    size_t szStart = (size_t)((unsigned char *)pahHeader - aArena->blocks->aData);
+    size_t szNeeded = sizeof(struct AllocationHeader) + ((szSize + ALLOCATION_ALIGNMENT - 1) & ~(size_t)(ALLOCATION_ALIGNMENT - 1));
+    if (szNeeded <= aArena->blocks->szCapacity - szStart) {
+      aArena->szBlockUsed = szStart + szNeeded;
+      pahHeader->szSize = szSize;
+      return pMemory;
+    }
+  }
+  if (szSize <= pahHeader->szSize) {
+    pahHeader->szSize = szSize;
+    return pMemory;
+  }
+  void * pGrown = allocateArena(pContext, szSize, atTag);
+  if (pGrown) {
+    memcpy(pGrown, pMemory, pahHeader->szSize);
+  }
+  return pGrown;
+}
+
+static void freeArena(void * pContext, void * pMemory) {
+  (void)pContext;
+  (void)pMemory;
+}
+
+static void * allocateCounted(void * pContext, size_t szSize, enum AllocationTags atTag) {
+  return countAllocation((MemoryCounter)pContext, szSize, atTag, 0);
+}
+
+static void * allocateZeroedCounted(void * pContext, size_t szSize, enum AllocationTags atTag) {
+  return countAllocation((MemoryCounter)pContext, szSize, atTag, 1);
+}
+
+static void * reallocateCounted(void * pContext, void * pMemory, size_t szSize, enum AllocationTags atTag) {
+  MemoryCounter mcCounter = (MemoryCounter)pContext;
+  struct AllocationHeader * pahHeader = (struct AllocationHeader *)pMemory - 1;
+  size_t szOld = pahHeader->szSize;
+  (void)atTag;
+  if (szSize > SIZE_MAX - sizeof(struct AllocationHeader)) {
+    return NULL;
+  }
+  if (mcCounter->cpaBacking) {
+    pahHeader = (struct AllocationHeader *)reallocateMemory(mcCounter->cpaBacking, pahHeader, sizeof(struct AllocationHeader) + szSize, (enum AllocationTags)pahHeader->uiTag);
+  } else {
+    pahHeader = (struct AllocationHeader *)realloc(pahHeader, sizeof(struct AllocationHeader) + szSize);
+  }
+  if (!pahHeader) {
+    return NULL;
+  }
+  pahHeader->szSize = szSize;
+  struct MemoryStats * pmsStats = &mcCounter->amsStats[pahHeader->uiTag];
+  if (szSize >= szOld) {
+    countBytes(pmsStats, szSize - szOld);
+  } else {
+    __atomic_fetch_sub(&pmsStats->szBytes, szOld - szSize, __ATOMIC_RELAXED);
+  }
+  return pahHeader + 1;
+}
+
+static void freeCounted(void * pContext, void * pMemory) {
+  MemoryCounter mcCounter = (MemoryCounter)pContext;
+  struct AllocationHeader * pahHeader = (struct AllocationHeader *)pMemory - 1;
+  struct MemoryStats * pmsStats = &mcCounter->amsStats[pahHeader->uiTag];
+  __atomic_fetch_sub(&pmsStats->szBytes, pahHeader->szSize, __ATOMIC_RELAXED);
+  __atomic_fetch_sub(&pmsStats->uiLive, 1, __ATOMIC_RELAXED);
+  freeBacked(mcCounter->cpaBacking, pahHeader);
+}
+
+static void * countAllocation(MemoryCounter mcCounter, size_t szSize, enum AllocationTags atTag, int8_t iZeroed) {
+  if ((uint32_t)atTag >= ALLOCATION_TAGS) {
+    atTag = ATOther;
+  }
+  if (szSize > SIZE_MAX - sizeof(struct AllocationHeader)) {
+    return NULL;
+  }
+  struct AllocationHeader * pahHeader = (struct AllocationHeader *)allocateBacked(mcCounter->cpaBacking, sizeof(struct AllocationHeader) + szSize, atTag, iZeroed);
+  if (!pahHeader) {
+    return NULL;
+  }
+  pahHeader->szSize = szSize;
+  pahHeader->uiTag = (uint32_t)atTag;
+  struct MemoryStats * pmsStats = &mcCounter->amsStats[atTag];
+  countBytes(pmsStats, szSize);
+  __atomic_fetch_add(&pmsStats->uiAllocations, 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&pmsStats->uiLive, 1, __ATOMIC_RELAXED);
+  return pahHeader + 1;
+}
+
+static inline void countBytes(struct MemoryStats * pmsStats, size_t szBytes) {
+  size_t szNow = __atomic_add_fetch(&pmsStats->szBytes, szBytes, __ATOMIC_RELAXED);
+  size_t szPeak = __atomic_load_n(&pmsStats->szPeakBytes, __ATOMIC_RELAXED);
+  while (szNow > szPeak && !__atomic_compare_exchange_n(&pmsStats->szPeakBytes, &szPeak, szNow, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+  }
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+/*! \file alloc.h
+  \brief Pluggable memory allocation.
+  Subsystems allocate through an 'Allocator' and tag every allocation with what it is for.
+  Passing NULL selects the process default, which is malloc unless replaced by 'setDefaultAllocator'.
+  An arena releases all its allocations at once, a memory counter reports bytes and allocations per tag.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ALLOCATION_TAGS 6                         //!< Amount of 'AllocationTags'.
+
+/*! \enum AllocationTags
+  \brief Subsystems memory is accounted to.
+*/
+enum AllocationTags {
+  ATListNodes = 0,                                //!< Lists, their iterators, slabs and unrolled nodes.
+  ATTokenBuffers = 1,                             //!< Token buffers, batches, chunk collections, read buffers and tokens copied by the tokenizer.
+  ATDictionaryWords = 2,                          //!< Dictionaries, their words, presence bitmaps, candidate indices and snapshots, word arrays, string pools and word lists being merged.
+  ATMatchState = 3,                               //!< Candidate sets, solvers, strategies, server and client sessions and simulations of running matches.
+  ATPatternMatrix = 4,                            //!< Pattern matrices built in memory, mapped matrix files are not accounted.
+  ATOther = 5                                     //!< Anything else, e.g. temporary buffers and paths.
+};
+
+typedef void * (*allocatorAllocate)(void * pContext, size_t szSize, enum AllocationTags atTag); //!< Allocates memory, returns NULL on failure.
+typedef void * (*allocatorAllocateZeroed)(void * pContext, size_t szSize, enum AllocationTags atTag); //!< Allocates zeroed memory, returns NULL on failure.
+typedef void * (*allocatorReallocate)(void * pContext, void * pMemory, size_t szSize, enum AllocationTags atTag); //!< Resizes memory like 'realloc', returns NULL and keeps the memory on failure.
+typedef void (*allocatorFree)(void * pContext, void * pMemory); //!< Frees memory, ignores NULL.
+
+/*! \struct Allocator
+  \brief Allocation hooks.
+  Memory is aligned for any type, like memory returned by malloc.
+  Memory must be resized and freed by the allocator it came from.
+  Zeroed allocations are optional, they let fresh pages of large allocations stay untouched until used, like calloc.
+*/
+struct Allocator {
+  allocatorAllocate fnAllocate;                   //!< Allocates memory.
+  allocatorAllocateZeroed fnAllocateZeroed;       //!< Allocates zeroed memory, or NULL to clear memory from 'fnAllocate'.
+  allocatorReallocate fnReallocate;               //!< Resizes memory.
+  allocatorFree fnFree;                           //!< Frees memory.
+  void * pContext;                                //!< Context passed to the hooks.
+};
+
+/*! \struct MemoryStats
+  \brief Memory accounted to one tag by a memory counter.
+*/
+struct MemoryStats {
+  size_t szBytes;                                 //!< Amount of bytes currently allocated.
+  size_t szPeakBytes;                             //!< Most amount of bytes allocated at once.
+  uint64_t uiAllocations;                         //!< Amount of allocations so far, resizes not included.
+  uint64_t uiLive;                                //!< Amount of allocations not freed yet.
+};
+
+typedef struct _arena_ * Arena;                   //!< Arena type.
+typedef struct _memory_counter_ * MemoryCounter;  //!< Memory counter type.
+
+// ----------------- Allocation functions ---------------------------------
+
+/*! \brief Set default allocator.
+  Replaces the allocator used when NULL is passed, NULL restores malloc.
+  Memory is freed by the allocator it came from, so the default may only be replaced at startup, before anything is allocated through it.
+  The default allocator is used from several threads and must be thread-safe.
+  \param cpaAllocator Allocator to use by default, must stay valid until replaced.
+*/
+void setDefaultAllocator(const struct Allocator * cpaAllocator);
+
+/*! \brief Allocate memory.
+  \param cpaAllocator Allocator to use, NULL for the default.
+  \param szSize Amount of bytes.
+  \param atTag Subsystem memory is accounted to.
+  \return Memory or NULL when memory could not be allocated.
+*/
+void * allocateMemory(const struct Allocator * cpaAllocator, size_t szSize, enum AllocationTags atTag);
+/*! \brief Allocate zeroed memory.
+  Works like 'calloc', the default allocator leaves pages it gets fresh from the system untouched.
+  \param cpaAllocator Allocator to use, NULL for the default.
+  \param szSize Amount of bytes.
+  \param atTag Subsystem memory is accounted to.
+  \return Zeroed memory or NULL when memory could not be allocated.
+*/
+void * allocateZeroedMemory(const struct Allocator * cpaAllocator, size_t szSize, enum AllocationTags atTag);
+/*! \brief Resize memory.
+  Works like 'realloc', NULL memory is allocated.
+  \param cpaAllocator Allocator memory came from, NULL for the default.
+  \param pMemory Memory to resize, or NULL.
+  \param szSize Amount of bytes.
+  \param atTag Subsystem memory is accounted to.
+  \return Resized memory or NULL when memory could not be allocated, in which case 'pMemory' stays valid.
+*/
+void * reallocateMemory(const struct Allocator * cpaAllocator, void * pMemory, size_t szSize, enum AllocationTags atTag);
+/*! \brief Free memory.
+  \param cpaAllocator Allocator memory came from, NULL for the default.
+  \param pMemory Memory to free, or NULL.
+*/
+void freeMemory(const struct Allocator * cpaAllocator, void * pMemory);
+/*! \brief Allocate aligned memory.
+  Allocates memory aligned beyond malloc, e.g. for blocks found by masking addresses inside them.
+  Malloc is replaced by 'aligned_alloc', other allocators are asked for 'szAlignment' and a pointer more bytes and the memory is aligned within,
+  so a memory counter accounts the padding too.
+  \param cpaAllocator Allocator to use, NULL for the default.
+  \param szAlignment Alignment, a power of two of at least the size of a pointer.
+  \param szSize Amount of bytes, a multiple of 'szAlignment'.
+  \param atTag Subsystem memory is accounted to.
+  \return Memory or NULL when memory could not be allocated or the arguments are invalid, must be freed by 'freeAlignedMemory'.
+*/
+void * allocateAlignedMemory(const struct Allocator * cpaAllocator, size_t szAlignment, size_t szSize, enum AllocationTags atTag);
+/*! \brief Free aligned memory.
+  \param cpaAllocator Allocator memory came from, NULL for the default.
+  \param pMemory Memory from 'allocateAlignedMemory' to free, or NULL.
+*/
+void freeAlignedMemory(const struct Allocator * cpaAllocator, void * pMemory);
+
+// ----------------- Arena functions --------------------------------------
+
+/*! \brief Creates an arena.
+  Creates an allocator handing out memory from large blocks, freeing single allocations does nothing.
+  All memory is released at once by 'clearArena' or 'destroyArena', so nothing allocated from an arena can leak.
+  Blocks come from the default allocator at creation and are accounted to the tag of the arena, whatever the tags of allocations from it.
+  Arenas are not thread-safe, so they can not back the default allocator.
+  Each arena created by this function must be destroyed by 'destroyArena(Arena)' to avoid memory leaks.
+  \param szBlockSize Size of blocks in bytes, 0 for the default of 64 KB.
+  \param atTag Subsystem blocks are accounted to.
+  \return Created arena or NULL when memory could not be allocated.
+*/
+Arena createArena(size_t szBlockSize, enum AllocationTags atTag);
+/*! \brief Clears an arena.
+  Releases all memory allocated from the arena, the first block is kept for reuse.
+  \param aArena Arena to clear.
+*/
+void clearArena(Arena aArena);
+/*! \brief Destroys an arena.
+  Destroys an arena and all memory allocated from it.
+  \param aArena Arena to destroy.
+*/
+void destroyArena(Arena aArena);
+/*! \brief Allocate bytes from arena.
+  Takes bytes without header or alignment, so data like strings can be packed back to back.
+  The bytes are released with the arena, they can not be resized or passed to the allocator of the arena.
+  \param aArena Arena to allocate from.
+  \param szSize Amount of bytes.
+  \return Bytes or NULL when memory could not be allocated.
+*/
+void * allocateArenaBytes(Arena aArena, size_t szSize);
+/*! \brief Get allocator of arena.
+  \param aArena Arena to allocate from.
+  \return Allocator valid until the arena is destroyed.
+*/
+const struct Allocator * getArenaAllocator(Arena aArena);
+/*! \brief Get size of arena.
+  \param aArena Arena to get size of.
+  \return Amount of bytes of all blocks of the arena.
+*/
+size_t getArenaSize(Arena aArena);
+
+// ----------------- Memory counter functions -----------------------------
+
+/*! \brief Creates a memory counter.
+  Creates a thread-safe allocator counting bytes and allocations per tag and passing the memory on to another allocator.
+  Each counter created by this function must be destroyed by 'destroyMemoryCounter(MemoryCounter)' to avoid memory leaks.
+  \param cpaBacking Allocator to pass memory on to, NULL for malloc.
+  \return Created counter or NULL when memory could not be allocated.
+*/
+MemoryCounter createMemoryCounter(const struct Allocator * cpaBacking);
+/*! \brief Destroys a memory counter.
+  Memory still allocated through the counter must not be freed afterwards.
+  \param mcCounter Counter to destroy.
+*/
+void destroyMemoryCounter(MemoryCounter mcCounter);
+/*! \brief Get allocator of memory counter.
+  \param mcCounter Counter to allocate through.
+  \return Allocator valid until the counter is destroyed.
+*/
+const struct Allocator * getCounterAllocator(MemoryCounter mcCounter);
+/*! \brief Get memory stats.
+  Returns the memory accounted to a tag so far.
+  \param mcCounter Counter to get stats of.
+  \param atTag Tag to get stats of.
+  \param pmsStats Receives stats.
+*/
+void getMemoryStats(MemoryCounter mcCounter, enum AllocationTags atTag, struct MemoryStats * pmsStats);
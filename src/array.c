@@ -0,0 +1,131 @@
+#include "array.h"
+
+#include "alloc.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ARRAY_START 16
+
+// ----------------- Struct definitions -----------------------------------
+
+/*! \struct _array_
+  \brief Implementation of 'Array' type.
+  Arrays hold pointers to their entries in one contiguous block that grows geometrically.
+  Outside of translation unit array may only be refered to by pointers.
+*/
+struct _array_ {
+  void ** ppItems;                                //!< Pointers to data of entries.
+  uint32_t uiSize;                                //!< Entry counter.
+  uint32_t uiCapacity;                            //!< Amount of entries 'ppItems' can hold.
+  uint32_t uiOptions;                             //!< Combination of 'ArrayOptions'.
+};
+
+
+// ----------------- Global Function definitions --------------------------
+Array createArray() {
+  return createArrayWithOptions(AODefault);
+}
+
+Array createArrayWithOptions(uint32_t uiOptions) {
+  Array array = (Array)allocateMemory(NULL, sizeof(struct _array_), ATDictionaryWords);
+  // do not try to initialize an array when memory was not allocated
+  if (!array) {
+    return NULL;
+  }
+  // set array to empty state, storage is allocated on first append
+  array->ppItems = NULL;
+  array->uiSize = 0;
+  array->uiCapacity = 0;
+  array->uiOptions = uiOptions;
+  return array;
+}
+
+void clearArray(Array array) {
+  // do not try to clear a non-existing array
+  if (!array) {
+    return;
+  }
+  uint32_t i;
+  for (i = 0; !(array->uiOptions & AOBorrowedEntries) && i < array->uiSize; ++i) {
+    free(array->ppItems[i]);
+  }
+  array->uiSize = 0;
+}
+
+void destroyArray(Array array) {
+  // do not try to destroy when we got nothing to destroy
+  if (!array) {
+    return;
+  }
+  // clear frees all items, only then storage and array can be safely deallocated
+  clearArray(array);
+  freeMemory(NULL, array->ppItems);
+  freeMemory(NULL, array);
+}
+
+uint32_t getArraySize(Array array) {
+  // do not try to get size of non existing array
+  if (!array) {
+    return 0;
+  }
+  return array->uiSize;
+}
+
+void * getArrayEntry(Array array, uint32_t uiIndex) {
+  if (!array || uiIndex >= array->uiSize) {
+    return NULL;
+  }
+  return array->ppItems[uiIndex];
+}
+
+int8_t appendArrayEntry(Array array, void * pItem) {
+  // do not try to add to non existing array or add a non existing item
+  if (!array || !pItem) {
+    return 0;
+  }
+  // double capacity when full, which makes appending amortized constant time
+  if (array->uiSize == array->uiCapacity) {
+    uint32_t uiCapacity = array->uiCapacity ? array->uiCapacity * 2 : ARRAY_START;
+    void ** ppItems = (void **)reallocateMemory(NULL, array->ppItems, sizeof(void *) * uiCapacity, ATDictionaryWords);
+    if (!ppItems) {
+      return 0;
+    }
+    array->ppItems = ppItems;
+    array->uiCapacity = uiCapacity;
+  }
+  array->ppItems[array->uiSize++] = pItem;
+  return 1;
+}
+
+int8_t appendArrayEntries(Array array, void * const * ppItems, uint32_t uiCount) {
+  if (!array || (uiCount && !ppItems) || uiCount > UINT32_MAX - array->uiSize) {
+    return 0;
+  }
+  if (array->uiSize + uiCount > array->uiCapacity) {
+    uint32_t uiCapacity = array->uiCapacity ? array->uiCapacity : ARRAY_START;
+    while (uiCapacity < array->uiSize + uiCount) {
+      uiCapacity = uiCapacity > UINT32_MAX / 2 ? UINT32_MAX : uiCapacity * 2;
+    }
+    void ** ppGrown = (void **)reallocateMemory(NULL, array->ppItems, sizeof(void *) * uiCapacity, ATDictionaryWords);
+    if (!ppGrown) {
+      return 0;
+    }
+    array->ppItems = ppGrown;
+    array->uiCapacity = uiCapacity;
+  }
+  memcpy(array->ppItems + array->uiSize, ppItems, sizeof(void *) * uiCount);
+  array->uiSize += uiCount;
+  return 1;
+}
+
+int8_t removeArrayEntry(Array array) {
+  if (!array || !array->uiSize) {
+    return 0;
+  }
+  --array->uiSize;
+  if (!(array->uiOptions & AOBorrowedEntries)) {
+    free(array->ppItems[array->uiSize]);
+  }
+  return 1;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+/*! \file array.h
+  \brief Dynamic array.
+  Array-backed counterpart of 'List', entries are stored contiguously and accessed by index in constant time.
+*/
+
+#include <stdint.h>
+
+typedef struct _array_ * Array;                   //!< Dynamic array type.
+
+/*! \enum ArrayOptions
+  \brief Options of an array, may be combined.
+*/
+enum ArrayOptions {
+  AODefault = 0,                                  //!< Data of entries is owned and freed by the array.
+  AOBorrowedEntries = 1                           //!< Data of entries is owned elsewhere, e.g. by a 'StringPool', and never freed by the array.
+};
+
+/*! \brief Creates a new array.
+  Creates a new, empty array and returns it.
+  Each array created by this function must be destroyed by 'destroyArray(Array)' to avoid memory leaks.
+  \return Created array.
+*/
+Array createArray();
+/*! \brief Creates a new array with options.
+  Creates a new, empty array using given options and returns it.
+  Each array created by this function must be destroyed by 'destroyArray(Array)' to avoid memory leaks.
+  \param uiOptions Combination of 'ArrayOptions'.
+  \return Created array.
+*/
+Array createArrayWithOptions(uint32_t uiOptions);
+/*! \brief Clears an array.
+  Clears an array, destroying all entries, borrowed entries are only dropped in constant time.
+  Capacity is kept, so refilling the array does not allocate again.
+  \param array Array to clear.
+*/
+void clearArray(Array array);
+/*! \brief Destroys an array.
+  Destroys an array and all entries.
+  \param array Array to destroy.
+*/
+void destroyArray(Array array);
+
+/*! \brief Get size of an array.
+  Returns the total amount of entries in the array.
+  \param array Array to get size of.
+  \return Size of the array.
+*/
+uint32_t getArraySize(Array array);
+
+/*! \brief Get entry at given location.
+  Returns the data of the entry at given index in constant time.
+  \param array Array to get entry from.
+  \param uiIndex Index of entry.
+  \return Pointer to data or NULL when index is equal or greater to size.
+*/
+void * getArrayEntry(Array array, uint32_t uiIndex);
+
+/*! \brief Append entry to array.
+  Adds an entry to the end of the array, in amortized constant time.
+  \param array Array to add entry to.
+  \param pItem Pointer to data of new entry, ownership passes to the array unless entries are borrowed.
+  \return 1 on success, else 0.
+*/
+int8_t appendArrayEntry(Array array, void * pItem);
+/*! \brief Append entries to array.
+  Adds several entries to the end of the array with at most one reallocation.
+  Nothing is added when capacity can not be grown.
+  \param array Array to add entries to.
+  \param ppItems Pointers to data of new entries, none may be NULL, ownership passes to the array unless entries are borrowed.
+  \param uiCount Amount of entries.
+  \return 1 on success, else 0.
+*/
+int8_t appendArrayEntries(Array array, void * const * ppItems, uint32_t uiCount);
+/*! \brief Remove last entry from array.
+  Removes the last entry of the array, destroying it.
+  \param array Array to remove entry from.
+  \return 1 on success, else 0.
+*/
+int8_t removeArrayEntry(Array array);
@@ -0,0 +1,237 @@
+#include "candidates.h"
+
+#include "alloc.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define POSITION_MASKS (WORD_LENGTH * LETTER_COUNT)
+#define COUNT_MASKS (LETTER_COUNT * WORD_LENGTH)
+#define MAX_TERMS (3 * WORD_LENGTH)
+
+// ----------------- Struct definitions -----------------------------------
+
+/*! \struct _candidate_index_
+  \brief Implementation of 'CandidateIndex' type.
+  Masks are stored back to back, 'uiBlocks' machine words each.
+  Position mask of letter l at position p is number p * LETTER_COUNT + l.
+  Count mask of letter l occurring at least k times is number POSITION_MASKS + l * WORD_LENGTH + k - 1.
+*/
+struct _candidate_index_ {
+  Dictionary dWords;                              //!< Indexed dictionary.
+  uint32_t uiCount;                               //!< Amount of words.
+  uint32_t uiBlocks;                              //!< Machine words per mask.
+  uint64_t * puiMasks;                            //!< All masks.
+};
+
+/*! \struct _candidate_set_
+  \brief Implementation of 'CandidateSet' type.
+*/
+struct _candidate_set_ {
+  CandidateIndex ciIndex;                         //!< Index of dictionary.
+  uint64_t * puiBits;                             //!< Bit per word, set while word is a candidate.
+  uint32_t uiCandidates;                          //!< Amount of set bits.
+};
+
+/*! \struct MaskTerm
+  \brief One mask a set is intersected with.
+*/
+struct MaskTerm {
+  const uint64_t * cpuiMask;                      //!< Mask.
+  uint64_t uiInvert;                              //!< 0 to keep words in mask, all ones to keep words not in mask.
+};
+
+
+// ----------------- Local Function declarations --------------------------
+
+/*! \brief Get mask.
+  \param ciIndex Index to get mask from.
+  \param uiMask Number of mask.
+  \return First machine word of mask.
+*/
+static inline uint64_t * getMask(CandidateIndex ciIndex, uint32_t uiMask);
+/*! \brief Intersect set with masks.
+  Applies all terms in one pass and recounts the set.
+  \param csCandidates Set to narrow.
+  \param cpmtTerms Terms to apply.
+  \param uiTerms Amount of terms.
+  \return Amount of candidates left.
+*/
+static uint32_t applyTerms(CandidateSet csCandidates, const struct MaskTerm * cpmtTerms, uint32_t uiTerms);
+
+
+// ----------------- Global Function definitions --------------------------
+CandidateIndex createCandidateIndex(Dictionary dWords) {
+  CandidateIndex ciIndex = (CandidateIndex)allocateMemory(NULL, sizeof(struct _candidate_index_), ATDictionaryWords);
+  if (!ciIndex) {
+    return NULL;
+  }
+  ciIndex->dWords = dWords;
+  ciIndex->uiCount = getWordCount(dWords);
+  ciIndex->uiBlocks = (ciIndex->uiCount + 63) / 64;
+  size_t szMasks = sizeof(uint64_t) * ((size_t)(POSITION_MASKS + COUNT_MASKS) * ciIndex->uiBlocks + 1);
+  ciIndex->puiMasks = (uint64_t *)allocateZeroedMemory(NULL, szMasks, ATDictionaryWords);
+  if (!ciIndex->puiMasks) {
+    freeMemory(NULL, ciIndex);
+    return NULL;
+  }
+  uint32_t i;
+  uint8_t j;
+  for (i = 0; i < ciIndex->uiCount; ++i) {
+    PackedWord pwWord = getWord(dWords, i);
+    uint8_t auiOccurrences[LETTER_COUNT] = { 0 };
+    uint64_t uiBit = 1ull << (i % 64);
+    for (j = 0; j < WORD_LENGTH; ++j) {
+      uint8_t uiLetter = getLetter(pwWord, j);
+      getMask(ciIndex, j * LETTER_COUNT + uiLetter)[i / 64] |= uiBit;
+      getMask(ciIndex, POSITION_MASKS + uiLetter * WORD_LENGTH + auiOccurrences[uiLetter]++)[i / 64] |= uiBit;
+    }
+  }
+  return ciIndex;
+}
+
+void destroyCandidateIndex(CandidateIndex ciIndex) {
+  if (!ciIndex) {
+    return;
+  }
+  freeMemory(NULL, ciIndex->puiMasks);
+  freeMemory(NULL, ciIndex);
+}
+
+CandidateSet createCandidateSet(CandidateIndex ciIndex) {
+  CandidateSet csCandidates = (CandidateSet)allocateMemory(NULL, sizeof(struct _candidate_set_), ATMatchState);
+  if (!csCandidates) {
+    return NULL;
+  }
+  csCandidates->ciIndex = ciIndex;
+  csCandidates->puiBits = (uint64_t *)allocateMemory(NULL, sizeof(uint64_t) * (ciIndex->uiBlocks + 1), ATMatchState);
+  if (!csCandidates->puiBits) {
+    freeMemory(NULL, csCandidates);
+    return NULL;
+  }
+  resetCandidates(csCandidates);
+  return csCandidates;
+}
+
+void destroyCandidateSet(CandidateSet csCandidates) {
+  if (!csCandidates) {
+    return;
+  }
+  freeMemory(NULL, csCandidates->puiBits);
+  freeMemory(NULL, csCandidates);
+}
+
+void resetCandidates(CandidateSet csCandidates) {
+  uint32_t uiCount = csCandidates->ciIndex->uiCount;
+  memset(csCandidates->puiBits, 0xff, sizeof(uint64_t) * (uiCount / 64));
+  // bits past the last word stay clear, so counting never needs a tail mask
+  if (uiCount % 64) {
+    csCandidates->puiBits[uiCount / 64] = (1ull << (uiCount % 64)) - 1;
+  }
+  csCandidates->uiCandidates = uiCount;
+}
+
+uint32_t narrowCandidates(CandidateSet csCandidates, PackedWord pwGuess, Pattern pFeedback) {
+  CandidateIndex ciIndex = csCandidates->ciIndex;
+  struct MaskTerm amtTerms[MAX_TERMS];
+  uint8_t auiMarked[LETTER_COUNT] = { 0 };
+  uint8_t auiAbsent[LETTER_COUNT] = { 0 };
+  uint32_t uiTerms = 0;
+  uint8_t i;
+  for (i = 0; i < WORD_LENGTH; ++i) {
+    uint8_t uiLetter = getLetter(pwGuess, i);
+    uint8_t uiDigit = getPatternDigit(pFeedback, i);
+    // correct letters must be at their position, any other guessed letter must not be
+    amtTerms[uiTerms].cpuiMask = getMask(ciIndex, i * LETTER_COUNT + uiLetter);
+    amtTerms[uiTerms++].uiInvert = uiDigit == 2 ? 0 : ~0ull;
+    if (uiDigit) {
+      ++auiMarked[uiLetter];
+    } else {
+      auiAbsent[uiLetter] = 1;
+    }
+  }
+  for (i = 0; i < WORD_LENGTH; ++i) {
+    uint8_t uiLetter = getLetter(pwGuess, i);
+    // every letter is handled once, at its first occurrence
+    if (auiMarked[uiLetter] == UINT8_MAX) {
+      continue;
+    }
+    // a letter marked n times occurs at least n times, and exactly n times once a copy was reported absent
+    if (auiMarked[uiLetter]) {
+      amtTerms[uiTerms].cpuiMask = getMask(ciIndex, POSITION_MASKS + uiLetter * WORD_LENGTH + auiMarked[uiLetter] - 1);
+      amtTerms[uiTerms++].uiInvert = 0;
+    }
+    if (auiAbsent[uiLetter] && auiMarked[uiLetter] < WORD_LENGTH) {
+      amtTerms[uiTerms].cpuiMask = getMask(ciIndex, POSITION_MASKS + uiLetter * WORD_LENGTH + auiMarked[uiLetter]);
+      amtTerms[uiTerms++].uiInvert = ~0ull;
+    }
+    auiMarked[uiLetter] = UINT8_MAX;
+  }
+  return applyTerms(csCandidates, amtTerms, uiTerms);
+}
+
+uint32_t requireLetter(CandidateSet csCandidates, uint8_t uiPosition, uint8_t uiLetter) {
+  struct MaskTerm mtTerm = { getMask(csCandidates->ciIndex, uiPosition % WORD_LENGTH * LETTER_COUNT + uiLetter % LETTER_COUNT), 0 };
+  return applyTerms(csCandidates, &mtTerm, 1);
+}
+
+uint32_t getCandidateCount(CandidateSet csCandidates) {
+  return csCandidates->uiCandidates;
+}
+
+int8_t isCandidate(CandidateSet csCandidates, uint32_t uiWord) {
+  if (uiWord >= csCandidates->ciIndex->uiCount) {
+    return 0;
+  }
+  return (int8_t)((csCandidates->puiBits[uiWord / 64] >> (uiWord % 64)) & 1);
+}
+
+uint32_t getNextCandidate(CandidateSet csCandidates, uint32_t uiFrom) {
+  uint32_t uiBlocks = csCandidates->ciIndex->uiBlocks;
+  uint32_t uiBlock = uiFrom / 64;
+  if (uiBlock >= uiBlocks) {
+    return UINT32_MAX;
+  }
+  uint64_t uiBits = csCandidates->puiBits[uiBlock] & (~0ull << (uiFrom % 64));
+  while (!uiBits) {
+    if (++uiBlock == uiBlocks) {
+      return UINT32_MAX;
+    }
+    uiBits = csCandidates->puiBits[uiBlock];
+  }
+  return uiBlock * 64 + (uint32_t)__builtin_ctzll(uiBits);
+}
+
+uint32_t getCandidates(CandidateSet csCandidates, uint32_t * puiWords) {
+  uint32_t uiWritten = 0;
+  uint32_t i;
+  for (i = 0; i < csCandidates->ciIndex->uiBlocks; ++i) {
+    uint64_t uiBits = csCandidates->puiBits[i];
+    while (uiBits) {
+      puiWords[uiWritten++] = i * 64 + (uint32_t)__builtin_ctzll(uiBits);
+      uiBits &= uiBits - 1;
+    }
+  }
+  return uiWritten;
+}
+
+
+// ----------------- Local Function definitions ---------------------------
+static inline uint64_t * getMask(CandidateIndex ciIndex, uint32_t uiMask) {
+  return ciIndex->puiMasks + (size_t)uiMask * ciIndex->uiBlocks;
+}
+
+static uint32_t applyTerms(CandidateSet csCandidates, const struct MaskTerm * cpmtTerms, uint32_t uiTerms) {
+  uint32_t uiCandidates = 0;
+  uint32_t i;
+  uint32_t j;
+  for (i = 0; i < csCandidates->ciIndex->uiBlocks; ++i) {
+    uint64_t uiBits = csCandidates->puiBits[i];
+    for (j = 0; j < uiTerms && uiBits; ++j) {
+      uiBits &= cpmtTerms[j].cpuiMask[i] ^ cpmtTerms[j].uiInvert;
+    }
+    csCandidates->puiBits[i] = uiBits;
+    uiCandidates += (uint32_t)__builtin_popcountll(uiBits);
+  }
+  csCandidates->uiCandidates = uiCandidates;
+  return uiCandidates;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+/*! \file candidates.h
+  \brief Candidate sets.
+  A candidate set is a bitset over a dictionary marking the words still consistent with the feedback seen so far.
+  Feedback is applied with a handful of precomputed masks per guess, a pass over N/64 machine words instead of a check per word.
+*/
+
+#include "dictionary.h"
+#include "feedback.h"
+#include <stdint.h>
+
+typedef struct _candidate_index_ * CandidateIndex; //!< Precomputed letter masks of a dictionary, read-only after creation.
+typedef struct _candidate_set_ * CandidateSet;    //!< Candidate set type.
+
+/*! \brief Creates a candidate index.
+  Precomputes for every position and letter the words having that letter there, and for every letter and count the words containing the letter at least that often.
+  Each index created by this function must be destroyed by 'destroyCandidateIndex(CandidateIndex)' to avoid memory leaks.
+  \param dWords Dictionary to index, must outlive the index.
+  \return Created index or NULL when memory could not be allocated.
+*/
+CandidateIndex createCandidateIndex(Dictionary dWords);
+/*! \brief Destroys a candidate index.
+  \param ciIndex Index to destroy.
+*/
+void destroyCandidateIndex(CandidateIndex ciIndex);
+
+/*! \brief Creates a candidate set.
+  Creates a set containing every word of the indexed dictionary.
+  Each set created by this function must be destroyed by 'destroyCandidateSet(CandidateSet)' to avoid memory leaks.
+  \param ciIndex Index of dictionary, must outlive the set.
+  \return Created set or NULL when memory could not be allocated.
+*/
+CandidateSet createCandidateSet(CandidateIndex ciIndex);
+/*! \brief Destroys a candidate set.
+  \param csCandidates Set to destroy.
+*/
+void destroyCandidateSet(CandidateSet csCandidates);
+/*! \brief Resets a candidate set.
+  Makes every word a candidate again.
+  \param csCandidates Set to reset.
+*/
+void resetCandidates(CandidateSet csCandidates);
+/*! \brief Narrow candidates by feedback.
+  Removes every candidate that would not have produced the given feedback for the given guess.
+  The feedback must be one that some word can produce, see feedback.h for how repeated letters are reported.
+  \param csCandidates Set to narrow.
+  \param pwGuess Packed guess.
+  \param pFeedback Pattern received for guess.
+  \return Amount of candidates left.
+*/
+uint32_t narrowCandidates(CandidateSet csCandidates, PackedWord pwGuess, Pattern pFeedback);
+/*! \brief Narrow candidates by letter.
+  Removes every candidate not having a letter at a position.
+  \param csCandidates Set to narrow.
+  \param uiPosition Position, 0 is the first letter.
+  \param uiLetter Letter index, 0 for 'a' to 25 for 'z'.
+  \return Amount of candidates left.
+*/
+uint32_t requireLetter(CandidateSet csCandidates, uint8_t uiPosition, uint8_t uiLetter);
+/*! \brief Get amount of candidates.
+  The amount is maintained while narrowing, so this is constant time.
+  \param csCandidates Set to count.
+  \return Amount of candidates.
+*/
+uint32_t getCandidateCount(CandidateSet csCandidates);
+/*! \brief Is word a candidate.
+  \param csCandidates Set to check.
+  \param uiWord Dictionary index of word.
+  \return 1 when word is a candidate, else 0.
+*/
+int8_t isCandidate(CandidateSet csCandidates, uint32_t uiWord);
+/*! \brief Get next candidate.
+  Enumerates candidates in index order, start with 0 and continue with the returned index + 1.
+  \param csCandidates Set to enumerate.
+  \param uiFrom Smallest index to return.
+  \return Dictionary index of first candidate at or after 'uiFrom', or UINT32_MAX when there is none.
+*/
+uint32_t getNextCandidate(CandidateSet csCandidates, uint32_t uiFrom);
+/*! \brief Get all candidates.
+  Writes the dictionary indices of all candidates in ascending order.
+  \param csCandidates Set to enumerate.
+  \param puiWords Receives 'getCandidateCount(CandidateSet)' indices.
+  \return Amount of indices written.
+*/
+uint32_t getCandidates(CandidateSet csCandidates, uint32_t * puiWords);
@@ -0,0 +1,181 @@
+#include "client.h"
+
+#include "alloc.h"
+#include "candidates.h"
+#include "feedback.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#define CLIENT_LINE 64
+
+// ----------------- Struct definitions -----------------------------------
+
+/*! \struct ClientSession
+  \brief One simulated player.
+*/
+struct ClientSession {
+  int iSocket;                                    //!< Connection to server.
+  CandidateSet csCandidates;                      //!< Words consistent with feedback of current match.
+  PackedWord pwGuess;                             //!< Last guess sent.
+  uint32_t uiMatchesLeft;                         //!< Matches still to start.
+  int8_t iInMatch;                                //!< A match is running.
+  int8_t iWaiting;                                //!< A request is waiting for its response.
+  struct timespec tsSent;                         //!< Time the pending request was sent.
+  char caInput[CLIENT_LINE];                      //!< Received bytes of current response.
+  uint32_t uiInput;                               //!< Amount of bytes in 'caInput'.
+};
+
+
+// ----------------- Local Function declarations --------------------------
+
+/*! \brief Send next request.
+  Starts a match or guesses the first candidate.
+  \param dWords Dictionary of matches.
+  \param pcsSession Session to send request of.
+  \return 1 when a request was sent, 0 when session is done or sending failed.
+*/
+static int8_t sendRequest(Dictionary dWords, struct ClientSession * pcsSession);
+/*! \brief Receive response.
+  Reads one response line and updates the session.
+  \param pcsSession Session to receive response of.
+  \param pcrResults Results to count finished matches in.
+  \return 1 on success, 0 when the connection failed or the response was unexpected.
+*/
+static int8_t receiveResponse(struct ClientSession * pcsSession, struct ClientResults * pcrResults);
+/*! \brief Get seconds between two times.
+  \param ctsStart Earlier time.
+  \param ctsEnd Later time.
+  \return Seconds.
+*/
+static inline double getSeconds(const struct timespec * ctsStart, const struct timespec * ctsEnd);
+
+
+// ----------------- Global Function definitions --------------------------
+int8_t runClient(Dictionary dWords, const char * ccaPath, uint32_t uiSessions, uint32_t uiMatches, struct ClientResults * pcrResults) {
+  struct sockaddr_un saAddress;
+  memset(pcrResults, 0, sizeof(struct ClientResults));
+  if (strlen(ccaPath) >= sizeof(saAddress.sun_path)) {
+    return 0;
+  }
+  memset(&saAddress, 0, sizeof(saAddress));
+  saAddress.sun_family = AF_UNIX;
+  strcpy(saAddress.sun_path, ccaPath);
+  CandidateIndex ciIndex = createCandidateIndex(dWords);
+  struct ClientSession * pcsSessions = (struct ClientSession *)allocateZeroedMemory(NULL, sizeof(struct ClientSession) * uiSessions, ATMatchState);
+  int8_t iResult = ciIndex && pcsSessions;
+  uint32_t i;
+  for (i = 0; iResult && i < uiSessions; ++i) {
+    pcsSessions[i].uiMatchesLeft = uiMatches;
+    pcsSessions[i].csCandidates = createCandidateSet(ciIndex);
+    pcsSessions[i].iSocket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    iResult = pcsSessions[i].csCandidates && pcsSessions[i].iSocket >= 0
+      && !connect(pcsSessions[i].iSocket, (struct sockaddr *)&saAddress, sizeof(saAddress));
+  }
+
+  struct timespec tsStart, tsEnd;
+  double dRoundTrips = 0.0;
+  clock_gettime(CLOCK_MONOTONIC, &tsStart);
+  int8_t iActive = iResult;
+  while (iResult && iActive) {
+    // every session has one request in flight, so the server sees all of them at once
+    iActive = 0;
+    for (i = 0; i < uiSessions; ++i) {
+      pcsSessions[i].iWaiting = sendRequest(dWords, &pcsSessions[i]);
+      pcsSessions[i].uiInput = 0;
+      iActive |= pcsSessions[i].iWaiting;
+    }
+    for (i = 0; iResult && i < uiSessions; ++i) {
+      if (!pcsSessions[i].iWaiting) {
+	continue;
+      }
+      iResult = receiveResponse(&pcsSessions[i], pcrResults);
+      clock_gettime(CLOCK_MONOTONIC, &tsEnd);
+      dRoundTrips += getSeconds(&pcsSessions[i].tsSent, &tsEnd);
+      ++pcrResults->uiRequests;
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &tsEnd);
+  pcrResults->dSeconds = getSeconds(&tsStart, &tsEnd);
+  pcrResults->dRoundTrip = pcrResults->uiRequests ? dRoundTrips / pcrResults->uiRequests : 0.0;
+
+  for (i = 0; pcsSessions && i < uiSessions; ++i) {
+    if (pcsSessions[i].iSocket > 0) {
+      close(pcsSessions[i].iSocket);
+    }
+    destroyCandidateSet(pcsSessions[i].csCandidates);
+  }
+  freeMemory(NULL, pcsSessions);
+  destroyCandidateIndex(ciIndex);
+  return iResult;
+}
+
+
+// ----------------- Local Function definitions ---------------------------
+static int8_t sendRequest(Dictionary dWords, struct ClientSession * pcsSession) {
+  char caRequest[CLIENT_LINE];
+  int iLength;
+  if (pcsSession->iInMatch) {
+    char caWord[WORD_LENGTH + 1];
+    pcsSession->pwGuess = getWord(dWords, getNextCandidate(pcsSession->csCandidates, 0));
+    decodeWord(pcsSession->pwGuess, caWord);
+    iLength = snprintf(caRequest, sizeof(caRequest), "GUESS %s\n", caWord);
+  } else if (pcsSession->uiMatchesLeft) {
+    --pcsSession->uiMatchesLeft;
+    iLength = snprintf(caRequest, sizeof(caRequest), "NEW\n");
+  } else {
+    return 0;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &pcsSession->tsSent);
+  return send(pcsSession->iSocket, caRequest, (size_t)iLength, MSG_NOSIGNAL) == iLength;
+}
+
+static int8_t receiveResponse(struct ClientSession * pcsSession, struct ClientResults * pcrResults) {
+  char * pcEnd = NULL;
+  while (!pcEnd) {
+    ssize_t sRead = recv(pcsSession->iSocket, pcsSession->caInput + pcsSession->uiInput, CLIENT_LINE - 1 - pcsSession->uiInput, 0);
+    if (sRead < 0 && errno == EINTR) {
+      continue;
+    }
+    if (sRead <= 0) {
+      return 0;
+    }
+    pcsSession->uiInput += (uint32_t)sRead;
+    pcsSession->caInput[pcsSession->uiInput] = '\0';
+    pcEnd = strchr(pcsSession->caInput, '\n');
+    if (!pcEnd && pcsSession->uiInput == CLIENT_LINE - 1) {
+      return 0;
+    }
+  }
+  *pcEnd = '\0';
+  char * caLine = pcsSession->caInput;
+  if (!strncmp(caLine, "OK ", 3)) {
+    // the tip gives the first letter away
+    resetCandidates(pcsSession->csCandidates);
+    requireLetter(pcsSession->csCandidates, 0, (uint8_t)(caLine[3] - 'a'));
+    pcsSession->iInMatch = 1;
+  } else if (!strncmp(caLine, "FEEDBACK ", 9) && strlen(caLine) >= 9 + WORD_LENGTH) {
+    uint8_t auiDigits[WORD_LENGTH];
+    uint8_t i;
+    for (i = 0; i < WORD_LENGTH; ++i) {
+      auiDigits[i] = (uint8_t)(caLine[9 + i] - '0');
+    }
+    narrowCandidates(pcsSession->csCandidates, pcsSession->pwGuess, encodePattern(auiDigits));
+  } else if (!strncmp(caLine, "WON ", 4) || !strncmp(caLine, "LOST ", 5)) {
+    pcsSession->iInMatch = 0;
+    pcrResults->uiWins += caLine[0] == 'W';
+    ++pcrResults->uiMatches;
+  } else {
+    return 0;
+  }
+  return 1;
+}
+
+static inline double getSeconds(const struct timespec * ctsStart, const struct timespec * ctsEnd) {
+  return (ctsEnd->tv_sec - ctsStart->tv_sec) + (ctsEnd->tv_nsec - ctsStart->tv_nsec) / 1e9;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+/*! \file client.h
+  \brief Load test client.
+  Plays matches against a game server with many concurrent sessions, standing in for real players.
+  Every session guesses the first word consistent with the feedback it received, see server.h for the protocol.
+*/
+
+#include "dictionary.h"
+#include <stdint.h>
+
+/*! \struct ClientResults
+  \brief Outcome of a load test.
+*/
+struct ClientResults {
+  uint64_t uiRequests;                            //!< Amount of requests answered.
+  uint32_t uiMatches;                             //!< Amount of matches finished.
+  uint32_t uiWins;                                //!< Amount of matches won.
+  double dSeconds;                                //!< Wall clock time of test.
+  double dRoundTrip;                              //!< Mean time from sending a request to receiving its response, in seconds.
+};
+
+/*! \brief Runs load test.
+  Connects all sessions, then lets every session send one request per step and waits for all responses.
+  \param dWords Dictionary the server was started with.
+  \param ccaPath Path of Unix domain socket of server.
+  \param uiSessions Amount of concurrent sessions.
+  \param uiMatches Amount of matches per session.
+  \param pcrResults Receives results.
+  \return 1 on success, 0 when a session failed or the server responded unexpectedly.
+*/
+int8_t runClient(Dictionary dWords, const char * ccaPath, uint32_t uiSessions, uint32_t uiMatches, struct ClientResults * pcrResults);
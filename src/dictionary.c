@@ -0,0 +1,452 @@
+#include "dictionary.h"
+
+#include "alloc.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define BITMAP_WORDS (WORD_SPACE / 64)
+#define FILE_MAGIC "SLDICT\0"
+#define FILE_VERSION 1
+#define FILE_BYTE_ORDER 0x01020304u
+
+// ----------------- Struct definitions -----------------------------------
+
+/*! \enum DictionaryFileFlags
+  \brief Flags of a binary dictionary file.
+*/
+enum DictionaryFileFlags {
+  DFPresenceIndex = 1,                            //!< File contains the presence bitmap.
+  DFKnownFlags = DFPresenceIndex                  //!< All flags this version reads, files with other flags are rejected.
+};
+
+/*! \struct DictionaryHeader
+  \brief Header of a binary dictionary file.
+  The header is followed by the sorted packed words and, when flagged, the presence bitmap.
+  Both sections start at a multiple of 64 bytes, so they can be used directly from a mapping.
+*/
+struct DictionaryHeader {
+  char acMagic[8];                                //!< FILE_MAGIC.
+  uint32_t uiVersion;                             //!< FILE_VERSION.
+  uint32_t uiByteOrder;                           //!< FILE_BYTE_ORDER as written by the producing machine.
+  uint32_t uiFlags;                               //!< Combination of 'DictionaryFileFlags'.
+  uint32_t uiCount;                               //!< Amount of words.
+  uint64_t uiWordsOffset;                         //!< Offset of word section from start of file.
+  uint64_t uiIndexOffset;                         //!< Offset of presence bitmap from start of file, 0 when absent.
+};
+
+/*! \struct _dictionary_
+  \brief Implementation of 'Dictionary' type.
+  Words are kept packed in an array for indexed access.
+  Membership uses a bitmap with one bit per possible packed word (2^25 bits, 4 MB), so a lookup is a single load.
+  The bitmap is allocated zeroed, pages no word falls into are never touched.
+  A dictionary loaded from file points into its mapping or its copy of the file, without bitmap the sorted words are binary searched.
+*/
+struct _dictionary_ {
+  const PackedWord * pwWords;                     //!< Words in input order, or sorted when loaded from file.
+  uint32_t uiCount;                               //!< Amount of words.
+  const uint64_t * puiPresent;                    //!< Presence bitmap indexed by packed word, or NULL.
+  void * pMapping;                                //!< Mapping or copy of dictionary file, or NULL when words are allocated.
+  size_t szMapping;                               //!< Size of mapping.
+  int8_t iCopied;                                 //!< File was read into allocated memory instead of mapped.
+};
+
+
+// ----------------- Local Function declarations --------------------------
+
+/*! \brief Test presence bit.
+  Returns the presence bit of a packed word.
+  \param cpuiPresent Presence bitmap.
+  \param pwWord Valid packed word.
+  \return 1 when present, else 0.
+*/
+static inline int8_t testPresent(const uint64_t * cpuiPresent, PackedWord pwWord);
+/*! \brief Compare packed words.
+  Comparator for 'qsort'.
+  \param cpLeft Pointer to left word.
+  \param cpRight Pointer to right word.
+  \return Negative, zero or positive like 'strcmp'.
+*/
+static int compareWords(const void * cpLeft, const void * cpRight);
+/*! \brief Check words of file.
+  Returns a value indicating words are valid packed words in strictly ascending order, as written by 'writeDictionary'.
+  With a presence bitmap, the bit of every word must be set and no other bit, so lookups agree with the words.
+  \param cpwWords Words to check.
+  \param uiCount Amount of words.
+  \param cpuiPresent Presence bitmap of file, or NULL.
+  \return 1 when valid, else 0.
+*/
+static int8_t checkWords(const PackedWord * cpwWords, uint32_t uiCount, const uint64_t * cpuiPresent);
+/*! \brief Count presence bits.
+  Counts the bits set in a presence bitmap, a popcnt clone is selected at run-time when supported.
+  \param cpuiPresent Presence bitmap.
+  \return Amount of bits set.
+*/
+static uint64_t countPresent(const uint64_t * cpuiPresent);
+/*! \brief Read file.
+  Maps a file or reads it into allocated memory.
+  \param iFile File to read.
+  \param szSize Size of file.
+  \param iCopied 1 to read into memory, 0 to map.
+  \return Contents of file or NULL when it could not be mapped or read completely.
+*/
+static void * readFile(int iFile, size_t szSize, int8_t iCopied);
+/*! \brief Release file.
+  Unmaps or frees the contents of a file returned by 'readFile'.
+  \param pFile Contents of file.
+  \param szSize Size of file.
+  \param iCopied 1 when file was read into memory, 0 when it was mapped.
+*/
+static void releaseFile(void * pFile, size_t szSize, int8_t iCopied);
+/*! \brief Align offset.
+  Rounds an offset up to the next multiple of 64.
+  \param uiOffset Offset to align.
+  \return Aligned offset.
+*/
+static inline uint64_t alignOffset(uint64_t uiOffset);
+/*! \brief Write padding.
+  Writes zero bytes until the file reaches an offset.
+  \param file File to write to.
+  \param uiFrom Current offset in file.
+  \param uiTo Offset to pad to.
+  \return 1 on success, else 0.
+*/
+static int8_t writePadding(FILE * file, uint64_t uiFrom, uint64_t uiTo);
+
+
+// ----------------- Global Function definitions --------------------------
+Dictionary createDictionary(Array aWords) {
+  uint32_t uiSize = getArraySize(aWords);
+  PackedWord * pwWords = (PackedWord *)allocateMemory(NULL, sizeof(PackedWord) * (uiSize ? uiSize : 1), ATOther);
+  if (!pwWords) {
+    return NULL;
+  }
+  uint32_t i;
+  for (i = 0; i < uiSize; ++i) {
+    pwWords[i] = encodeWord((const char *)getArrayEntry(aWords, i));
+  }
+  Dictionary dWords = createPackedDictionary(pwWords, uiSize);
+  freeMemory(NULL, pwWords);
+  return dWords;
+}
+
+Dictionary createPackedDictionary(const PackedWord * cpwWords, uint32_t uiCount) {
+  Dictionary dWords = (Dictionary)allocateMemory(NULL, sizeof(struct _dictionary_), ATDictionaryWords);
+  if (!dWords) {
+    return NULL;
+  }
+  PackedWord * pwWords = (PackedWord *)allocateMemory(NULL, sizeof(PackedWord) * (uiCount ? uiCount : 1), ATDictionaryWords);
+  uint64_t * puiPresent = (uint64_t *)allocateZeroedMemory(NULL, sizeof(uint64_t) * BITMAP_WORDS, ATDictionaryWords);
+  dWords->pwWords = pwWords;
+  dWords->uiCount = 0;
+  dWords->puiPresent = puiPresent;
+  dWords->pMapping = NULL;
+  dWords->szMapping = 0;
+  dWords->iCopied = 0;
+  if (!pwWords || !puiPresent) {
+    destroyDictionary(dWords);
+    return NULL;
+  }
+  uint32_t i;
+  for (i = 0; i < uiCount; ++i) {
+    PackedWord pwWord = cpwWords[i];
+    // skip anything not a word and keep only the first occurence of a word
+    if (pwWord >= WORD_SPACE || testPresent(puiPresent, pwWord)) {
+      continue;
+    }
+    puiPresent[pwWord / 64] |= (uint64_t)1 << (pwWord % 64);
+    pwWords[dWords->uiCount++] = pwWord;
+  }
+  return dWords;
+}
+
+Dictionary loadDictionary(const char * path) {
+  return loadDictionaryWithOptions(path, DODefault);
+}
+
+Dictionary loadDictionaryWithOptions(const char * path, uint32_t uiOptions) {
+  int8_t iCopied = (uiOptions & DOCopied) != 0;
+  int iFile = open(path, O_RDONLY);
+  if (iFile < 0) {
+    return NULL;
+  }
+  struct stat sStat;
+  if (fstat(iFile, &sStat) || (size_t)sStat.st_size < sizeof(struct DictionaryHeader)) {
+    close(iFile);
+    return NULL;
+  }
+  // a copy is validated and used as read, later writes to the file can not reach it
+  void * pMapping = readFile(iFile, (size_t)sStat.st_size, iCopied);
+  close(iFile);
+  if (!pMapping) {
+    return NULL;
+  }
+  // validate header and section bounds, then the words in one pass, they are used in place afterwards
+  const struct DictionaryHeader * cpdhHeader = (const struct DictionaryHeader *)pMapping;
+  uint64_t uiSize = (uint64_t)sStat.st_size;
+  int8_t iValid = !memcmp(cpdhHeader->acMagic, FILE_MAGIC, sizeof(cpdhHeader->acMagic))
+    && cpdhHeader->uiVersion == FILE_VERSION
+    && cpdhHeader->uiByteOrder == FILE_BYTE_ORDER
+    && !(cpdhHeader->uiFlags & ~(uint32_t)DFKnownFlags)
+    && cpdhHeader->uiWordsOffset % 64 == 0
+    && cpdhHeader->uiWordsOffset <= uiSize
+    && (uiSize - cpdhHeader->uiWordsOffset) / sizeof(PackedWord) >= cpdhHeader->uiCount;
+  if (iValid && (cpdhHeader->uiFlags & DFPresenceIndex)) {
+    iValid = cpdhHeader->uiIndexOffset % 64 == 0
+      && cpdhHeader->uiIndexOffset <= uiSize
+      && (uiSize - cpdhHeader->uiIndexOffset) / sizeof(uint64_t) >= BITMAP_WORDS;
+  }
+  const uint64_t * cpuiPresent = (cpdhHeader->uiFlags & DFPresenceIndex) ? (const uint64_t *)((const char *)pMapping + cpdhHeader->uiIndexOffset) : NULL;
+  iValid = iValid && checkWords((const PackedWord *)((const char *)pMapping + cpdhHeader->uiWordsOffset), cpdhHeader->uiCount, cpuiPresent);
+  Dictionary dWords = iValid ? (Dictionary)allocateMemory(NULL, sizeof(struct _dictionary_), ATDictionaryWords) : NULL;
+  if (!dWords) {
+    releaseFile(pMapping, (size_t)sStat.st_size, iCopied);
+    return NULL;
+  }
+  dWords->pwWords = (const PackedWord *)((const char *)pMapping + cpdhHeader->uiWordsOffset);
+  dWords->uiCount = cpdhHeader->uiCount;
+  dWords->puiPresent = cpuiPresent;
+  dWords->pMapping = pMapping;
+  dWords->szMapping = (size_t)sStat.st_size;
+  dWords->iCopied = iCopied;
+  return dWords;
+}
+
+int8_t isDictionaryFile(const char * path) {
+  char acMagic[8];
+  FILE * file = fopen(path, "rb");
+  if (!file) {
+    return 0;
+  }
+  int8_t iResult = fread(acMagic, sizeof(acMagic), 1, file) == 1 && !memcmp(acMagic, FILE_MAGIC, sizeof(acMagic));
+  fclose(file);
+  return iResult;
+}
+
+int8_t writeDictionary(Dictionary dWords, const char * path, int8_t iWithIndex) {
+  if (!dWords) {
+    return 0;
+  }
+  PackedWord * pwSorted = (PackedWord *)allocateMemory(NULL, sizeof(PackedWord) * (dWords->uiCount ? dWords->uiCount : 1), ATOther);
+  if (!pwSorted) {
+    return 0;
+  }
+  memcpy(pwSorted, dWords->pwWords, sizeof(PackedWord) * dWords->uiCount);
+  qsort(pwSorted, dWords->uiCount, sizeof(PackedWord), &compareWords);
+
+  struct DictionaryHeader dhHeader;
+  memset(&dhHeader, 0, sizeof(dhHeader));
+  memcpy(dhHeader.acMagic, FILE_MAGIC, sizeof(dhHeader.acMagic));
+  dhHeader.uiVersion = FILE_VERSION;
+  dhHeader.uiByteOrder = FILE_BYTE_ORDER;
+  dhHeader.uiCount = dWords->uiCount;
+  dhHeader.uiWordsOffset = alignOffset(sizeof(dhHeader));
+  uint64_t uiWordsEnd = dhHeader.uiWordsOffset + sizeof(PackedWord) * (uint64_t)dWords->uiCount;
+  if (iWithIndex) {
+    dhHeader.uiFlags |= DFPresenceIndex;
+    dhHeader.uiIndexOffset = alignOffset(uiWordsEnd);
+  }
+
+  // readers may have the old file mapped, so it is replaced by a rename instead of being rewritten in place
+  char * caTempPath = (char *)allocateMemory(NULL, strlen(path) + sizeof(".tmp"), ATOther);
+  FILE * file = NULL;
+  if (caTempPath) {
+    strcpy(caTempPath, path);
+    strcat(caTempPath, ".tmp");
+    file = fopen(caTempPath, "wb");
+  }
+  if (!file) {
+    freeMemory(NULL, caTempPath);
+    freeMemory(NULL, pwSorted);
+    return 0;
+  }
+  int8_t iResult = fwrite(&dhHeader, sizeof(dhHeader), 1, file) == 1
+    && writePadding(file, sizeof(dhHeader), dhHeader.uiWordsOffset)
+    && fwrite(pwSorted, sizeof(PackedWord), dWords->uiCount, file) == dWords->uiCount;
+  freeMemory(NULL, pwSorted);
+  if (iResult && iWithIndex) {
+    // a dictionary without bitmap only comes from file, and then it has no index to copy, so build one
+    uint64_t * puiPresent = (uint64_t *)dWords->puiPresent;
+    if (!puiPresent) {
+      puiPresent = (uint64_t *)allocateZeroedMemory(NULL, sizeof(uint64_t) * BITMAP_WORDS, ATOther);
+      uint32_t i;
+      for (i = 0; puiPresent && i < dWords->uiCount; ++i) {
+	puiPresent[dWords->pwWords[i] / 64] |= (uint64_t)1 << (dWords->pwWords[i] % 64);
+      }
+    }
+    iResult = puiPresent
+      && writePadding(file, uiWordsEnd, dhHeader.uiIndexOffset)
+      && fwrite(puiPresent, sizeof(uint64_t), BITMAP_WORDS, file) == BITMAP_WORDS;
+    if (puiPresent != dWords->puiPresent) {
+      freeMemory(NULL, puiPresent);
+    }
+  }
+  if (fclose(file)) {
+    iResult = 0;
+  }
+  if (iResult && rename(caTempPath, path)) {
+    iResult = 0;
+  }
+  if (!iResult) {
+    unlink(caTempPath);
+  }
+  freeMemory(NULL, caTempPath);
+  return iResult;
+}
+
+void destroyDictionary(Dictionary dWords) {
+  if (!dWords) {
+    return;
+  }
+  if (dWords->pMapping) {
+    releaseFile(dWords->pMapping, dWords->szMapping, dWords->iCopied);
+  } else {
+    freeMemory(NULL, (void *)dWords->pwWords);
+    freeMemory(NULL, (void *)dWords->puiPresent);
+  }
+  freeMemory(NULL, dWords);
+}
+
+uint32_t getWordCount(Dictionary dWords) {
+  if (!dWords) {
+    return 0;
+  }
+  return dWords->uiCount;
+}
+
+PackedWord getWord(Dictionary dWords, uint32_t uiIndex) {
+  if (!dWords || uiIndex >= dWords->uiCount) {
+    return INVALID_WORD;
+  }
+  return dWords->pwWords[uiIndex];
+}
+
+const PackedWord * getWords(Dictionary dWords) {
+  if (!dWords) {
+    return NULL;
+  }
+  return dWords->pwWords;
+}
+
+uint64_t getDictionaryHash(Dictionary dWords) {
+  uint64_t uiHash = 14695981039346656037u;
+  uint32_t i;
+  uint8_t j;
+  for (i = 0; i < getWordCount(dWords); ++i) {
+    for (j = 0; j < sizeof(PackedWord); ++j) {
+      uiHash ^= (uint8_t)(dWords->pwWords[i] >> (8 * j));
+      uiHash *= 1099511628211u;
+    }
+  }
+  return uiHash;
+}
+
+int8_t containsWord(Dictionary dWords, const char * ccaWord) {
+  return containsPackedWord(dWords, encodeWord(ccaWord));
+}
+
+int8_t containsPackedWord(Dictionary dWords, PackedWord pwWord) {
+  if (!dWords || pwWord >= WORD_SPACE) {
+    return 0;
+  }
+  if (dWords->puiPresent) {
+    return testPresent(dWords->puiPresent, pwWord);
+  }
+  // only dictionaries loaded from file lack a bitmap, their words are sorted
+  uint32_t uiLow = 0;
+  uint32_t uiHigh = dWords->uiCount;
+  while (uiLow < uiHigh) {
+    uint32_t uiMiddle = uiLow + (uiHigh - uiLow) / 2;
+    if (dWords->pwWords[uiMiddle] < pwWord) {
+      uiLow = uiMiddle + 1;
+    } else {
+      uiHigh = uiMiddle;
+    }
+  }
+  return uiLow < dWords->uiCount && dWords->pwWords[uiLow] == pwWord;
+}
+
+
+// ----------------- Local Function definitions ---------------------------
+static inline int8_t testPresent(const uint64_t * cpuiPresent, PackedWord pwWord) {
+  return (int8_t)((cpuiPresent[pwWord / 64] >> (pwWord % 64)) & 1);
+}
+
+static int compareWords(const void * cpLeft, const void * cpRight) {
+  PackedWord pwLeft = *(const PackedWord *)cpLeft;
+  PackedWord pwRight = *(const PackedWord *)cpRight;
+  return (pwLeft > pwRight) - (pwLeft < pwRight);
+}
+
+static int8_t checkWords(const PackedWord * cpwWords, uint32_t uiCount, const uint64_t * cpuiPresent) {
+  uint32_t i;
+  // words index the letter tables through 'getLetter', so out of range words must never reach them
+  for (i = 0; i < uiCount; ++i) {
+    if (cpwWords[i] >= WORD_SPACE || (i && cpwWords[i] <= cpwWords[i - 1]) || (cpuiPresent && !testPresent(cpuiPresent, cpwWords[i]))) {
+      return 0;
+    }
+  }
+  if (!cpuiPresent) {
+    return 1;
+  }
+  // every word has its bit and words are distinct, so matching counts leave no bit for a word not in the list
+  return countPresent(cpuiPresent) == uiCount;
+}
+
+__attribute__((target_clones("popcnt", "default")))
+static uint64_t countPresent(const uint64_t * cpuiPresent) {
+  uint64_t uiBits = 0;
+  uint32_t i;
+  for (i = 0; i < BITMAP_WORDS; ++i) {
+    uiBits += (uint64_t)__builtin_popcountll(cpuiPresent[i]);
+  }
+  return uiBits;
+}
+
+static void * readFile(int iFile, size_t szSize, int8_t iCopied) {
+  if (!iCopied) {
+    void * pMapping = mmap(NULL, szSize, PROT_READ, MAP_SHARED, iFile, 0);
+    return pMapping == MAP_FAILED ? NULL : pMapping;
+  }
+  char * pcFile = (char *)allocateMemory(NULL, szSize, ATDictionaryWords);
+  size_t szRead = 0;
+  while (pcFile && szRead < szSize) {
+    ssize_t sRead = read(iFile, pcFile + szRead, szSize - szRead);
+    if (sRead < 0 && errno == EINTR) {
+      continue;
+    }
+    // a file truncated while it is read comes up short and is rejected
+    if (sRead <= 0) {
+      freeMemory(NULL, pcFile);
+      return NULL;
+    }
+    szRead += (size_t)sRead;
+  }
+  return pcFile;
+}
+
+static void releaseFile(void * pFile, size_t szSize, int8_t iCopied) {
+  if (iCopied) {
+    freeMemory(NULL, pFile);
+  } else {
+    munmap(pFile, szSize);
+  }
+}
+
+static inline uint64_t alignOffset(uint64_t uiOffset) {
+  return (uiOffset + 63) & ~(uint64_t)63;
+}
+
+static int8_t writePadding(FILE * file, uint64_t uiFrom, uint64_t uiTo) {
+  for (; uiFrom < uiTo; ++uiFrom) {
+    if (fputc(0, file) == EOF) {
+      return 0;
+    }
+  }
+  return 1;
+}
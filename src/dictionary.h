@@ -0,0 +1,120 @@
+#pragma once
+
+/*! \file dictionary.h
+  \brief Indexed word dictionary.
+*/
+
+#include "array.h"
+#include "word.h"
+#include <stdint.h>
+
+typedef struct _dictionary_ * Dictionary;         //!< Dictionary type, read-only after creation.
+
+/*! \enum DictionaryOptions
+  \brief Options of loading a binary dictionary.
+*/
+enum DictionaryOptions {
+  DODefault = 0,                                  //!< File is mapped and used in place, it must only be replaced by a rename while loaded.
+  DOCopied = 1                                    //!< File is read into memory, so it may be rewritten in place while loaded.
+};
+
+/*! \brief Creates a dictionary.
+  Creates a dictionary holding all five letter words in an array, words are stored packed.
+  Entries that are not five letter words are skipped, as are repeated words.
+  The array is not referenced after creation and may be cleared.
+  Each dictionary created by this function must be destroyed by 'destroyDictionary(Dictionary)' to avoid memory leaks.
+  \param aWords Array of NUL-terminated words.
+  \return Created dictionary or NULL when memory could not be allocated.
+*/
+Dictionary createDictionary(Array aWords);
+/*! \brief Creates a dictionary from packed words.
+  Creates a dictionary holding a copy of packed words, in the given order.
+  Entries that are not valid packed words are skipped, as are repeated words.
+  Each dictionary created by this function must be destroyed by 'destroyDictionary(Dictionary)' to avoid memory leaks.
+  \param cpwWords Packed words.
+  \param uiCount Amount of words.
+  \return Created dictionary or NULL when memory could not be allocated.
+*/
+Dictionary createPackedDictionary(const PackedWord * cpwWords, uint32_t uiCount);
+/*! \brief Loads a binary dictionary.
+  Maps a dictionary file written by 'writeDictionary' and uses it in place.
+  The header is validated and the words are checked in one pass to be valid packed words in strictly ascending order, nothing is allocated per word.
+  A presence bitmap is checked to hold exactly the bits of the words, which reads all of it once.
+  The file must only be replaced by a rename while loaded, writing it in place changes or truncates the mapping, see DOCopied.
+  Each dictionary loaded by this function must be destroyed by 'destroyDictionary(Dictionary)' to unmap it.
+  \param path Relative or absolute path to dictionary file.
+  \return Loaded dictionary or NULL when file could not be mapped or is not a valid dictionary file.
+*/
+Dictionary loadDictionary(const char * path);
+/*! \brief Loads a binary dictionary with options.
+  Loads a dictionary file written by 'writeDictionary' like 'loadDictionary', mapped or read into memory.
+  A copied dictionary does not reference its file after loading, it costs a read of the file and memory of its size.
+  Each dictionary loaded by this function must be destroyed by 'destroyDictionary(Dictionary)' to avoid memory leaks.
+  \param path Relative or absolute path to dictionary file.
+  \param uiOptions Combination of 'DictionaryOptions'.
+  \return Loaded dictionary or NULL when file could not be read or is not a valid dictionary file.
+*/
+Dictionary loadDictionaryWithOptions(const char * path, uint32_t uiOptions);
+/*! \brief Is binary dictionary.
+  Returns a value indicating a file starts with the magic of a binary dictionary file.
+  \param path Relative or absolute path to file.
+  \return 1 when file is a binary dictionary, 0 otherwise or when file could not be read.
+*/
+int8_t isDictionaryFile(const char * path);
+/*! \brief Writes a binary dictionary.
+  Writes all words of a dictionary, sorted, to a file that 'loadDictionary' can map.
+  The file is written next to the output as '<path>.tmp' and renamed over it, so dictionaries mapped from the old file stay intact.
+  \param dWords Dictionary to write.
+  \param path Relative or absolute path to output file.
+  \param iWithIndex 1 to include the presence bitmap (4 MB) for constant time lookups, 0 to rely on binary search.
+  \return 1 on success, else 0.
+*/
+int8_t writeDictionary(Dictionary dWords, const char * path, int8_t iWithIndex);
+/*! \brief Destroys a dictionary.
+  Destroys a dictionary and all its words, or unmaps or frees its file when it was loaded from file.
+  \param dWords Dictionary to destroy.
+*/
+void destroyDictionary(Dictionary dWords);
+
+/*! \brief Get amount of words.
+  Returns the amount of words in the dictionary.
+  \param dWords Dictionary to get size of.
+  \return Amount of words.
+*/
+uint32_t getWordCount(Dictionary dWords);
+/*! \brief Get word at index.
+  Returns the word at given index in constant time.
+  Indices follow the order of the array the dictionary was created from, or alphabetical order when it was loaded from a file.
+  \param dWords Dictionary to get word from.
+  \param uiIndex Index of word.
+  \return Packed word or INVALID_WORD when index is out of bounds.
+*/
+PackedWord getWord(Dictionary dWords, uint32_t uiIndex);
+/*! \brief Get all words.
+  Returns the words of the dictionary as one contiguous array, in index order.
+  \param dWords Dictionary to get words of.
+  \return Array of 'getWordCount(Dictionary)' packed words, or NULL when no dictionary was given.
+*/
+const PackedWord * getWords(Dictionary dWords);
+/*! \brief Get content hash.
+  Computes a 64 bit FNV-1a hash over all words in index order, used to tie caches to the exact dictionary they were built from.
+  \param dWords Dictionary to hash.
+  \return Hash of dictionary.
+*/
+uint64_t getDictionaryHash(Dictionary dWords);
+/*! \brief Is word in dictionary.
+  Returns a value indicating word is in the dictionary, in constant time.
+  Dictionaries loaded from a file without index use a binary search.
+  \param dWords Dictionary to search.
+  \param ccaWord NUL-terminated word to search for.
+  \return 1 when found, else 0.
+*/
+int8_t containsWord(Dictionary dWords, const char * ccaWord);
+/*! \brief Is packed word in dictionary.
+  Returns a value indicating packed word is in the dictionary, in constant time.
+  Dictionaries loaded from a file without index use a binary search.
+  \param dWords Dictionary to search.
+  \param pwWord Packed word to search for.
+  \return 1 when found, else 0.
+*/
+int8_t containsPackedWord(Dictionary dWords, PackedWord pwWord);
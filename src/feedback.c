@@ -0,0 +1,155 @@
+#include "feedback.h"
+
+#include <string.h>
+
+#define LETTER_MASK ((1u << WORD_LETTER_BITS) - 1)
+#define VECTOR_LANES 8
+
+typedef int32_t VectorLanes __attribute__((vector_size(VECTOR_LANES * sizeof(int32_t)))); //!< Eight 32 bit lanes, lowered to SSE2 or AVX2 by the compiler.
+
+// ----------------- Struct definitions -----------------------------------
+
+/*! \struct GuessLetters
+  \brief Guess prepared for scoring.
+  Everything that only depends on the guess is computed once, so scoring an answer only compares letters.
+*/
+struct GuessLetters {
+  int32_t aiLetters[WORD_LENGTH];                 //!< Letters of guess.
+  uint8_t auiEarlier[WORD_LENGTH];                //!< Per position, bit l set when earlier position l holds the same letter.
+};
+
+
+// ----------------- Local Function declarations --------------------------
+
+/*! \brief Prepare guess.
+  Splits a guess into letters and finds repeated letters.
+  \param pwGuess Packed guess.
+  \param pglGuess Receives prepared guess.
+*/
+static inline void prepareGuess(PackedWord pwGuess, struct GuessLetters * pglGuess);
+/*! \brief Score pair.
+  Branchless core of the kernel for one answer.
+  A letter is correct when it matches the answer at its position.
+  Any other letter is present when fewer earlier non-correct guess positions hold it than non-correct answer positions do.
+  \param cpglGuess Prepared guess.
+  \param pwAnswer Packed answer.
+  \return Pattern code.
+*/
+static inline Pattern scorePair(const struct GuessLetters * cpglGuess, PackedWord pwAnswer);
+/*! \brief Score pairs.
+  Same as 'scorePair' for eight answers at once, comparisons yield all ones per lane and are masked to 0 or 1.
+  Only branches on the guess, which is the same for all answers of a batch.
+  Always inlined, so it is compiled for the instruction set of each clone of 'computePatterns'.
+  \param cpglGuess Prepared guess.
+  \param cpwAnswers Eight packed answers.
+  \param pPatterns Receives eight pattern codes.
+*/
+static inline void scorePairs(const struct GuessLetters * cpglGuess, const PackedWord * cpwAnswers, Pattern * pPatterns) __attribute__((always_inline));
+
+
+// ----------------- Global Function definitions --------------------------
+Pattern computePattern(PackedWord pwGuess, PackedWord pwAnswer) {
+  struct GuessLetters glGuess;
+  prepareGuess(pwGuess, &glGuess);
+  return scorePair(&glGuess, pwAnswer);
+}
+
+__attribute__((target_clones("avx2", "default")))
+void computePatterns(PackedWord pwGuess, const PackedWord * cpwAnswers, uint32_t uiCount, Pattern * pPatterns) {
+  struct GuessLetters glGuess;
+  uint32_t i;
+  prepareGuess(pwGuess, &glGuess);
+  for (i = 0; i + VECTOR_LANES <= uiCount; i += VECTOR_LANES) {
+    scorePairs(&glGuess, cpwAnswers + i, pPatterns + i);
+  }
+  for (; i < uiCount; ++i) {
+    pPatterns[i] = scorePair(&glGuess, cpwAnswers[i]);
+  }
+}
+
+uint8_t getPatternDigit(Pattern pPattern, uint8_t uiPosition) {
+  static const uint8_t cauiWeights[WORD_LENGTH] = { 1, 3, 9, 27, 81 };
+  if (uiPosition >= WORD_LENGTH) {
+    return INVALID_DIGIT;
+  }
+  return (uint8_t)(pPattern / cauiWeights[uiPosition] % 3);
+}
+
+Pattern encodePattern(const uint8_t * cauiDigits) {
+  uint8_t uiPattern = 0;
+  int8_t i;
+  for (i = WORD_LENGTH - 1; i >= 0; --i) {
+    uiPattern = (uint8_t)(uiPattern * 3 + cauiDigits[i] % 3);
+  }
+  return uiPattern;
+}
+
+
+// ----------------- Local Function definitions ---------------------------
+static inline void prepareGuess(PackedWord pwGuess, struct GuessLetters * pglGuess) {
+  uint32_t i;
+  uint32_t j;
+  for (i = 0; i < WORD_LENGTH; ++i) {
+    pglGuess->aiLetters[i] = (int32_t)((pwGuess >> ((WORD_LENGTH - 1 - i) * WORD_LETTER_BITS)) & LETTER_MASK);
+    pglGuess->auiEarlier[i] = 0;
+    for (j = 0; j < i; ++j) {
+      pglGuess->auiEarlier[i] |= (uint8_t)((pglGuess->aiLetters[j] == pglGuess->aiLetters[i]) << j);
+    }
+  }
+}
+
+static inline Pattern scorePair(const struct GuessLetters * cpglGuess, PackedWord pwAnswer) {
+  int32_t aiAnswer[WORD_LENGTH];
+  int32_t aiOpen[WORD_LENGTH];
+  int32_t iPattern = 0;
+  uint32_t i;
+  uint32_t j;
+  for (i = 0; i < WORD_LENGTH; ++i) {
+    aiAnswer[i] = (int32_t)((pwAnswer >> ((WORD_LENGTH - 1 - i) * WORD_LETTER_BITS)) & LETTER_MASK);
+    aiOpen[i] = aiAnswer[i] != cpglGuess->aiLetters[i];
+  }
+#pragma GCC unroll 5
+  for (i = WORD_LENGTH; i-- > 0;) {
+    int32_t iAvailable = 0;
+    int32_t iClaimed = 0;
+#pragma GCC unroll 5
+    for (j = 0; j < WORD_LENGTH; ++j) {
+      iAvailable += (aiAnswer[j] == cpglGuess->aiLetters[i]) & aiOpen[j];
+      iClaimed += aiOpen[j] & (cpglGuess->auiEarlier[i] >> j);
+    }
+    iPattern = iPattern * 3 + 2 - 2 * aiOpen[i] + (aiOpen[i] & (iClaimed < iAvailable));
+  }
+  return (Pattern)iPattern;
+}
+
+static inline void scorePairs(const struct GuessLetters * cpglGuess, const PackedWord * cpwAnswers, Pattern * pPatterns) {
+  VectorLanes vAnswers;
+  VectorLanes avAnswer[WORD_LENGTH];
+  VectorLanes avOpen[WORD_LENGTH];
+  VectorLanes vPatterns = (VectorLanes){ 0 };
+  uint32_t i;
+  uint32_t j;
+  memcpy(&vAnswers, cpwAnswers, sizeof(vAnswers));
+#pragma GCC unroll 5
+  for (i = 0; i < WORD_LENGTH; ++i) {
+    avAnswer[i] = (vAnswers >> ((WORD_LENGTH - 1 - i) * WORD_LETTER_BITS)) & (int32_t)LETTER_MASK;
+    avOpen[i] = (avAnswer[i] != cpglGuess->aiLetters[i]) & 1;
+  }
+#pragma GCC unroll 5
+  for (i = WORD_LENGTH; i-- > 0;) {
+    VectorLanes vAvailable = (VectorLanes){ 0 };
+    VectorLanes vClaimed = (VectorLanes){ 0 };
+#pragma GCC unroll 5
+    for (j = 0; j < WORD_LENGTH; ++j) {
+      vAvailable += (avAnswer[j] == cpglGuess->aiLetters[i]) & avOpen[j];
+      // repeated guess letters are rare, skip the claim count for the common case
+      if ((cpglGuess->auiEarlier[i] >> j) & 1) {
+	vClaimed += avOpen[j];
+      }
+    }
+    vPatterns = vPatterns * 3 + 2 - 2 * avOpen[i] + (avOpen[i] & (vClaimed < vAvailable));
+  }
+  for (i = 0; i < VECTOR_LANES; ++i) {
+    pPatterns[i] = (Pattern)vPatterns[i];
+  }
+}
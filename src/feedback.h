@@ -0,0 +1,47 @@
+#pragma once
+
+/*! \file feedback.h
+  \brief Feedback kernel.
+  Feedback of a guess is encoded as a pattern code, a base-3 number with one digit per position.
+  Digit at position i has weight 3^i and is 0 (letter absent), 1 (letter present elsewhere) or 2 (letter correct).
+  Repeated letters are only reported present as often as they occur in the answer outside correct positions, leftmost first.
+*/
+
+#include "word.h"
+#include <stdint.h>
+
+#define PATTERN_COUNT 243                         //!< Amount of distinct patterns (3^5).
+#define PATTERN_SOLVED 242                        //!< Pattern of a correct guess, all digits 2.
+#define INVALID_DIGIT 3                           //!< Value that never represents the feedback of a position.
+
+typedef uint8_t Pattern;                          //!< Pattern code, 0 to PATTERN_COUNT - 1.
+
+/*! \brief Compute pattern.
+  Computes the feedback of a guess against an answer without branches.
+  \param pwGuess Packed guess.
+  \param pwAnswer Packed answer.
+  \return Pattern code.
+*/
+Pattern computePattern(PackedWord pwGuess, PackedWord pwAnswer);
+/*! \brief Compute patterns of one guess.
+  Computes the feedback of a guess against each of an array of answers.
+  The loop is written to be vectorized, an AVX2 clone is selected at run-time when supported.
+  \param pwGuess Packed guess.
+  \param cpwAnswers Packed answers.
+  \param uiCount Amount of answers.
+  \param pPatterns Receives one pattern code per answer.
+*/
+void computePatterns(PackedWord pwGuess, const PackedWord * cpwAnswers, uint32_t uiCount, Pattern * pPatterns);
+/*! \brief Get pattern digit.
+  Returns the feedback of one position in a pattern.
+  \param pPattern Pattern code.
+  \param uiPosition Position, 0 is the first letter.
+  \return 0 when absent, 1 when present elsewhere, 2 when correct, INVALID_DIGIT when the position is not below WORD_LENGTH.
+*/
+uint8_t getPatternDigit(Pattern pPattern, uint8_t uiPosition);
+/*! \brief Encode pattern.
+  Builds a pattern code from the feedback of each position, the inverse of 'getPatternDigit'.
+  \param cauiDigits WORD_LENGTH digits, each 0 (absent), 1 (present elsewhere) or 2 (correct).
+  \return Pattern code.
+*/
+Pattern encodePattern(const uint8_t * cauiDigits);
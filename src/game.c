@@ -1,99 +1,105 @@
 #include "game.h"
 
+#include "match.h"
 #include <ctype.h>
 #include <stdio.h>
-#include <stdlib.h>
 #include <string.h>
 
-#define COUNTER_START 5
-
-typedef const char * CWord;                       //!< Constant word.
 typedef char * Word;                              //!< Dynamic word.
 
-// ----------------- Struct definitions -----------------------------------
-
-/*! \struct GameContext
-  \brief Context of a match.
-*/
-struct GameContext {
-  uint8_t uiRemainingRounds;                      //!< Remaining amount of tries.
-  CWord cwWord;                                   //!< Word to guess.
-  Word wTip;                                      //!< Tip showing correct characters.
-};
-
 // ----------------- Local Function declarations --------------------------
 
 /*! \brief Fetch input from user.
   Fetches input from user and checks for input errors.
-  \param wBuffer Buffer to write input to.
-  \param pgcContext Context of match.
-  \return 1 on success, else 0.
+  \param wBuffer Buffer to write input to, must hold WORD_LENGTH + 1 characters.
+  \param cpmMatch Match input is for.
+  \return 1 on success, 0 on invalid input, -1 when input ended.
 */
-static inline int8_t fetchInput(Word wBuffer, struct GameContext * pgcContext);
-/*! \brief Returns remaining rounds.
-  Returns a value indicating match is still running or finished.
-  \param pgcContext Context of game.
-  \return 0 when match finished, else remaining tries.
+static inline int8_t fetchInput(Word wBuffer, const struct Match * cpmMatch);
+/*! \brief Print feedback.
+  Prints feedback of a guess below the guess.
+  \param cpgfFeedback Feedback to print.
 */
-static inline int8_t isMatchOn(struct GameContext * pgcContext);
-/*! \brief Guess word.
-  Performs a word compare and updates game context.
-  \param wBuffer Guessed word.
-  \param pgcContext Context of game.
-  \return 1 on success, else 0.
+static inline void printFeedback(const struct GuessFeedback * cpgfFeedback);
+/*! \brief Print hint.
+  Prints the guess suggested by a solver.
+  \param sHints Solver to ask.
+  \param csCandidates Candidates of match.
+  \param iHardMode Only suggest candidates.
+  \param dWords Dictionary of solver.
 */
-static inline int8_t guess(Word wBuffer, struct GameContext * pgcContext);
-/*! \brief Is word valid.
-  Returns a value indicating word is accepted as input word.
-  \param wBuffer Word to validate.
-  \param lWords List of acceptable words.
-  \return 1 on success, else 0.
+static void printHint(Solver sHints, CandidateSet csCandidates, int8_t iHardMode, Dictionary dWords);
+/*! \brief Print violation.
+  Prints which revealed information a guess ignored.
+  \param cpcvViolation Violation to print.
 */
-static inline int8_t isAllowed(Word wBuffer, List lWords);
+static void printViolation(const struct ConstraintViolation * cpcvViolation);
 
 
 // ----------------- Global Function definitions --------------------------
-enum MatchResults startMatch(uint32_t uiIndex, List lWords) {
-  Iterator iter = getEntry(lWords, uiIndex);
-  struct GameContext gcContext = { COUNTER_START, (CWord)getCurrent(iter), (Word)malloc(sizeof(char) * 6) };
-  memset(gcContext.wTip, (int)'_', sizeof(char) * 5);
-  *gcContext.wTip = *gcContext.cwWord;
-  gcContext.wTip[5] = '\0';
-  Word wBuffer = (Word)malloc(sizeof(char) * 6);
-
-  while (isMatchOn(&gcContext)) {
-    printf("%s\n", gcContext.wTip);
-    while (!fetchInput(wBuffer, &gcContext)) {
-      if (strlen(wBuffer) != 5) {
+enum MatchResults startMatch(uint32_t uiIndex, Dictionary dWords, uint32_t uiOptions, CandidateSet csCandidates, Solver sHints) {
+  struct Match mMatch;
+  struct GuessFeedback gfFeedback;
+  char caBuffer[WORD_LENGTH + 1];
+  if (!initMatchWithOptions(&mMatch, dWords, uiIndex, uiOptions)) {
+    return MRRunError;
+  }
+  trackCandidates(&mMatch, csCandidates);
+
+  while (getMatchState(&mMatch) == MSRunning) {
+    printf("%s\n", getTip(&mMatch));
+    if (sHints && csCandidates) {
+      printHint(sHints, csCandidates, uiOptions & MOHardMode, dWords);
+    }
+    int8_t iInput;
+    while (!(iInput = fetchInput(caBuffer, &mMatch))) {
+      if (strlen(caBuffer) != WORD_LENGTH) {
 	printf("Input less then 5 characters\n");
       } else {
 	printf("Input contains illegal character(s), use a-z or A-Z\n");
       }
     }
-    if (isAllowed(wBuffer, lWords)) {
-      if (!strcmp(gcContext.cwWord, wBuffer)) {
-	return MRWin;
-      }
-      if (!guess(wBuffer, &gcContext)) {
-	printf("Failed to match strings\n");
-	return MRRunError;
-      }
-    } else {
-      printf("'%s' not a word\n", wBuffer);
+    if (iInput < 0) {
+      return MRRunError;
+    }
+    switch (submitGuess(&mMatch, caBuffer, &gfFeedback)) {
+    case GRWon:
+      return MRWin;
+
+    case GRAccepted:
+    case GRLost:
+      printFeedback(&gfFeedback);
+      break;
+
+    case GRUnknownWord:
+      printf("'%s' not a word\n", caBuffer);
+      break;
+
+    case GRConstraintViolated:
+      printViolation(getViolation(&mMatch));
+      break;
+
+    default:
+      printf("Failed to match strings\n");
+      return MRRunError;
     }
   }
 
-  printf("Word was: %s\n", gcContext.cwWord);
+  char caWord[WORD_LENGTH + 1];
+  decodeWord(getMatchWord(&mMatch), caWord);
+  printf("Word was: %s\n", caWord);
   return MRLose;
 }
 
 
 // ----------------- Local Function definitions ---------------------------
-static inline int8_t fetchInput(Word wBuffer, struct GameContext * pgcContext) {
+static inline int8_t fetchInput(Word wBuffer, const struct Match * cpmMatch) {
   int8_t i;
-  printf("%d>", pgcContext->uiRemainingRounds);
-  scanf("%5s", wBuffer);
-  for (i = 0; i < 5; ++i) {
+  printf("%d>", getRemainingRounds(cpmMatch));
+  if (scanf("%5s", wBuffer) != 1) {
+    return -1;
+  }
+  for (i = 0; i < WORD_LENGTH; ++i) {
     if (wBuffer[i] >= 'a' && wBuffer[i] <= 'z') {
       // this char is ok, leave it
     } else if (wBuffer[i] >= 'A' && wBuffer[i] <= 'Z') {
@@ -105,37 +111,48 @@ static inline int8_t fetchInput(Word wBuffer, struct GameContext * pgcContext) {
   return 1;
 }
 
-static inline int8_t isMatchOn(struct GameContext * pgcContext) {
-  return pgcContext->uiRemainingRounds;
-}
-
-static inline int8_t guess(Word wBuffer, struct GameContext * pgcContext) {
+static inline void printFeedback(const struct GuessFeedback * cpgfFeedback) {
+  static const char caSymbols[] = { ' ', '+', '^' };
   int8_t i;
   printf("  ");
-  for (i = 0; i < 5; ++i) {
-    if (wBuffer[i] == pgcContext->cwWord[i]) {
-      printf("^");
-      pgcContext->wTip[i] = pgcContext->cwWord[i];
-    } else {
-      CWord cwContains = strchr(pgcContext->cwWord, wBuffer[i]);
-      if (cwContains) {
-	printf("+");
-      } else {
-	printf(" ");
-      }
-    }
+  for (i = 0; i < WORD_LENGTH; ++i) {
+    printf("%c", caSymbols[cpgfFeedback->auiLetters[i]]);
   }
   printf("\n");
-  --pgcContext->uiRemainingRounds;
-  return 1;
 }
 
-static inline int8_t isAllowed(Word wBuffer, List lWords) {
-  Iterator iter;
-  for (iter = getBegin(lWords); iter; moveNext(&iter)) {
-    if (!strcmp((CWord)getCurrent(iter), wBuffer)) {
-      return 1;
-    }
+static void printHint(Solver sHints, CandidateSet csCandidates, int8_t iHardMode, Dictionary dWords) {
+  struct Suggestion sSuggestion;
+  char caWord[WORD_LENGTH + 1];
+  if (!suggestGuess(sHints, csCandidates, iHardMode, &sSuggestion)) {
+    printf("Hint: none\n");
+    return;
+  }
+  decodeWord(getWord(dWords, sSuggestion.uiWord), caWord);
+  printf("Hint: %s (%.2f bits, %u candidates)\n", caWord, sSuggestion.dEntropy, sSuggestion.uiCandidates);
+}
+
+static void printViolation(const struct ConstraintViolation * cpcvViolation) {
+  char cLetter = (char)('a' + cpcvViolation->uiLetter);
+  switch (cpcvViolation->cvType) {
+  case CVFixedLetter:
+    printf("Hard mode: letter %d must be '%c'\n", cpcvViolation->uiPosition + 1, cLetter);
+    break;
+
+  case CVExcludedLetter:
+    printf("Hard mode: letter %d can not be '%c'\n", cpcvViolation->uiPosition + 1, cLetter);
+    break;
+
+  case CVMissingLetter:
+    printf("Hard mode: guess must contain '%c' at least %d time(s)\n", cLetter, cpcvViolation->uiCount);
+    break;
+
+  case CVExcessLetter:
+    printf("Hard mode: guess may contain '%c' at most %d time(s)\n", cLetter, cpcvViolation->uiCount);
+    break;
+
+  default:
+    printf("Hard mode: guess ignores revealed letters\n");
+    break;
   }
-  return 0;
 }
@@ -4,7 +4,9 @@
   \brief Game manager.
 */
 
-#include "list.h"
+#include "candidates.h"
+#include "dictionary.h"
+#include "solver.h"
 #include <stdint.h>
 
 /*! \enum MatchResults
@@ -18,8 +20,11 @@ enum MatchResults {
 
 /*! \brief Starts a match.
   Starts a match and blocks until match has a result.
-  \param uiIndex Index of word to guess in 'lWords'.
-  \param lWords List of words containing all allowed input words.
+  \param uiIndex Index of word to guess in 'dWords'.
+  \param dWords Dictionary containing all allowed input words.
+  \param uiOptions Combination of 'MatchOptions', see match.h.
+  \param csCandidates Set tracking the words consistent with the match so far, or NULL to not track them.
+  \param sHints Solver suggesting a guess from the tracked candidates before every round, or NULL to play without hints.
   \return Result of the match.
 */
-enum MatchResults startMatch(uint32_t uiIndex, List lWords);
+enum MatchResults startMatch(uint32_t uiIndex, Dictionary dWords, uint32_t uiOptions, CandidateSet csCandidates, Solver sHints);
@@ -3,6 +3,9 @@
 #include <stddef.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+
+#define NODES_PER_SLAB 256
 
 // ----------------- Struct definitions -----------------------------------
 
@@ -10,12 +13,24 @@
   \brief Implementation of 'List' type.
   Lists hold only hold iterators to their first and last entry.
   A list maintains a counter to determine the amount of entries it holds.
+  Pooled lists take iterators from slabs, removed iterators are kept in a free list for reuse.
+  Unrolled lists use a chain of '_unrolled_' nodes instead and leave the iterator fields unused.
   Outside of translation unit list may only be refered to by pointers.
 */
 struct _list_ {
   Iterator first;                                 //!< Iterator to first entry.
   Iterator last;                                  //!< Iterator to last entry.
   uint32_t uiSize;                                //!< Entry counter.
+  uint32_t uiOptions;                             //!< Combination of 'ListOptions'.
+  struct _slab_ * slabs;                          //!< Slabs of pooled list, or NULL.
+  uint32_t uiSlabUsed;                            //!< Amount of iterators taken from head slab.
+  Iterator freeNodes;                             //!< Removed iterators of pooled list, linked by their 'next' field.
+  const struct Allocator * cpaAllocator;          //!< Allocator of list, iterators and slabs, NULL for the default.
+  struct _unrolled_ * head;                       //!< First node of unrolled list, or NULL.
+  struct _unrolled_ * tail;                       //!< Last node of unrolled list, or NULL.
+  uint32_t uiItemSize;                            //!< Size of payloads of unrolled list.
+  uint32_t uiSlotSize;                            //!< Distance between payloads of unrolled list, keeps them aligned and even.
+  uint32_t uiSlots;                               //!< Amount of payloads a node of unrolled list holds.
 };
 
 /*! \struct _iterator_
@@ -31,6 +46,28 @@ struct _iterator_ {
   List container;                                 //!< Pointer to container, or NULL when pointer is in an invalid state.
 };
 
+/*! \struct _slab_
+  \brief Block of iterators for pooled lists.
+  Slabs of a list form a singly linked list, the most recent slab is the head and is filled front to back.
+*/
+struct _slab_ {
+  struct _slab_ * next;                           //!< Previously allocated slab, or NULL.
+  struct _iterator_ aNodes[NODES_PER_SLAB];       //!< Iterators carved from this slab.
+};
+
+/*! \struct _unrolled_
+  \brief Node of an unrolled list.
+  Nodes are aligned to their size, so the node of an entry is found by masking the address of its payload.
+  Iterators to entries of unrolled lists are payload addresses with the lowest bit set, which no pointer to an '_iterator_' has.
+*/
+struct _unrolled_ {
+  struct _unrolled_ * next;                       //!< Next node, or NULL.
+  struct _unrolled_ * prev;                       //!< Previous node, or NULL.
+  List container;                                 //!< List node belongs to.
+  uint32_t uiCount;                               //!< Amount of entries in node, at least 1.
+  uint32_t uiSlotSize;                            //!< Copy of 'uiSlotSize' of list, saves a load per step.
+  uint64_t auiData[];                             //!< Payloads of entries, 'uiSlotSize' bytes each.
+};
 
 // ----------------- Local Variables --------------------------------------
 static struct _iterator_ _NULL_iterator_ = { NULL, NULL, NULL, NULL }; //!< NULL iterator, allows functions to return a valid pointer to an invalid iterator without creating potential memory leaks.
@@ -43,19 +80,140 @@ static struct _iterator_ _NULL_iterator_ = { NULL, NULL, NULL, NULL }; //!< NULL
   \return Invalid iterator.
 */
 static inline Iterator getNullIterator();
+/*! \brief Allocate iterator.
+  Allocates an iterator for a list, from its pool when the list is pooled.
+  \param list List to allocate iterator for.
+  \return Uninitialized iterator or NULL when memory could not be allocated.
+*/
+static inline Iterator allocNode(List list);
+/*! \brief Free iterator.
+  Frees an iterator of a list, pooled iterators are put on the free list of the list.
+  \param list List iterator belongs to.
+  \param iterator Iterator to free.
+*/
+static inline void freeNode(List list, Iterator iterator);
+/*! \brief Is unrolled iterator.
+  Returns a value indicating an iterator is the tagged payload address of an entry of an unrolled list.
+  \param iterator Iterator to check.
+  \return 1 when iterator points into an unrolled list, else 0.
+*/
+static inline int8_t isUnrolled(Iterator iterator);
+/*! \brief Get unrolled iterator.
+  Returns the iterator of an entry of an unrolled list.
+  \param node Node of entry.
+  \param uiIndex Index of entry in node.
+  \return Tagged payload address.
+*/
+static inline Iterator getSlotIterator(struct _unrolled_ * node, uint32_t uiIndex);
+/*! \brief Get payload of unrolled iterator.
+  \param iterator Unrolled iterator.
+  \return Payload address.
+*/
+static inline unsigned char * getSlot(Iterator iterator);
+/*! \brief Get node of unrolled iterator.
+  \param iterator Unrolled iterator.
+  \return Node holding entry.
+*/
+static inline struct _unrolled_ * getSlotNode(Iterator iterator);
+/*! \brief Get index of unrolled iterator.
+  \param iterator Unrolled iterator.
+  \param node Node holding entry.
+  \return Index of entry in node.
+*/
+static inline uint32_t getSlotIndex(Iterator iterator, struct _unrolled_ * node);
+/*! \brief Allocate unrolled node.
+  Allocates an empty node and links it into a list after another node.
+  \param list Unrolled list.
+  \param prev Node preceding new node, or NULL to make it the first node.
+  \return Linked node or NULL when memory could not be allocated.
+*/
+static struct _unrolled_ * allocUnrolled(List list, struct _unrolled_ * prev);
+/*! \brief Add entry to unrolled list.
+  Copies a payload into the node of the entry preceding it, splitting the node when it is full.
+  A full node at either end of the list is not split, a new node is started instead, so appending and prepending keep nodes full.
+  \param list Unrolled list.
+  \param iterator Entry preceding entry to add, or NULL to add it in front.
+  \param cpItem Payload to copy.
+  \return 1 on success, else 0.
+*/
+static int8_t addUnrolled(List list, Iterator iterator, const void * cpItem);
+/*! \brief Remove entry from unrolled list.
+  Moves the entries following an entry in its node down, a node left empty is freed.
+  \param list Unrolled list.
+  \param iterator Entry to remove.
+  \return 1 on success, else 0.
+*/
+static int8_t removeUnrolled(List list, Iterator iterator);
+/*! \brief Append entries to unrolled list.
+  Allocates all nodes missing for the payloads first, so a failure leaves the list untouched, then copies payloads into them.
+  \param list Unrolled list.
+  \param ppItems Payloads to copy.
+  \param uiCount Amount of payloads.
+  \return 1 on success, else 0.
+*/
+static int8_t appendUnrolled(List list, void * const * ppItems, uint32_t uiCount);
+/*! \brief Sort unrolled list.
+  Gathers payloads in a buffer, merge sorts them there and copies them back in order.
+  \param list Unrolled list.
+  \param fnCompare Comparator of payloads.
+  \return 1 on success, 0 when memory could not be allocated.
+*/
+static int8_t sortUnrolled(List list, entryComparator fnCompare);
 
 
 // ----------------- Global Function definitions --------------------------
 List createList() {
-  List list = (List)malloc(sizeof(struct _list_));
+  return createListWithOptions(LODefault);
+}
+
+List createListWithOptions(uint32_t uiOptions) {
+  return createListWithAllocator(uiOptions, NULL);
+}
+
+List createListWithAllocator(uint32_t uiOptions, const struct Allocator * cpaAllocator) {
+  List list = (List)allocateMemory(cpaAllocator, sizeof(struct _list_), ATListNodes);
   // do not try to initialize a list when memory was not allocated
   if (!list) {
     return NULL;
   }
-  // set list to empty state
+  // set list to empty state, slabs are allocated on first add
   list->first = NULL;
   list->last = NULL;
   list->uiSize = 0;
+  list->uiOptions = uiOptions & ~LOUnrolled;
+  list->slabs = NULL;
+  list->uiSlabUsed = NODES_PER_SLAB;
+  list->freeNodes = NULL;
+  list->cpaAllocator = cpaAllocator;
+  list->head = NULL;
+  list->tail = NULL;
+  list->uiItemSize = 0;
+  list->uiSlotSize = 0;
+  list->uiSlots = 0;
+  return list;
+}
+
+List createUnrolledList(uint32_t uiItemSize) {
+  if (!uiItemSize || uiItemSize > UNROLLED_ITEM_MAX) {
+    return NULL;
+  }
+  List list = createListWithOptions(LODefault);
+  if (!list) {
+    return NULL;
+  }
+  // round slots up to a power of two below 8 and to a multiple of 8 above, so payloads keep their natural alignment,
+  // slots of at least 2 bytes keep payload addresses even, as the lowest bit tags iterators of unrolled lists
+  uint32_t uiSlotSize = 2;
+  while (uiSlotSize < uiItemSize && uiSlotSize < 8) {
+    uiSlotSize *= 2;
+  }
+  if (uiItemSize > 8) {
+    uiSlotSize = (uiItemSize + 7) & ~7u;
+  }
+  list->uiOptions = LOUnrolled;
+  list->uiItemSize = uiItemSize;
+  list->uiSlotSize = uiSlotSize;
+  list->uiSlots = (UNROLLED_NODE_SIZE - offsetof(struct _unrolled_, auiData)) / uiSlotSize;
   return list;
 }
 
@@ -64,19 +222,41 @@ void clearList(List list) {
   if (!list) {
     return;
   }
+  while (list->head) {
+    struct _unrolled_ * node = list->head;
+    list->head = node->next;
+    freeAlignedMemory(list->cpaAllocator, node);
+  }
+  list->tail = NULL;
   Iterator current = list->first;
   Iterator next = NULL;
+  // nothing is owned per entry when both nodes and data live in bulk storage
+  if ((list->uiOptions & LOPooledNodes) && (list->uiOptions & LOBorrowedItems)) {
+    current = NULL;
+  }
   // while list has another element, save pointer to next (may be invalid, but checked on next iteration) and free allocated memory (item and iterator)
+  // iterators of a pooled list are not freed one by one, their slabs are released below
   while (current) {
     next = current->next;
-    free(current->pItem);
-    free(current);
+    if (!(list->uiOptions & LOBorrowedItems)) {
+      free(current->pItem);
+    }
+    if (!(list->uiOptions & LOPooledNodes)) {
+      freeMemory(list->cpaAllocator, current);
+    }
     current = next;
   }
+  while (list->slabs) {
+    struct _slab_ * slab = list->slabs;
+    list->slabs = slab->next;
+    freeMemory(list->cpaAllocator, slab);
+  }
   // reset list to empty state
   list->first = NULL;
   list->last = NULL;
   list->uiSize = 0;
+  list->uiSlabUsed = NODES_PER_SLAB;
+  list->freeNodes = NULL;
 }
 
 void destroyList(List list) {
@@ -86,7 +266,7 @@ void destroyList(List list) {
   }
   // clear frees all elements (item and iterator), only then list can be safely deallocated
   clearList(list);
-  free(list);
+  freeMemory(list->cpaAllocator, list);
 }
 
 Iterator getBegin(List list) {
@@ -94,6 +274,9 @@ Iterator getBegin(List list) {
   if (!list) {
     return getNullIterator();
   }
+  if (list->uiOptions & LOUnrolled) {
+    return list->head ? getSlotIterator(list->head, 0) : NULL;
+  }
   return list->first;
 }
 Iterator getEnd(List list) {
@@ -101,6 +284,9 @@ Iterator getEnd(List list) {
   if (!list) {
     return getNullIterator();
   }
+  if (list->uiOptions & LOUnrolled) {
+    return list->tail ? getSlotIterator(list->tail, list->tail->uiCount - 1) : NULL;
+  }
   return list->last;
 }
 
@@ -117,6 +303,15 @@ Iterator getEntry(List list, uint32_t uiIndex) {
   if (!list) {
     return getNullIterator();
   }
+  // unrolled lists skip whole nodes by their entry count
+  if (list->uiOptions & LOUnrolled) {
+    struct _unrolled_ * node = list->head;
+    while (node && uiIndex >= node->uiCount) {
+      uiIndex -= node->uiCount;
+      node = node->next;
+    }
+    return node ? getSlotIterator(node, uiIndex) : getNullIterator();
+  }
   uint32_t i;
   Iterator iter;
   // when requested index is above half, iterate backwards to element at index, otherwise use foreward iteration
@@ -138,13 +333,16 @@ int8_t addEntry(List list, Iterator iterator, void * pItem) {
   if (!list || !pItem) {
     return 0;
   }
+  if (list->uiOptions & LOUnrolled) {
+    return addUnrolled(list, iterator, pItem);
+  }
   // set iterator to 'invalid' iterator when non was given, this results in putting the item in front of all others
   if (!iterator) {
     iterator = getNullIterator();
-  } else if (list != iterator->container) {
+  } else if (isUnrolled(iterator) || list != iterator->container) {
     return 0;
   }
-  Iterator newEntry = (Iterator)malloc(sizeof(struct _iterator_));
+  Iterator newEntry = allocNode(list);
   // do not try to initialize and add entry when memory is not allocated
   if (!newEntry) {
     return 0;
@@ -154,26 +352,22 @@ int8_t addEntry(List list, Iterator iterator, void * pItem) {
   newEntry->container = list;
   newEntry->pItem = pItem;
   ++list->uiSize;
-  // if iterator is last push element to end of list, do not link new iterator to current as current might be special 'invalid' iterator
-  // otherwise push it before iterator following current, do not link new iterator to current as current might be special 'invalid' iterator
-  if (!iterator->next) {
-    list->last = newEntry;
-  } else {
-    newEntry->next = iterator->next;
-    newEntry->next->prev = newEntry;
-  }
   // if iterator is special 'invalid' one, push to begining, do link new iterator to first iterator (if any)
-  // otherwise push it directly behind current iterator
+  // otherwise push it directly behind current iterator, before the iterator following current (if any)
+  // either way the new iterator is last when nothing follows it, which is not the case for 'invalid' iterator of a filled list
   if (!iterator->pItem) {
     newEntry->next = list->first;
-    if (newEntry->next) {
-      newEntry->next->prev = newEntry;
-    }
     list->first = newEntry;
   } else {
     newEntry->prev = iterator;
+    newEntry->next = iterator->next;
     iterator->next = newEntry;
   }
+  if (newEntry->next) {
+    newEntry->next->prev = newEntry;
+  } else {
+    list->last = newEntry;
+  }
   return 1;
 }
 
@@ -181,6 +375,9 @@ int8_t removeEntry(List list, Iterator iterator) {
   if (!list || !iterator) {
     return 0;
   }
+  if (isUnrolled(iterator)) {
+    return (list->uiOptions & LOUnrolled) && removeUnrolled(list, iterator);
+  }
   if (list != iterator->container || !iterator->pItem) {
     return 0;
   }
@@ -195,8 +392,212 @@ int8_t removeEntry(List list, Iterator iterator) {
   } else {
     iterator->next->prev = iterator->prev;
   }
-  free(iterator->pItem);
-  free(iterator);
+  if (!(list->uiOptions & LOBorrowedItems)) {
+    free(iterator->pItem);
+  }
+  freeNode(list, iterator);
+  return 1;
+}
+
+int8_t appendListEntries(List list, void * const * ppItems, uint32_t uiCount) {
+  if (!list || (uiCount && !ppItems) || uiCount > UINT32_MAX - list->uiSize) {
+    return 0;
+  }
+  uint32_t i;
+  for (i = 0; i < uiCount; ++i) {
+    if (!ppItems[i]) {
+      return 0;
+    }
+  }
+  if (list->uiOptions & LOUnrolled) {
+    return appendUnrolled(list, ppItems, uiCount);
+  }
+  // link new entries into a chain of their own, so nothing is added when memory runs out halfway
+  Iterator chainFirst = NULL;
+  Iterator chainLast = NULL;
+  for (i = 0; i < uiCount; ++i) {
+    Iterator newEntry = allocNode(list);
+    if (!newEntry) {
+      while (chainFirst) {
+	Iterator next = chainFirst->next;
+	freeNode(list, chainFirst);
+	chainFirst = next;
+      }
+      return 0;
+    }
+    newEntry->next = NULL;
+    newEntry->prev = chainLast;
+    newEntry->container = list;
+    newEntry->pItem = ppItems[i];
+    if (chainLast) {
+      chainLast->next = newEntry;
+    } else {
+      chainFirst = newEntry;
+    }
+    chainLast = newEntry;
+  }
+  if (!chainFirst) {
+    return 1;
+  }
+  chainFirst->prev = list->last;
+  if (list->last) {
+    list->last->next = chainFirst;
+  } else {
+    list->first = chainFirst;
+  }
+  list->last = chainLast;
+  list->uiSize += uiCount;
+  return 1;
+}
+
+int8_t spliceList(List list, Iterator iterator, List source, Iterator first, Iterator last) {
+  // moved nodes are freed by the allocator of 'list' later on, so they must have come from it
+  if (!list || !source || list->uiOptions != source->uiOptions || list->cpaAllocator != source->cpaAllocator || (list->uiOptions & LOUnrolled)) {
+    return 0;
+  }
+  if (!iterator) {
+    iterator = getNullIterator();
+  } else if (isUnrolled(iterator) || list != iterator->container) {
+    return 0;
+  }
+  int8_t iWhole = !first && !last;
+  if (iWhole) {
+    first = source->first;
+    last = source->last;
+    if (!first) {
+      return 1;
+    }
+  } else if (!first || !last || isUnrolled(first) || isUnrolled(last) || first->container != source || last->container != source) {
+    return 0;
+  }
+  // pooled iterators live in slabs of their list, they can only change lists together with all slabs
+  if ((list->uiOptions & LOPooledNodes) && list != source && !iWhole) {
+    return 0;
+  }
+  // count moved entries, which also checks 'last' follows 'first' and 'iterator' is not moved
+  uint32_t uiMoved = 0;
+  Iterator current = first;
+  while (current) {
+    if (current == iterator) {
+      return 0;
+    }
+    ++uiMoved;
+    if (current == last) {
+      break;
+    }
+    current = current->next;
+  }
+  if (!current || (list != source && uiMoved > UINT32_MAX - list->uiSize)) {
+    return 0;
+  }
+  // detach range from source, its entries stay linked to each other
+  if (first->prev) {
+    first->prev->next = last->next;
+  } else {
+    source->first = last->next;
+  }
+  if (last->next) {
+    last->next->prev = first->prev;
+  } else {
+    source->last = first->prev;
+  }
+  source->uiSize -= uiMoved;
+  if (list != source) {
+    for (current = first; current != last; current = current->next) {
+      current->container = list;
+    }
+    last->container = list;
+  }
+  // link range behind iterator, or in front when iterator is the 'invalid' one
+  if (!iterator->pItem) {
+    first->prev = NULL;
+    last->next = list->first;
+  } else {
+    first->prev = iterator;
+    last->next = iterator->next;
+  }
+  if (first->prev) {
+    first->prev->next = first;
+  } else {
+    list->first = first;
+  }
+  if (last->next) {
+    last->next->prev = last;
+  } else {
+    list->last = last;
+  }
+  list->uiSize += uiMoved;
+  if ((list->uiOptions & LOPooledNodes) && list != source) {
+    // slabs of source go behind those of list, so the head slab of list keeps handing out iterators
+    // recycled iterators of source are dropped, their memory is released with the slabs
+    struct _slab_ ** pSlab = &list->slabs;
+    while (*pSlab) {
+      pSlab = &(*pSlab)->next;
+    }
+    *pSlab = source->slabs;
+    source->slabs = NULL;
+    source->uiSlabUsed = NODES_PER_SLAB;
+    source->freeNodes = NULL;
+  }
+  return 1;
+}
+
+int8_t sortList(List list, entryComparator fnCompare) {
+  if (!list || !fnCompare) {
+    return 0;
+  }
+  if (list->uiSize < 2) {
+    return 1;
+  }
+  if (list->uiOptions & LOUnrolled) {
+    return sortUnrolled(list, fnCompare);
+  }
+  // bottom-up merge sort, each pass merges neighbouring runs of 'uiRun' entries until one run is left
+  // ties take the left entry, which keeps the sort stable
+  Iterator head = list->first;
+  Iterator tail = NULL;
+  uint32_t uiRun = 1;
+  uint32_t uiMerges = 0;
+  do {
+    Iterator left = head;
+    head = NULL;
+    tail = NULL;
+    uiMerges = 0;
+    while (left) {
+      ++uiMerges;
+      Iterator right = left;
+      uint32_t uiLeft = 0;
+      while (uiLeft < uiRun && right) {
+	++uiLeft;
+	right = right->next;
+      }
+      uint32_t uiRight = uiRun;
+      while (uiLeft || (uiRight && right)) {
+	Iterator next;
+	if (uiLeft && (!uiRight || !right || fnCompare(left->pItem, right->pItem) <= 0)) {
+	  next = left;
+	  left = left->next;
+	  --uiLeft;
+	} else {
+	  next = right;
+	  right = right->next;
+	  --uiRight;
+	}
+	if (tail) {
+	  tail->next = next;
+	} else {
+	  head = next;
+	}
+	next->prev = tail;
+	tail = next;
+      }
+      left = right;
+    }
+    tail->next = NULL;
+    uiRun *= 2;
+  } while (uiMerges > 1);
+  list->first = head;
+  list->last = tail;
   return 1;
 }
 
@@ -204,6 +605,9 @@ void * getCurrent(Iterator iterator) {
   if (!iterator) {
     return NULL;
   }
+  if (isUnrolled(iterator)) {
+    return getSlot(iterator);
+  }
   return iterator->pItem;
 }
 
@@ -215,6 +619,13 @@ int8_t moveNext(Iterator * pIterator) {
   if (!iterator) {
     return 0;
   }
+  if (isUnrolled(iterator)) {
+    // step within the node by address, no index has to be computed
+    struct _unrolled_ * node = getSlotNode(iterator);
+    Iterator next = (Iterator)((uintptr_t)iterator + node->uiSlotSize);
+    *pIterator = getSlot(next) < (unsigned char *)node->auiData + (size_t)node->uiCount * node->uiSlotSize ? next : node->next ? getSlotIterator(node->next, 0) : NULL;
+    return 1;
+  }
   *pIterator = iterator->next;
   return 1;
 }
@@ -226,6 +637,11 @@ int8_t movePrevious(Iterator * pIterator) {
   if (!iterator) {
     return 0;
   }
+  if (isUnrolled(iterator)) {
+    struct _unrolled_ * node = getSlotNode(iterator);
+    *pIterator = getSlot(iterator) != (unsigned char *)node->auiData ? (Iterator)((uintptr_t)iterator - node->uiSlotSize) : node->prev ? getSlotIterator(node->prev, node->prev->uiCount - 1) : NULL;
+    return 1;
+  }
   *pIterator = iterator->prev;
   return 1;
 }
@@ -234,6 +650,10 @@ int8_t isBegin(Iterator iterator) {
   if (!iterator) {
     return 1;
   }
+  if (isUnrolled(iterator)) {
+    struct _unrolled_ * node = getSlotNode(iterator);
+    return !node->prev && getSlot(iterator) == (unsigned char *)node->auiData;
+  }
   if (!iterator->pItem) {
     return 1;
   }
@@ -243,6 +663,10 @@ int8_t isEnd(Iterator iterator) {
   if (!iterator) {
     return 1;
   }
+  if (isUnrolled(iterator)) {
+    struct _unrolled_ * node = getSlotNode(iterator);
+    return !node->next && getSlotIndex(iterator, node) + 1 == node->uiCount;
+  }
   if (!iterator->pItem) {
     return 1;
   }
@@ -254,3 +678,241 @@ int8_t isEnd(Iterator iterator) {
 static inline Iterator getNullIterator() {
   return &_NULL_iterator_;
 }
+
+static inline Iterator allocNode(List list) {
+  if (!(list->uiOptions & LOPooledNodes)) {
+    return (Iterator)allocateMemory(list->cpaAllocator, sizeof(struct _iterator_), ATListNodes);
+  }
+  // prefer recycled iterators, then unused space in head slab, only then allocate a new slab
+  Iterator node = list->freeNodes;
+  if (node) {
+    list->freeNodes = node->next;
+    return node;
+  }
+  if (list->uiSlabUsed == NODES_PER_SLAB) {
+    struct _slab_ * slab = (struct _slab_ *)allocateMemory(list->cpaAllocator, sizeof(struct _slab_), ATListNodes);
+    if (!slab) {
+      return NULL;
+    }
+    slab->next = list->slabs;
+    list->slabs = slab;
+    list->uiSlabUsed = 0;
+  }
+  return &list->slabs->aNodes[list->uiSlabUsed++];
+}
+
+static inline void freeNode(List list, Iterator iterator) {
+  if (!(list->uiOptions & LOPooledNodes)) {
+    freeMemory(list->cpaAllocator, iterator);
+    return;
+  }
+  iterator->container = NULL;
+  iterator->pItem = NULL;
+  iterator->next = list->freeNodes;
+  list->freeNodes = iterator;
+}
+
+static inline int8_t isUnrolled(Iterator iterator) {
+  return (uintptr_t)iterator & 1;
+}
+
+static inline Iterator getSlotIterator(struct _unrolled_ * node, uint32_t uiIndex) {
+  return (Iterator)((uintptr_t)((unsigned char *)node->auiData + (size_t)uiIndex * node->uiSlotSize) | 1);
+}
+
+static inline unsigned char * getSlot(Iterator iterator) {
+  return (unsigned char *)((uintptr_t)iterator & ~(uintptr_t)1);
+}
+
+static inline struct _unrolled_ * getSlotNode(Iterator iterator) {
+  return (struct _unrolled_ *)((uintptr_t)iterator & ~(uintptr_t)(UNROLLED_NODE_SIZE - 1));
+}
+
+static inline uint32_t getSlotIndex(Iterator iterator, struct _unrolled_ * node) {
+  return (uint32_t)((getSlot(iterator) - (unsigned char *)node->auiData) / node->uiSlotSize);
+}
+
+static struct _unrolled_ * allocUnrolled(List list, struct _unrolled_ * prev) {
+  struct _unrolled_ * node = (struct _unrolled_ *)allocateAlignedMemory(list->cpaAllocator, UNROLLED_NODE_SIZE, UNROLLED_NODE_SIZE, ATListNodes);
+  if (!node) {
+    return NULL;
+  }
+  node->container = list;
+  node->uiCount = 0;
+  node->uiSlotSize = list->uiSlotSize;
+  node->prev = prev;
+  node->next = prev ? prev->next : list->head;
+  if (node->next) {
+    node->next->prev = node;
+  } else {
+    list->tail = node;
+  }
+  if (prev) {
+    prev->next = node;
+  } else {
+    list->head = node;
+  }
+  return node;
+}
+
+static int8_t addUnrolled(List list, Iterator iterator, const void * cpItem) {
+  struct _unrolled_ * node;
+  uint32_t uiIndex;
+  // entries are inserted at an index of a node, in front of the list that is index 0 of the first node
+  if (!iterator || iterator == getNullIterator()) {
+    node = list->head;
+    uiIndex = 0;
+  } else if (isUnrolled(iterator)) {
+    node = getSlotNode(iterator);
+    if (node->container != list) {
+      return 0;
+    }
+    uiIndex = getSlotIndex(iterator, node) + 1;
+  } else {
+    return 0;
+  }
+  if (!node) {
+    node = allocUnrolled(list, NULL);
+    if (!node) {
+      return 0;
+    }
+  } else if (node->uiCount == list->uiSlots) {
+    if (uiIndex == node->uiCount && !node->next) {
+      node = allocUnrolled(list, node);
+      uiIndex = 0;
+    } else if (!uiIndex && !node->prev) {
+      node = allocUnrolled(list, NULL);
+    } else {
+      // move the upper half into a new node and insert into whichever half the index falls in
+      struct _unrolled_ * split = allocUnrolled(list, node);
+      if (!split) {
+	return 0;
+      }
+      uint32_t uiKeep = node->uiCount / 2;
+      split->uiCount = node->uiCount - uiKeep;
+      memcpy(split->auiData, (unsigned char *)node->auiData + (size_t)uiKeep * list->uiSlotSize, (size_t)split->uiCount * list->uiSlotSize);
+      node->uiCount = uiKeep;
+      if (uiIndex > uiKeep) {
+	uiIndex -= uiKeep;
+	node = split;
+      }
+    }
+    if (!node) {
+      return 0;
+    }
+  }
+  unsigned char * pSlot = (unsigned char *)node->auiData + (size_t)uiIndex * list->uiSlotSize;
+  memmove(pSlot + list->uiSlotSize, pSlot, (size_t)(node->uiCount - uiIndex) * list->uiSlotSize);
+  memcpy(pSlot, cpItem, list->uiItemSize);
+  ++node->uiCount;
+  ++list->uiSize;
+  return 1;
+}
+
+static int8_t removeUnrolled(List list, Iterator iterator) {
+  struct _unrolled_ * node = getSlotNode(iterator);
+  if (node->container != list) {
+    return 0;
+  }
+  uint32_t uiIndex = getSlotIndex(iterator, node);
+  unsigned char * pSlot = getSlot(iterator);
+  memmove(pSlot, pSlot + list->uiSlotSize, (size_t)(node->uiCount - uiIndex - 1) * list->uiSlotSize);
+  --list->uiSize;
+  if (--node->uiCount) {
+    return 1;
+  }
+  if (node->prev) {
+    node->prev->next = node->next;
+  } else {
+    list->head = node->next;
+  }
+  if (node->next) {
+    node->next->prev = node->prev;
+  } else {
+    list->tail = node->prev;
+  }
+  freeAlignedMemory(list->cpaAllocator, node);
+  return 1;
+}
+
+static int8_t appendUnrolled(List list, void * const * ppItems, uint32_t uiCount) {
+  struct _unrolled_ * oldTail = list->tail;
+  uint32_t uiFree = oldTail ? list->uiSlots - oldTail->uiCount : 0;
+  uint32_t uiNodes = uiCount > uiFree ? (uiCount - uiFree + list->uiSlots - 1) / list->uiSlots : 0;
+  uint32_t i;
+  for (i = 0; i < uiNodes; ++i) {
+    if (!allocUnrolled(list, list->tail)) {
+      // drop the empty nodes added so far
+      while (list->tail != oldTail) {
+	struct _unrolled_ * node = list->tail;
+	list->tail = node->prev;
+	freeAlignedMemory(list->cpaAllocator, node);
+      }
+      if (oldTail) {
+	oldTail->next = NULL;
+      } else {
+	list->head = NULL;
+      }
+      return 0;
+    }
+  }
+  struct _unrolled_ * node = oldTail ? oldTail : list->head;
+  for (i = 0; i < uiCount; ++i) {
+    if (node->uiCount == list->uiSlots) {
+      node = node->next;
+    }
+    memcpy((unsigned char *)node->auiData + (size_t)node->uiCount * list->uiSlotSize, ppItems[i], list->uiItemSize);
+    ++node->uiCount;
+  }
+  list->uiSize += uiCount;
+  return 1;
+}
+
+static int8_t sortUnrolled(List list, entryComparator fnCompare) {
+  size_t szSlot = list->uiSlotSize;
+  size_t szCount = list->uiSize;
+  unsigned char * pBuffer = (unsigned char *)allocateMemory(list->cpaAllocator, 2 * szCount * szSlot, ATOther);
+  if (!pBuffer) {
+    return 0;
+  }
+  unsigned char * pFrom = pBuffer;
+  unsigned char * pTo = pBuffer + szCount * szSlot;
+  struct _unrolled_ * node;
+  size_t szUsed = 0;
+  for (node = list->head; node; node = node->next) {
+    memcpy(pFrom + szUsed, node->auiData, (size_t)node->uiCount * szSlot);
+    szUsed += (size_t)node->uiCount * szSlot;
+  }
+  // bottom-up merge sort between both halves of the buffer, ties take the left payload to stay stable
+  size_t szRun;
+  for (szRun = 1; szRun < szCount; szRun *= 2) {
+    size_t szStart;
+    for (szStart = 0; szStart < szCount; szStart += 2 * szRun) {
+      size_t szLeft = szStart;
+      size_t szMid = szStart + szRun < szCount ? szStart + szRun : szCount;
+      size_t szEnd = szStart + 2 * szRun < szCount ? szStart + 2 * szRun : szCount;
+      size_t szRight = szMid;
+      size_t szOut = szStart;
+      while (szLeft < szMid && szRight < szEnd) {
+	if (fnCompare(pFrom + szLeft * szSlot, pFrom + szRight * szSlot) <= 0) {
+	  memcpy(pTo + szOut++ * szSlot, pFrom + szLeft++ * szSlot, szSlot);
+	} else {
+	  memcpy(pTo + szOut++ * szSlot, pFrom + szRight++ * szSlot, szSlot);
+	}
+      }
+      memcpy(pTo + szOut * szSlot, pFrom + szLeft * szSlot, (szMid - szLeft) * szSlot);
+      szOut += szMid - szLeft;
+      memcpy(pTo + szOut * szSlot, pFrom + szRight * szSlot, (szEnd - szRight) * szSlot);
+    }
+    unsigned char * pSwap = pFrom;
+    pFrom = pTo;
+    pTo = pSwap;
+  }
+  szUsed = 0;
+  for (node = list->head; node; node = node->next) {
+    memcpy(node->auiData, pFrom + szUsed, (size_t)node->uiCount * szSlot);
+    szUsed += (size_t)node->uiCount * szSlot;
+  }
+  freeMemory(list->cpaAllocator, pBuffer);
+  return 1;
+}
@@ -4,10 +4,25 @@
   \brief Doubly linked list.
 */
 
+#include "alloc.h"
 #include <stdint.h>
 
+#define UNROLLED_NODE_SIZE 1024                   //!< Size and alignment of a node of an unrolled list in bytes.
+#define UNROLLED_ITEM_MAX 480                     //!< Largest payload of an unrolled list, so every node holds at least two.
+
 typedef struct _list_ * List;                     //!< Doubly linked list type.
 typedef struct _iterator_ * Iterator;             //!< Iterator of list, pointer or data pointed to may never be alter outside list implementation.
+typedef int (*entryComparator)(const void * cpLeft, const void * cpRight); //!< Orders data of two entries, negative, zero or positive like 'strcmp'.
+
+/*! \enum ListOptions
+  \brief Options of a list, may be combined.
+*/
+enum ListOptions {
+  LODefault = 0,                                  //!< Every entry is allocated separately.
+  LOPooledNodes = 1,                              //!< Entries are carved from slabs, recycled on removal and released per slab on clear.
+  LOBorrowedItems = 2,                            //!< Data of entries is owned elsewhere, e.g. by a 'StringPool', and never freed by the list.
+  LOUnrolled = 4                                  //!< Payloads of a fixed size are stored inline, several per node, only set by 'createUnrolledList'.
+};
 
 // ----------------- List functions ---------------------------------------
 
@@ -17,8 +32,37 @@ typedef struct _iterator_ * Iterator;             //!< Iterator of list, pointer
   \return Created list.
 */
 List createList();
+/*! \brief Creates a new list with options.
+  Creates a new list using given options and returns it.
+  Each list created by this function must be destroyed by 'destroyList(List)' to avoid memory leaks.
+  \param uiOptions Combination of 'ListOptions'.
+  \return Created list.
+*/
+List createListWithOptions(uint32_t uiOptions);
+/*! \brief Creates a new list with an allocator.
+  Creates a new, empty list using given options whose list, iterators and slabs are allocated by 'cpaAllocator', and returns it.
+  Data of entries is not allocated by the list and still freed with 'free' unless borrowed.
+  Each list created by this function must be destroyed by 'destroyList(List)' to avoid memory leaks.
+  \param uiOptions Combination of 'ListOptions', except LOUnrolled.
+  \param cpaAllocator Allocator of list, NULL for the default, must outlive the list.
+  \return Created list.
+*/
+List createListWithAllocator(uint32_t uiOptions, const struct Allocator * cpaAllocator);
+/*! \brief Creates a new unrolled list.
+  Creates a list storing payloads of a fixed size inline, several entries per node of UNROLLED_NODE_SIZE bytes, and returns it.
+  'addEntry' copies the payload its item points to and 'getCurrent' returns a pointer to the copy inside the node.
+  All other functions work as for any list, but adding or removing an entry moves entries within its node,
+  which invalidates iterators and payload pointers of that node and of a node split by the add.
+  Nodes need their alignment and are taken from 'allocateAlignedMemory' of the default allocator, like the list itself.
+  Each list created by this function must be destroyed by 'destroyList(List)' to avoid memory leaks.
+  \param uiItemSize Size of payload in bytes, 1 to UNROLLED_ITEM_MAX.
+  \return Created list or NULL when memory could not be allocated or size is out of range.
+*/
+List createUnrolledList(uint32_t uiItemSize);
 /*! \brief Clears a list.
   Clears a list, destroying all entries.
+  Data of entries is freed one by one unless borrowed, pooled entries themselves are released a slab at a time.
+  A pooled list with borrowed data is cleared without visiting its entries.
   All iterators to entries in the list are no longer valid.
   \param list List to clear.
 */
@@ -76,6 +120,39 @@ int8_t addEntry(List list, Iterator iterator, void * pItem);
 */
 int8_t removeEntry(List list, Iterator iterator);
 
+/*! \brief Append entries to list.
+  Adds several entries to the end of the list, allocating their iterators before linking them in one step.
+  Nothing is added when memory could not be allocated.
+  \param list List to add entries to.
+  \param ppItems Pointers to data of new entries, none may be NULL, ownership passes to the list unless items are borrowed.
+  \param uiCount Amount of entries.
+  \return 1 on success, else 0.
+*/
+int8_t appendListEntries(List list, void * const * ppItems, uint32_t uiCount);
+/*! \brief Splice entries into list.
+  Moves the entries from 'first' to 'last' of 'source' behind 'iterator' in 'list', without allocating or copying data.
+  When 'first' and 'last' are both NULL, all entries of 'source' are moved and it is left empty.
+  Iterators to moved entries stay valid and now belong to 'list', which takes time linear in the amount of moved entries.
+  Both lists must have been created with the same options and allocator. Entries of pooled lists can only be moved within a list or all at once,
+  in which case the slabs of 'source' are handed to 'list'. Unrolled lists can not be spliced.
+  \param list List to move entries to.
+  \param iterator Entry preceding moved entries, or NULL to move them to the beginning of the list.
+  \param source List to move entries from, may be 'list' as long as 'iterator' is not moved.
+  \param first First entry to move.
+  \param last Last entry to move, must not precede 'first'.
+  \return 1 on success, else 0.
+*/
+int8_t spliceList(List list, Iterator iterator, List source, Iterator first, Iterator last);
+/*! \brief Sort list.
+  Sorts the entries of a list by their data with a stable merge sort in O(n log n) time.
+  Entries are relinked in place without allocating, only unrolled lists allocate a buffer for their payloads.
+  Iterators to entries of linked lists stay valid, iterators to entries of unrolled lists are invalid afterwards.
+  \param list List to sort.
+  \param fnCompare Comparator receiving the data of two entries, as returned by 'getCurrent(Iterator)'.
+  \return 1 on success, 0 on invalid arguments or when memory could not be allocated.
+*/
+int8_t sortList(List list, entryComparator fnCompare);
+
 
 // ----------------- Iterator functions -----------------------------------
 
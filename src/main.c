@@ -1,6 +1,15 @@
-#include "list.h"
+#include "alloc.h"
+#include "array.h"
+#include "client.h"
+#include "dictionary.h"
 #include "tokenizer.h"
 #include "game.h"
+#include "match.h"
+#include "patterns.h"
+#include "server.h"
+#include "simulate.h"
+#include "strpool.h"
+#include "wordlist.h"
 
 #include <stdint.h>
 #include <stdio.h>
@@ -8,21 +17,33 @@
 #include <string.h>
 #include <time.h>
 
-static List wordList;                             //!< Word list containing all allowed words.
+#define MATRIX_WORD_LIMIT 16384                   //!< Largest word list a pattern matrix is used for by hints.
 
-/*! \brief Processes token for tokenizer.
-  Appends token to world list.
-  \param ttType Type of the token to process.
-  \param token Token data.
-  \return 0 to cancel on unsupported token type, otherwise 1.
+static Array wordList;                            //!< Word list containing all allowed words, borrowed from 'wordPool'.
+static StringPool wordPool;                       //!< Pool holding the words of 'wordList'.
+static const char * batchWords[TOKEN_BATCH_SIZE]; //!< Words of the batch 'processTokens' appends, kept off its stack.
+static const struct ParseOptions poWords = { WORD_LENGTH, WORD_LENGTH, CCAny }; //!< Filter passing only five letter tokens to 'processTokens'.
+
+/*! \brief Processes tokens for tokenizer.
+  Stores all tokens of a batch in the word pool and appends them to world list at once, the tokenizer only passes five letter tokens.
+  Repeated words are not interned, the dictionary drops them anyway.
+  \param pContext Unused.
+  \param ttType Type of the tokens to process.
+  \param cptvTokens Token data.
+  \param uiTokens Amount of tokens.
+  \return 0 to cancel on unsupported token type or when tokens can not be stored, otherwise 1.
 */
-static int8_t processToken(enum TokenType ttType, Token token) {
+static int8_t processTokens(void * pContext, enum TokenType ttType, const struct TokenView * cptvTokens, uint32_t uiTokens) {
+  uint32_t i;
+  (void)pContext;
   switch (ttType) {
   case TTText:
-    if (strlen(token) == 5) {
-      addEntry(wordList, getEnd(wordList), (void *)token);
+    for (i = 0; i < uiTokens; ++i) {
+      if (!(batchWords[i] = storeString(wordPool, cptvTokens[i].pText, cptvTokens[i].uiLength))) {
+	return 0;
+      }
     }
-    return 1;
+    return !uiTokens || appendArrayEntries(wordList, (void * const *)batchWords, uiTokens);
 
   default:
     printf("Unsupported token type\n");
@@ -30,59 +51,359 @@ static int8_t processToken(enum TokenType ttType, Token token) {
   }
 }
 
+/*! \enum ListFormats
+  \brief Output formats of '--build-list'.
+*/
+enum ListFormats {
+  LFText,                                         //!< Text list, one 'word;' per line.
+  LFBinary,                                       //!< Binary dictionary with lookup index.
+  LFBinaryCompact                                 //!< Binary dictionary without lookup index.
+};
+
 /*! \brief Builds world list.
-  Parses input list, filtering it for valid words, and writes it to the output list.
+  Parses input lists concurrently, filtering them for valid words, and writes the sorted words without repeats to the output list.
   \param caOutList Path to output list.
-  \param caInList Path to input list.
+  \param ccaInLists Paths to input lists.
+  \param uiInLists Amount of input lists.
+  \param lfFormat Format of output list.
   \return 0 on success, else error code.
 */
-static int8_t buildWordList(char * caOutList, char * caInList) {
-  if (parseFile(caInList, &processToken)) {
+static int8_t buildWordList(char * caOutList, const char * const * ccaInLists, uint32_t uiInLists, enum ListFormats lfFormat) {
+  uint32_t uiFailed;
+  Dictionary dWords = mergeWordLists(ccaInLists, uiInLists, 0, &uiFailed);
+  if (!dWords) {
+    if (uiFailed < uiInLists) {
+      printf("Error: Failed to parse '%s'.\n", ccaInLists[uiFailed]);
+    } else {
+      printf("Error: Failed to merge word lists.\n");
+    }
     return 1;
   }
+  if (lfFormat != LFText) {
+    int8_t iWritten = writeDictionary(dWords, caOutList, lfFormat == LFBinary);
+    destroyDictionary(dWords);
+    return !iWritten;
+  }
+  int8_t rc = 1;
   FILE * file = fopen(caOutList, "w");
   if (file) {
-    Iterator iter;
-    for (iter = getBegin(wordList); iter; moveNext(&iter)) {
-      const char * ccaText = (const char *)getCurrent(iter);
-      fprintf(file, "%s;\n", ccaText);
+    uint32_t i;
+    char caWord[WORD_LENGTH + 1];
+    for (i = 0; i < getWordCount(dWords); ++i) {
+      decodeWord(getWord(dWords, i), caWord);
+      fprintf(file, "%s;\n", caWord);
     }
-    fclose(file);
-  } else {
+    rc = fclose(file) != 0;
+  }
+  destroyDictionary(dWords);
+  return rc;
+}
+
+/*! \brief Loads world list with options.
+  Loads a binary dictionary with given options, or parses a text list and indexes it.
+  \param caInList Path to word list.
+  \param uiOptions Combination of 'DictionaryOptions' used for binary dictionaries.
+  \return Dictionary of all words, or NULL on error.
+*/
+static Dictionary loadWordListWithOptions(const char * caInList, uint32_t uiOptions) {
+  Dictionary dWords;
+  if (isDictionaryFile(caInList)) {
+    dWords = loadDictionaryWithOptions(caInList, uiOptions);
+    if (!dWords) {
+      printf("Error: Invalid dictionary file.\n");
+    }
+    return dWords;
+  }
+  dWords = NULL;
+  if (!parseFileBatchedWithOptions(caInList, &processTokens, NULL, &poWords)) {
+    dWords = createDictionary(wordList);
+    if (!dWords) {
+      printf("Error: Failed to index word list.\n");
+    }
+  }
+  // the dictionary holds its own packed copy, words of the list, even of a failed parse, are released at once
+  clearArray(wordList);
+  clearStringPool(wordPool);
+  return dWords;
+}
+
+/*! \brief Loads world list.
+  Maps a binary dictionary in place, or parses a text list and indexes it.
+  \param caInList Path to word list.
+  \return Dictionary of all words, or NULL on error.
+*/
+static Dictionary loadWordList(const char * caInList) {
+  return loadWordListWithOptions(caInList, DODefault);
+}
+
+/*! \brief Loads served world list.
+  Reads a binary dictionary into memory, or parses a text list and indexes it.
+  Served lists are reloaded after being rewritten in place, which a mapping of the file would not survive.
+  \param caInList Path to word list.
+  \return Dictionary of all words, or NULL on error.
+*/
+static Dictionary loadServedWordList(const char * caInList) {
+  return loadWordListWithOptions(caInList, DOCopied);
+}
+
+/*! \brief Builds pattern cache.
+  Builds the pattern matrix of a word list and writes it to the cache next to the list.
+  \param caInList Path to word list.
+  \param uiThreads Amount of threads, 0 to use one per core.
+  \return 0 on success, else error code.
+*/
+static int8_t buildPatterns(char * caInList, uint32_t uiThreads) {
+  Dictionary dWords = loadWordList(caInList);
+  if (!dWords) {
     return 1;
   }
-  return 0;
+  struct timespec tsStart, tsEnd;
+  clock_gettime(CLOCK_MONOTONIC, &tsStart);
+  PatternMatrix pmPatterns = buildPatternMatrix(dWords, uiThreads);
+  clock_gettime(CLOCK_MONOTONIC, &tsEnd);
+  if (!pmPatterns) {
+    destroyDictionary(dWords);
+    printf("Error: Failed to build pattern matrix.\n");
+    return 1;
+  }
+  printf("Built %u x %u patterns in %.3f s.\n", getPatternMatrixSize(pmPatterns), getPatternMatrixSize(pmPatterns),
+	 (tsEnd.tv_sec - tsStart.tv_sec) + (tsEnd.tv_nsec - tsStart.tv_nsec) / 1e9);
+  char * caCachePath = (char *)allocateMemory(NULL, strlen(caInList) + sizeof(".patterns"), ATOther);
+  int8_t rc = 1;
+  if (caCachePath) {
+    strcpy(caCachePath, caInList);
+    strcat(caCachePath, ".patterns");
+    rc = !writePatternMatrix(pmPatterns, caCachePath);
+    if (rc) {
+      printf("Error: Failed to write '%s'.\n", caCachePath);
+    }
+    freeMemory(NULL, caCachePath);
+  }
+  destroyPatternMatrix(pmPatterns);
+  destroyDictionary(dWords);
+  return rc;
 }
 
 /*! \brief Runs a game.
   Initializes resources and starts a new match.
   \param caInList Path to word list.
+  \param iWithHints Suggest a guess before every round.
+  \param uiOptions Combination of 'MatchOptions'.
   \return 0 on success, else error code.
 */
-static int8_t runGame(char * caInList) {
+static int8_t runGame(char * caInList, int8_t iWithHints, uint32_t uiOptions) {
   srand(time(NULL));
   printf("Guess the word! (or use Ctrl-C to quit)\n ^ appears below correct characters.\n * appears below characters in wrong location.\n");
-  if (parseFile(caInList, &processToken)) {
+  Dictionary dWords = loadWordList(caInList);
+  if (!dWords) {
     return 1;
   }
-  if (getSize(wordList)) {
-    enum MatchResults mrResult = startMatch(rand() % getSize(wordList), wordList);
-    switch (mrResult) {
-    case MRWin:
-      printf("You won the game.\n");
-      break;
-    case MRLose:
-      printf("You lost the game.\n");
-      break;
-    default:
-      printf("Game resulted in run-time error: [%d]\n", mrResult);
-      break;
+  if (!getWordCount(dWords)) {
+    destroyDictionary(dWords);
+    printf("Error: Word list empty.\n");
+    return 1;
+  }
+  PatternMatrix pmPatterns = NULL;
+  CandidateIndex ciIndex = NULL;
+  CandidateSet csCandidates = NULL;
+  Solver sHints = NULL;
+  if (iWithHints) {
+    // beyond this size the matrix costs more memory than ranking on the fly costs time
+    if (getWordCount(dWords) <= MATRIX_WORD_LIMIT) {
+      pmPatterns = openPatternMatrix(caInList, dWords, 0);
     }
+    ciIndex = createCandidateIndex(dWords);
+    csCandidates = ciIndex ? createCandidateSet(ciIndex) : NULL;
+    sHints = createSolver(dWords, pmPatterns, 0);
+    if (!csCandidates || !sHints) {
+      printf("Warning: Failed to create solver, playing without hints.\n");
+    }
+  }
+  enum MatchResults mrResult = startMatch(rand() % getWordCount(dWords), dWords, uiOptions, csCandidates, sHints);
+  destroySolver(sHints);
+  destroyCandidateSet(csCandidates);
+  destroyCandidateIndex(ciIndex);
+  destroyPatternMatrix(pmPatterns);
+  destroyDictionary(dWords);
+  switch (mrResult) {
+  case MRWin:
+    printf("You won the game.\n");
+    break;
+  case MRLose:
+    printf("You lost the game.\n");
+    break;
+  default:
+    printf("Game resulted in run-time error: [%d]\n", mrResult);
+    break;
+  }
+  return 0;
+}
+
+/*! \brief Runs a simulation.
+  Plays a match for every word of a list, or for a sample of it, with a strategy and reports the results.
+  \param caInList Path to word list.
+  \param ccaStrategy Name of strategy.
+  \param uiSample Amount of answers, 0 for every word.
+  \param uiSeed Seed of sample.
+  \param uiThreads Amount of threads, 0 to use one per core.
+  \param uiOptions Combination of 'MatchOptions'.
+  \return 0 on success, else error code.
+*/
+static int8_t runSimulate(char * caInList, const char * ccaStrategy, uint32_t uiSample, uint64_t uiSeed, uint32_t uiThreads, uint32_t uiOptions) {
+  const struct Strategy * cpsStrategy = findStrategy(ccaStrategy);
+  if (!cpsStrategy) {
+    printf("Error: Unknown strategy '%s'.\n", ccaStrategy);
+    return 1;
+  }
+  Dictionary dWords = loadWordList(caInList);
+  if (!dWords) {
+    return 1;
+  }
+  uint32_t uiCount = getWordCount(dWords);
+  if (!uiSample || uiSample > uiCount) {
+    uiSample = uiCount;
+  }
+  PatternMatrix pmPatterns = NULL;
+  if (cpsStrategy->iUsesPatterns && uiCount <= MATRIX_WORD_LIMIT) {
+    pmPatterns = openPatternMatrix(caInList, dWords, uiThreads);
+  }
+  uint32_t * puiAnswers = (uint32_t *)allocateMemory(NULL, sizeof(uint32_t) * (uiSample + 1), ATMatchState);
+  struct SimulationResults srResults;
+  int8_t rc = 1;
+  if (!puiAnswers || !sampleAnswers(uiCount, uiSample, uiSeed, puiAnswers)
+      || !runSimulation(dWords, pmPatterns, cpsStrategy, puiAnswers, uiSample, uiOptions, uiThreads, &srResults)) {
+    printf("Error: Failed to run simulation.\n");
   } else {
+    uint8_t i;
+    uint64_t uiGuesses = 0;
+    printf("Played %u matches with '%s' on %u thread(s) in %.3f s (%.0f matches/s).\n", srResults.uiMatches, cpsStrategy->ccaName,
+	   srResults.uiWorkers, srResults.dSeconds, srResults.dSeconds > 0 ? srResults.uiMatches / srResults.dSeconds : 0.0);
+    printf("Won %u (%.2f%%).\n", srResults.uiWins, srResults.uiMatches ? 100.0 * srResults.uiWins / srResults.uiMatches : 0.0);
+    for (i = 0; i < MATCH_ROUNDS; ++i) {
+      printf("  %d guess(es): %u\n", i + 1, srResults.auiWinsIn[i]);
+      uiGuesses += (uint64_t)(i + 1) * srResults.auiWinsIn[i];
+    }
+    printf("  lost: %u (%u without a legal guess)\n", srResults.uiMatches - srResults.uiWins, srResults.uiGaveUp);
+    if (srResults.uiWins) {
+      printf("Average guesses per win: %.3f\n", (double)uiGuesses / srResults.uiWins);
+    }
+    rc = 0;
+  }
+  freeMemory(NULL, puiAnswers);
+  destroyPatternMatrix(pmPatterns);
+  destroyDictionary(dWords);
+  return rc;
+}
+
+/*! \brief Runs a server.
+  Loads a word list and serves matches on a Unix domain socket until interrupted.
+  The list is reloaded whenever it changes, running matches keep the words they started with.
+  \param caInList Path to word list.
+  \param ccaSocket Path of socket.
+  \return 0 on success, else error code.
+*/
+static int8_t runServe(char * caInList, const char * ccaSocket) {
+  Dictionary dWords = loadServedWordList(caInList);
+  if (!dWords) {
+    return 1;
+  }
+  if (!getWordCount(dWords)) {
+    destroyDictionary(dWords);
     printf("Error: Word list empty.\n");
     return 1;
   }
-  return 0;
+  printf("Serving %u words on '%s'.\n", getWordCount(dWords), ccaSocket);
+  DictionarySource dsSource = createDictionarySource(dWords);
+  if (!dsSource) {
+    printf("Error: Failed to publish word list.\n");
+    return 1;
+  }
+  // from here on only the watcher thread loads lists, so it may use the shared word list buffer
+  if (!watchWordList(dsSource, caInList, &loadServedWordList)) {
+    printf("Warning: Changes of '%s' will not be picked up.\n", caInList);
+  }
+  fflush(stdout);
+  int8_t rc = !runServer(dsSource, ccaSocket);
+  if (rc) {
+    printf("Error: Failed to serve on '%s'.\n", ccaSocket);
+  }
+  destroyDictionarySource(dsSource);
+  return rc;
+}
+
+/*! \brief Runs a load test.
+  Plays matches against a server with concurrent sessions and reports throughput and latency.
+  \param caInList Path to word list the server was started with.
+  \param ccaSocket Path of socket.
+  \param uiSessions Amount of concurrent sessions.
+  \param uiMatches Amount of matches per session.
+  \return 0 on success, else error code.
+*/
+static int8_t runLoadTest(char * caInList, const char * ccaSocket, uint32_t uiSessions, uint32_t uiMatches) {
+  struct ClientResults crResults;
+  Dictionary dWords = loadWordList(caInList);
+  if (!dWords) {
+    return 1;
+  }
+  int8_t rc = !runClient(dWords, ccaSocket, uiSessions, uiMatches, &crResults);
+  if (rc) {
+    printf("Error: Load test against '%s' failed.\n", ccaSocket);
+  }
+  printf("%u session(s) finished %u matches (%u won) with %lu requests in %.3f s.\n", uiSessions, crResults.uiMatches, crResults.uiWins,
+	 (unsigned long)crResults.uiRequests, crResults.dSeconds);
+  printf("%.0f requests/s, mean round trip %.1f us.\n", crResults.dSeconds > 0 ? crResults.uiRequests / crResults.dSeconds : 0.0,
+	 crResults.dRoundTrip * 1e6);
+  destroyDictionary(dWords);
+  return rc;
+}
+
+/*! \brief Runs '--build-list'.
+  Reads the output format, output list and input lists from the command line and builds the list.
+  Options other than one leading format are rejected, so they are never taken as paths.
+  \param argc Amount of arguments passed from command line.
+  \param argv Arguments passed from command line, 'argv[1]' is '--build-list'.
+  \return 0 on success, else error code.
+*/
+static int8_t runBuildList(int argc, char ** argv) {
+  enum ListFormats lfFormat = LFText;
+  char ** caArgs = argv + 2;
+  if (!strcmp(caArgs[0], "--binary")) {
+    lfFormat = LFBinary;
+    ++caArgs;
+  } else if (!strcmp(caArgs[0], "--binary-compact")) {
+    lfFormat = LFBinaryCompact;
+    ++caArgs;
+  }
+  int iArgs = argc - (int)(caArgs - argv);
+  if (iArgs < 2) {
+    printf("Specify input list(s).\n");
+    return 1;
+  }
+  // only one format option is read, anything else looking like an option would be taken as a path and written to or parsed
+  int i;
+  for (i = 0; i < iArgs; ++i) {
+    if (!strncmp(caArgs[i], "--", 2)) {
+      printf("Error: Unexpected argument '%s'.\n", caArgs[i]);
+      return 1;
+    }
+  }
+  return buildWordList(caArgs[0], (const char * const *)(caArgs + 1), (uint32_t)(iArgs - 1), lfFormat);
+}
+
+/*! \brief Prints memory stats.
+  Prints bytes and allocations per subsystem, allocations still live at exit are leaks.
+  \param mcCounter Counter that was the default allocator.
+*/
+static void printMemoryStats(MemoryCounter mcCounter) {
+  static const char * const ccaTags[ALLOCATION_TAGS] = { "list nodes", "token buffers", "dictionary words", "match state", "pattern matrix", "other" };
+  struct MemoryStats msStats;
+  uint32_t i;
+  printf("%-18s %14s %14s %12s %8s\n", "Memory", "Bytes", "Peak bytes", "Allocations", "Live");
+  for (i = 0; i < ALLOCATION_TAGS; ++i) {
+    getMemoryStats(mcCounter, (enum AllocationTags)i, &msStats);
+    printf("%-18s %14lu %14lu %12lu %8lu\n", ccaTags[i], (unsigned long)msStats.szBytes, (unsigned long)msStats.szPeakBytes,
+	   (unsigned long)msStats.uiAllocations, (unsigned long)msStats.uiLive);
+  }
 }
 
 /*! \brief Entry point.
@@ -92,36 +413,88 @@ static int8_t runGame(char * caInList) {
   \return 0 on supported run type, otherwise error code.
 */
 int main(int argc, char ** argv) {
-  wordList = createList();
+  // '--memory-stats' may precede any mode, accounting has to start before anything is allocated
+  MemoryCounter mcCounter = NULL;
+  if (argc > 1 && !strcmp(argv[1], "--memory-stats")) {
+    mcCounter = createMemoryCounter(NULL);
+    setDefaultAllocator(getCounterAllocator(mcCounter));
+    argv[1] = argv[0];
+    ++argv;
+    --argc;
+  }
+  wordList = createArrayWithOptions(AOBorrowedEntries);
+  wordPool = createStringPool();
   int rc = 0;
   
   switch (argc) {
   case 0:
   case 1:
-    rc = runGame("list");
+    rc = runGame("list", 0, MODefault);
     break;
 
   case 3:
   case 4:
+  case 5:
+  case 6:
+  case 7:
+  case 8:
     if (!strcmp(argv[1], "--build-list")) {
-      if (argc < 4) {
-	printf("Specify input list(s).\n");
+      rc = runBuildList(argc, argv);
+    } else if (!strcmp(argv[1], "--run-game") || !strcmp(argv[1], "--solve")) {
+      uint32_t uiOptions = MODefault;
+      char ** caArgs = argv + 2;
+      if (!strcmp(caArgs[0], "--hard")) {
+	uiOptions |= MOHardMode;
+	++caArgs;
+      }
+      if (argc - (caArgs - argv) < 1) {
+	printf("Specify word list.\n");
 	rc = 1;
       } else {
-	rc = buildWordList(argv[2], argv[3]);
+	rc = runGame(caArgs[0], !strcmp(argv[1], "--solve"), uiOptions);
+      }
+    } else if (!strcmp(argv[1], "--simulate")) {
+      uint32_t uiOptions = MODefault;
+      char ** caArgs = argv + 2;
+      if (!strcmp(caArgs[0], "--hard")) {
+	uiOptions |= MOHardMode;
+	++caArgs;
       }
-    } else if (!strcmp(argv[1], "--run-game")) {
-      rc = runGame(argv[2]);
+      int iArgs = argc - (int)(caArgs - argv);
+      if (iArgs < 1) {
+	printf("Specify word list.\n");
+	rc = 1;
+      } else {
+	rc = runSimulate(caArgs[0], iArgs > 1 ? caArgs[1] : "entropy", iArgs > 2 ? (uint32_t)strtoul(caArgs[2], NULL, 10) : 0,
+			 iArgs > 3 ? strtoull(caArgs[3], NULL, 10) : 1, iArgs > 4 ? (uint32_t)strtoul(caArgs[4], NULL, 10) : 0, uiOptions);
+      }
+    } else if (!strcmp(argv[1], "--serve") && argc > 3) {
+      rc = runServe(argv[2], argv[3]);
+    } else if (!strcmp(argv[1], "--client") && argc > 3) {
+      rc = runLoadTest(argv[2], argv[3], argc > 4 ? (uint32_t)strtoul(argv[4], NULL, 10) : 1, argc > 5 ? (uint32_t)strtoul(argv[5], NULL, 10) : 1);
+    } else if (!strcmp(argv[1], "--build-patterns")) {
+      rc = buildPatterns(argv[2], argc > 3 ? (uint32_t)strtoul(argv[3], NULL, 10) : 0);
     } else {
       printf("Error: Invalid mode.\n");
     }
     break;
     
   default:
+    // any amount of input lists may be merged
+    if (argc > 8 && !strcmp(argv[1], "--build-list")) {
+      rc = runBuildList(argc, argv);
+      break;
+    }
     printf("Error: Invalid amount of arguments.\n");
     rc = 1;
   }
 
-  destroyList(wordList);
+  destroyArray(wordList);
+  destroyStringPool(wordPool);
+  if (mcCounter) {
+    printMemoryStats(mcCounter);
+    setDefaultAllocator(NULL);
+    destroyMemoryCounter(mcCounter);
+  }
   return rc;
 }
@@ -0,0 +1,260 @@
+#include "match.h"
+
+#include "feedback.h"
+#include <stddef.h>
+#include <string.h>
+
+// ----------------- Local Function declarations --------------------------
+
+/*! \brief Score guess.
+  Computes feedback of a guess, reveals correctly placed letters in the tip and narrows tracked candidates.
+  \param pmMatch Match to score guess in.
+  \param pwGuess Packed guess.
+  \param pgfFeedback Receives feedback, may be NULL.
+*/
+static inline void scoreGuess(struct Match * pmMatch, PackedWord pwGuess, struct GuessFeedback * pgfFeedback);
+/*! \brief Initialize constraints.
+  Sets up constraints allowing any word with the given first letter.
+  \param pmcConstraints Constraints to initialize.
+  \param uiFirstLetter Letter index of first letter, as revealed by the tip.
+*/
+static inline void initConstraints(struct MatchConstraints * pmcConstraints, uint8_t uiFirstLetter);
+/*! \brief Add feedback to constraints.
+  Narrows constraints by the feedback of a guess.
+  \param pmcConstraints Constraints to narrow.
+  \param pwGuess Packed guess.
+  \param pPattern Pattern of guess.
+*/
+static inline void addConstraints(struct MatchConstraints * pmcConstraints, PackedWord pwGuess, Pattern pPattern);
+/*! \brief Check constraints.
+  Checks a guess against constraints, the work done does not depend on the amount of guesses so far.
+  \param cpmcConstraints Constraints to check against.
+  \param pwGuess Packed guess.
+  \param pcvViolation Receives the first violated constraint.
+  \return 1 when guess is consistent, else 0.
+*/
+static inline int8_t checkConstraints(const struct MatchConstraints * cpmcConstraints, PackedWord pwGuess, struct ConstraintViolation * pcvViolation);
+
+
+// ----------------- Global Function definitions --------------------------
+int8_t initMatch(struct Match * pmMatch, Dictionary dWords, uint32_t uiIndex) {
+  return initMatchWithOptions(pmMatch, dWords, uiIndex, MODefault);
+}
+
+int8_t initMatchWithOptions(struct Match * pmMatch, Dictionary dWords, uint32_t uiIndex, uint32_t uiOptions) {
+  if (!pmMatch) {
+    return 0;
+  }
+  pmMatch->dWords = dWords;
+  pmMatch->pwWord = getWord(dWords, uiIndex);
+  pmMatch->uiRemainingRounds = MATCH_ROUNDS;
+  pmMatch->msState = MSRunning;
+  pmMatch->csCandidates = NULL;
+  pmMatch->uiOptions = uiOptions;
+  pmMatch->cvViolation.cvType = CVNone;
+  if (pmMatch->pwWord == INVALID_WORD) {
+    pmMatch->msState = MSLost;
+    return 0;
+  }
+  // first letter is given away
+  memset(pmMatch->caTip, (int)'_', sizeof(char) * WORD_LENGTH);
+  pmMatch->caTip[0] = (char)('a' + getLetter(pmMatch->pwWord, 0));
+  pmMatch->caTip[WORD_LENGTH] = '\0';
+  if (uiOptions & MOHardMode) {
+    initConstraints(&pmMatch->mcConstraints, getLetter(pmMatch->pwWord, 0));
+  }
+  return 1;
+}
+
+void trackCandidates(struct Match * pmMatch, CandidateSet csCandidates) {
+  pmMatch->csCandidates = csCandidates;
+  if (csCandidates) {
+    resetCandidates(csCandidates);
+    requireLetter(csCandidates, 0, (uint8_t)(pmMatch->caTip[0] - 'a'));
+  }
+}
+
+enum GuessResults submitGuess(struct Match * pmMatch, const char * ccaGuess, struct GuessFeedback * pgfFeedback) {
+  if (!pmMatch || pmMatch->msState != MSRunning) {
+    return GRMatchOver;
+  }
+  return submitPackedGuess(pmMatch, encodeWord(ccaGuess), pgfFeedback);
+}
+
+enum GuessResults submitPackedGuess(struct Match * pmMatch, PackedWord pwGuess, struct GuessFeedback * pgfFeedback) {
+  if (!pmMatch || pmMatch->msState != MSRunning) {
+    return GRMatchOver;
+  }
+  if (pwGuess == INVALID_WORD) {
+    return GRInvalidWord;
+  }
+  if (!containsPackedWord(pmMatch->dWords, pwGuess)) {
+    return GRUnknownWord;
+  }
+  if ((pmMatch->uiOptions & MOHardMode) && !checkConstraints(&pmMatch->mcConstraints, pwGuess, &pmMatch->cvViolation)) {
+    return GRConstraintViolated;
+  }
+  if (pwGuess == pmMatch->pwWord) {
+    if (pmMatch->csCandidates) {
+      narrowCandidates(pmMatch->csCandidates, pwGuess, PATTERN_SOLVED);
+    }
+    pmMatch->msState = MSWon;
+    return GRWon;
+  }
+  scoreGuess(pmMatch, pwGuess, pgfFeedback);
+  if (!--pmMatch->uiRemainingRounds) {
+    pmMatch->msState = MSLost;
+    return GRLost;
+  }
+  return GRAccepted;
+}
+
+enum MatchStates getMatchState(const struct Match * cpmMatch) {
+  return cpmMatch->msState;
+}
+
+uint32_t getMatchOptions(const struct Match * cpmMatch) {
+  return cpmMatch->uiOptions;
+}
+
+uint8_t getRemainingRounds(const struct Match * cpmMatch) {
+  return cpmMatch->uiRemainingRounds;
+}
+
+const struct ConstraintViolation * getViolation(const struct Match * cpmMatch) {
+  return &cpmMatch->cvViolation;
+}
+
+const char * getTip(const struct Match * cpmMatch) {
+  return cpmMatch->caTip;
+}
+
+CandidateSet getMatchCandidates(const struct Match * cpmMatch) {
+  return cpmMatch->csCandidates;
+}
+
+PackedWord getMatchWord(const struct Match * cpmMatch) {
+  return cpmMatch->pwWord;
+}
+
+
+// ----------------- Local Function definitions ---------------------------
+static inline void scoreGuess(struct Match * pmMatch, PackedWord pwGuess, struct GuessFeedback * pgfFeedback) {
+  Pattern pPattern = computePattern(pwGuess, pmMatch->pwWord);
+  uint8_t i;
+  for (i = 0; i < WORD_LENGTH; ++i) {
+    uint8_t uiDigit = getPatternDigit(pPattern, i);
+    if (uiDigit == LFCorrect) {
+      pmMatch->caTip[i] = (char)('a' + getLetter(pwGuess, i));
+    }
+    if (pgfFeedback) {
+      pgfFeedback->auiLetters[i] = uiDigit;
+    }
+  }
+  if (pmMatch->csCandidates) {
+    narrowCandidates(pmMatch->csCandidates, pwGuess, pPattern);
+  }
+  if (pmMatch->uiOptions & MOHardMode) {
+    addConstraints(&pmMatch->mcConstraints, pwGuess, pPattern);
+  }
+}
+
+static inline void initConstraints(struct MatchConstraints * pmcConstraints, uint8_t uiFirstLetter) {
+  uint8_t i;
+  for (i = 0; i < WORD_LENGTH; ++i) {
+    pmcConstraints->auiAllowed[i] = (1u << LETTER_COUNT) - 1;
+  }
+  memset(pmcConstraints->auiMinCounts, 0, sizeof(pmcConstraints->auiMinCounts));
+  memset(pmcConstraints->auiMaxCounts, WORD_LENGTH, sizeof(pmcConstraints->auiMaxCounts));
+  // the tip reveals the first letter like a correct guess would
+  pmcConstraints->auiAllowed[0] = 1u << uiFirstLetter;
+  pmcConstraints->auiMinCounts[uiFirstLetter] = 1;
+  pmcConstraints->auiRequired[0] = uiFirstLetter;
+  pmcConstraints->uiRequired = 1;
+}
+
+static inline void addConstraints(struct MatchConstraints * pmcConstraints, PackedWord pwGuess, Pattern pPattern) {
+  uint8_t auiMarked[LETTER_COUNT] = { 0 };
+  uint8_t auiAbsent[LETTER_COUNT] = { 0 };
+  uint8_t i;
+  for (i = 0; i < WORD_LENGTH; ++i) {
+    uint8_t uiLetter = getLetter(pwGuess, i);
+    uint8_t uiDigit = getPatternDigit(pPattern, i);
+    if (uiDigit == LFCorrect) {
+      pmcConstraints->auiAllowed[i] = 1u << uiLetter;
+    } else {
+      // a letter that is not correct here is never at this position
+      pmcConstraints->auiAllowed[i] &= ~(1u << uiLetter);
+    }
+    if (uiDigit == LFAbsent) {
+      auiAbsent[uiLetter] = 1;
+    } else {
+      ++auiMarked[uiLetter];
+    }
+  }
+  for (i = 0; i < WORD_LENGTH; ++i) {
+    uint8_t uiLetter = getLetter(pwGuess, i);
+    if (auiMarked[uiLetter] > pmcConstraints->auiMinCounts[uiLetter]) {
+      if (!pmcConstraints->auiMinCounts[uiLetter] && pmcConstraints->uiRequired < WORD_LENGTH) {
+	pmcConstraints->auiRequired[pmcConstraints->uiRequired++] = uiLetter;
+      }
+      pmcConstraints->auiMinCounts[uiLetter] = auiMarked[uiLetter];
+    }
+    // an absent copy means every copy in the word was marked
+    if (auiAbsent[uiLetter]) {
+      pmcConstraints->auiMaxCounts[uiLetter] = auiMarked[uiLetter];
+    }
+  }
+}
+
+static inline int8_t checkConstraints(const struct MatchConstraints * cpmcConstraints, PackedWord pwGuess, struct ConstraintViolation * pcvViolation) {
+  uint8_t auiLetters[WORD_LENGTH];
+  uint8_t i;
+  uint8_t j;
+  for (i = 0; i < WORD_LENGTH; ++i) {
+    auiLetters[i] = getLetter(pwGuess, i);
+  }
+  for (i = 0; i < WORD_LENGTH; ++i) {
+    uint32_t uiAllowed = cpmcConstraints->auiAllowed[i];
+    if (!(uiAllowed & (uiAllowed - 1)) && !((uiAllowed >> auiLetters[i]) & 1)) {
+      pcvViolation->cvType = CVFixedLetter;
+      pcvViolation->uiPosition = i;
+      pcvViolation->uiLetter = (uint8_t)__builtin_ctz(uiAllowed);
+      return 0;
+    }
+  }
+  for (i = 0; i < cpmcConstraints->uiRequired; ++i) {
+    uint8_t uiLetter = cpmcConstraints->auiRequired[i];
+    uint8_t uiCount = 0;
+    for (j = 0; j < WORD_LENGTH; ++j) {
+      uiCount += auiLetters[j] == uiLetter;
+    }
+    if (uiCount < cpmcConstraints->auiMinCounts[uiLetter]) {
+      pcvViolation->cvType = CVMissingLetter;
+      pcvViolation->uiLetter = uiLetter;
+      pcvViolation->uiCount = cpmcConstraints->auiMinCounts[uiLetter];
+      return 0;
+    }
+  }
+  for (i = 0; i < WORD_LENGTH; ++i) {
+    if (!((cpmcConstraints->auiAllowed[i] >> auiLetters[i]) & 1)) {
+      pcvViolation->cvType = CVExcludedLetter;
+      pcvViolation->uiPosition = i;
+      pcvViolation->uiLetter = auiLetters[i];
+      return 0;
+    }
+  }
+  for (i = 0; i < WORD_LENGTH; ++i) {
+    uint8_t uiCount = 0;
+    for (j = 0; j < WORD_LENGTH; ++j) {
+      uiCount += auiLetters[j] == auiLetters[i];
+    }
+    if (uiCount > cpmcConstraints->auiMaxCounts[auiLetters[i]]) {
+      pcvViolation->cvType = CVExcessLetter;
+      pcvViolation->uiLetter = auiLetters[i];
+      pcvViolation->uiCount = cpmcConstraints->auiMaxCounts[auiLetters[i]];
+      return 0;
+    }
+  }
+  return 1;
+}
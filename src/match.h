@@ -0,0 +1,185 @@
+#pragma once
+
+/*! \file match.h
+  \brief Headless match engine.
+  A match is a plain value that lives wherever the caller puts it, the engine never allocates memory and never performs I/O.
+*/
+
+#include "candidates.h"
+#include "dictionary.h"
+#include "word.h"
+#include <stdint.h>
+
+#define MATCH_ROUNDS 5                            //!< Amount of guesses in a match.
+
+/*! \enum MatchOptions
+  \brief Options of a match, combined as bit flags.
+*/
+enum MatchOptions {
+  MODefault = 0,                                  //!< Any dictionary word may be guessed.
+  MOHardMode = 1                                  //!< Every guess must be consistent with all information revealed so far.
+};
+
+/*! \enum MatchStates
+  \brief States of a match.
+*/
+enum MatchStates {
+  MSRunning,                                      //!< Match accepts guesses.
+  MSWon,                                          //!< Word was guessed.
+  MSLost                                          //!< No guesses remaining.
+};
+
+/*! \enum GuessResults
+  \brief Results of submitting a guess.
+*/
+enum GuessResults {
+  GRAccepted,                                     //!< Guess was wrong, feedback is available and match continues.
+  GRWon,                                          //!< Guess was correct, match is won.
+  GRLost,                                         //!< Guess was wrong and it was the last one, feedback is available.
+  GRInvalidWord,                                  //!< Guess is not five letters (a-z or A-Z), no round used.
+  GRUnknownWord,                                  //!< Guess is not in dictionary, no round used.
+  GRConstraintViolated,                           //!< Guess ignores revealed information in hard mode, no round used, see 'getViolation'.
+  GRMatchOver                                     //!< Match already has a result, no round used.
+};
+
+/*! \enum LetterFeedback
+  \brief Feedback of one letter of a guess.
+  Values match the digits of a pattern code, see feedback.h.
+*/
+enum LetterFeedback {
+  LFAbsent = 0,                                   //!< Letter is not in word.
+  LFPresent = 1,                                  //!< Letter is in word, at another position.
+  LFCorrect = 2                                   //!< Letter is at this position in word.
+};
+
+/*! \struct GuessFeedback
+  \brief Feedback of a guess.
+*/
+struct GuessFeedback {
+  uint8_t auiLetters[WORD_LENGTH];                //!< 'LetterFeedback' per position of guess.
+};
+
+/*! \enum ConstraintViolations
+  \brief Ways a guess can ignore revealed information.
+*/
+enum ConstraintViolations {
+  CVNone,                                         //!< Guess is consistent.
+  CVFixedLetter,                                  //!< Position must hold the letter known to be there.
+  CVExcludedLetter,                               //!< Letter is known not to be at this position.
+  CVMissingLetter,                                //!< Letter is known to occur more often than in guess.
+  CVExcessLetter                                  //!< Letter is known to occur less often than in guess.
+};
+
+/*! \struct ConstraintViolation
+  \brief Constraint a guess violated.
+*/
+struct ConstraintViolation {
+  enum ConstraintViolations cvType;               //!< Violated constraint.
+  uint8_t uiPosition;                             //!< Position of letter, for CVFixedLetter and CVExcludedLetter.
+  uint8_t uiLetter;                               //!< Letter index, for CVFixedLetter the required letter, else the offending one.
+  uint8_t uiCount;                                //!< Required minimum for CVMissingLetter, allowed maximum for CVExcessLetter.
+};
+
+/*! \struct MatchConstraints
+  \brief Information revealed in a match, checked in hard mode.
+  Checking a guess costs a fixed amount of work, independent of how many guesses were made.
+*/
+struct MatchConstraints {
+  uint32_t auiAllowed[WORD_LENGTH];               //!< Letters allowed per position, bit 0 for 'a'.
+  uint8_t auiMinCounts[LETTER_COUNT];             //!< Least amount of each letter.
+  uint8_t auiMaxCounts[LETTER_COUNT];             //!< Largest amount of each letter.
+  uint8_t auiRequired[WORD_LENGTH];               //!< Letters with a minimum count above 0, in order of discovery.
+  uint8_t uiRequired;                             //!< Amount of required letters.
+};
+
+/*! \struct Match
+  \brief State of a match.
+  Fields are only to be read and written through the functions in this file, the struct is public so matches can live on the stack or in arrays.
+*/
+struct Match {
+  Dictionary dWords;                              //!< Dictionary of allowed words, not owned.
+  PackedWord pwWord;                              //!< Word to guess.
+  uint8_t uiRemainingRounds;                      //!< Remaining amount of tries.
+  enum MatchStates msState;                       //!< State of match.
+  char caTip[WORD_LENGTH + 1];                    //!< Tip showing first letter and all correctly placed letters, '_' elsewhere.
+  CandidateSet csCandidates;                      //!< Words consistent with tip and feedback, not owned, or NULL when not tracked.
+  uint32_t uiOptions;                             //!< 'MatchOptions' of match.
+  struct MatchConstraints mcConstraints;          //!< Revealed information, maintained in hard mode.
+  struct ConstraintViolation cvViolation;         //!< Violation of last rejected guess.
+};
+
+/*! \brief Initializes a match.
+  Sets up a match guessing the word at given index of a dictionary.
+  \param pmMatch Match to initialize.
+  \param dWords Dictionary of allowed words, must outlive the match.
+  \param uiIndex Index of word to guess in 'dWords'.
+  \return 1 on success, 0 when index is out of bounds.
+*/
+int8_t initMatch(struct Match * pmMatch, Dictionary dWords, uint32_t uiIndex);
+/*! \brief Initializes a match with options.
+  Sets up a match guessing the word at given index of a dictionary.
+  In hard mode the tip and the feedback of every guess constrain all later guesses.
+  \param pmMatch Match to initialize.
+  \param dWords Dictionary of allowed words, must outlive the match.
+  \param uiIndex Index of word to guess in 'dWords'.
+  \param uiOptions Combination of 'MatchOptions'.
+  \return 1 on success, 0 when index is out of bounds.
+*/
+int8_t initMatchWithOptions(struct Match * pmMatch, Dictionary dWords, uint32_t uiIndex, uint32_t uiOptions);
+/*! \brief Track candidates.
+  Resets a candidate set to the words consistent with the tip and narrows it after every guess of the match.
+  \param pmMatch Match to track candidates of, must be initialized.
+  \param csCandidates Set over the dictionary of the match, must outlive the match, NULL to stop tracking.
+*/
+void trackCandidates(struct Match * pmMatch, CandidateSet csCandidates);
+/*! \brief Submits a guess.
+  Checks a guess against the word and updates the match.
+  \param pmMatch Match to guess in.
+  \param ccaGuess NUL-terminated guess.
+  \param pgfFeedback Receives feedback when result is GRAccepted or GRLost, may be NULL.
+  \return Result of the guess.
+*/
+enum GuessResults submitGuess(struct Match * pmMatch, const char * ccaGuess, struct GuessFeedback * pgfFeedback);
+/*! \brief Submits a packed guess.
+  Same as 'submitGuess' for callers that already hold packed words, such as strategies.
+  \param pmMatch Match to guess in.
+  \param pwGuess Packed guess.
+  \param pgfFeedback Receives feedback when result is GRAccepted or GRLost, may be NULL.
+  \return Result of the guess.
+*/
+enum GuessResults submitPackedGuess(struct Match * pmMatch, PackedWord pwGuess, struct GuessFeedback * pgfFeedback);
+/*! \brief Get state of match.
+  \param cpmMatch Match to get state of.
+  \return State of match.
+*/
+enum MatchStates getMatchState(const struct Match * cpmMatch);
+/*! \brief Get options of match.
+  \param cpmMatch Match to get options of.
+  \return Combination of 'MatchOptions'.
+*/
+uint32_t getMatchOptions(const struct Match * cpmMatch);
+/*! \brief Get remaining rounds.
+  \param cpmMatch Match to get remaining rounds of.
+  \return Amount of guesses left.
+*/
+uint8_t getRemainingRounds(const struct Match * cpmMatch);
+/*! \brief Get violation.
+  \param cpmMatch Match to get violation of.
+  \return Constraint violated by the last guess rejected with GRConstraintViolated.
+*/
+const struct ConstraintViolation * getViolation(const struct Match * cpmMatch);
+/*! \brief Get tip.
+  \param cpmMatch Match to get tip of.
+  \return NUL-terminated tip, valid as long as the match.
+*/
+const char * getTip(const struct Match * cpmMatch);
+/*! \brief Get candidates.
+  \param cpmMatch Match to get candidates of.
+  \return Tracked candidate set, or NULL when candidates are not tracked.
+*/
+CandidateSet getMatchCandidates(const struct Match * cpmMatch);
+/*! \brief Get word to guess.
+  \param cpmMatch Match to get word of.
+  \return Packed word to guess.
+*/
+PackedWord getMatchWord(const struct Match * cpmMatch);
@@ -0,0 +1,90 @@
+#include "parallel.h"
+
+#include "alloc.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// ----------------- Struct definitions -----------------------------------
+
+/*! \struct ParallelRun
+  \brief Shared state of one 'runParallel' call.
+*/
+struct ParallelRun {
+  parallelTask fnTask;                            //!< Function called per task.
+  void * pContext;                                //!< Context of tasks.
+  uint32_t uiTasks;                               //!< Amount of tasks.
+  uint32_t uiNext;                                //!< Next unclaimed task, claimed atomically.
+};
+
+/*! \struct ParallelWorker
+  \brief Start argument of a worker thread.
+*/
+struct ParallelWorker {
+  struct ParallelRun * pprRun;                    //!< Shared state.
+  uint32_t uiWorker;                              //!< Index of worker.
+  pthread_t tThread;                              //!< Thread of worker.
+};
+
+
+// ----------------- Local Function declarations --------------------------
+
+/*! \brief Work on tasks.
+  Claims and runs tasks until none are left.
+  \param pArgument Worker, as 'struct ParallelWorker *'.
+  \return NULL.
+*/
+static void * workTasks(void * pArgument);
+
+
+// ----------------- Global Function definitions --------------------------
+uint32_t getCoreCount() {
+  long lCores = sysconf(_SC_NPROCESSORS_ONLN);
+  return lCores > 0 ? (uint32_t)lCores : 1;
+}
+
+uint32_t runParallel(parallelTask fnTask, void * pContext, uint32_t uiTasks, uint32_t uiWorkers) {
+  struct ParallelRun prRun = { fnTask, pContext, uiTasks, 0 };
+  if (!uiWorkers) {
+    uiWorkers = getCoreCount();
+  }
+  if (uiWorkers > uiTasks) {
+    uiWorkers = uiTasks ? uiTasks : 1;
+  }
+  struct ParallelWorker * apwWorkers = (struct ParallelWorker *)allocateMemory(NULL, sizeof(struct ParallelWorker) * uiWorkers, ATOther);
+  uint32_t uiStarted = 1;
+  // without memory for workers the caller does all work alone
+  if (apwWorkers) {
+    for (; uiStarted < uiWorkers; ++uiStarted) {
+      apwWorkers[uiStarted].pprRun = &prRun;
+      apwWorkers[uiStarted].uiWorker = uiStarted;
+      if (pthread_create(&apwWorkers[uiStarted].tThread, NULL, &workTasks, &apwWorkers[uiStarted])) {
+	break;
+      }
+    }
+    apwWorkers[0].pprRun = &prRun;
+    apwWorkers[0].uiWorker = 0;
+    workTasks(&apwWorkers[0]);
+  } else {
+    struct ParallelWorker pwCaller = { &prRun, 0 };
+    workTasks(&pwCaller);
+  }
+  uint32_t i;
+  for (i = 1; i < uiStarted; ++i) {
+    pthread_join(apwWorkers[i].tThread, NULL);
+  }
+  freeMemory(NULL, apwWorkers);
+  return uiStarted;
+}
+
+
+// ----------------- Local Function definitions ---------------------------
+static void * workTasks(void * pArgument) {
+  struct ParallelWorker * ppwWorker = (struct ParallelWorker *)pArgument;
+  struct ParallelRun * pprRun = ppwWorker->pprRun;
+  uint32_t uiTask;
+  while ((uiTask = __atomic_fetch_add(&pprRun->uiNext, 1, __ATOMIC_RELAXED)) < pprRun->uiTasks) {
+    pprRun->fnTask(pprRun->pContext, uiTask, ppwWorker->uiWorker);
+  }
+  return NULL;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+/*! \file parallel.h
+  \brief Parallel task execution.
+  Tasks are numbered and claimed in order by worker threads through a shared counter, so faster workers simply take more tasks.
+*/
+
+#include <stdint.h>
+
+typedef void (*parallelTask)(void * pContext, uint32_t uiTask, uint32_t uiWorker); //!< Type of a parallel task, receives task and worker index.
+
+/*! \brief Get amount of cores.
+  Returns the amount of online processors.
+  \return Amount of cores, at least 1.
+*/
+uint32_t getCoreCount();
+/*! \brief Run tasks in parallel.
+  Runs tasks 0 to 'uiTasks' - 1 on a set of workers and blocks until all finished.
+  The calling thread is worker 0, other workers are threads started for this call.
+  \param fnTask Function called once per task.
+  \param pContext Context passed to every call.
+  \param uiTasks Amount of tasks.
+  \param uiWorkers Amount of workers, 0 to use one per core, never more than tasks.
+  \return Amount of workers used, at least 1 even when threads could not be started.
+*/
+uint32_t runParallel(parallelTask fnTask, void * pContext, uint32_t uiTasks, uint32_t uiWorkers);
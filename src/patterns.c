@@ -0,0 +1,242 @@
+#include "patterns.h"
+
+#include "alloc.h"
+#include "parallel.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define ROWS_PER_TASK 16
+#define FILE_MAGIC "SLPATRN"
+#define FILE_VERSION 1
+#define FILE_BYTE_ORDER 0x01020304u
+#define FILE_SUFFIX ".patterns"
+#define FILE_ALIGNMENT 64
+
+// ----------------- Struct definitions -----------------------------------
+
+/*! \struct PatternHeader
+  \brief Header of a pattern matrix file.
+  The header is followed, at offset 'uiDataOffset', by the matrix in row order.
+*/
+struct PatternHeader {
+  char acMagic[8];                                //!< FILE_MAGIC.
+  uint32_t uiVersion;                             //!< FILE_VERSION.
+  uint32_t uiByteOrder;                           //!< FILE_BYTE_ORDER as written by the producing machine.
+  uint64_t uiDictionaryHash;                      //!< Content hash of dictionary the matrix belongs to.
+  uint32_t uiCount;                               //!< Amount of words.
+  uint32_t uiReserved;                            //!< Zero.
+  uint64_t uiDataOffset;                          //!< Offset of matrix from start of file.
+};
+
+/*! \struct _pattern_matrix_
+  \brief Implementation of 'PatternMatrix' type.
+*/
+struct _pattern_matrix_ {
+  const Pattern * pPatterns;                      //!< Matrix in row order, row per guess.
+  uint32_t uiCount;                               //!< Amount of words.
+  uint64_t uiDictionaryHash;                      //!< Content hash of dictionary.
+  void * pMapping;                                //!< Mapping of matrix file, or NULL when matrix is allocated.
+  size_t szMapping;                               //!< Size of mapping.
+};
+
+/*! \struct BuildContext
+  \brief Shared state of a parallel matrix build.
+*/
+struct BuildContext {
+  const PackedWord * cpwWords;                    //!< Words of dictionary.
+  uint32_t uiCount;                               //!< Amount of words.
+  Pattern * pPatterns;                            //!< Matrix being filled.
+};
+
+
+// ----------------- Local Function declarations --------------------------
+
+/*! \brief Build block of rows.
+  Parallel task filling ROWS_PER_TASK rows of the matrix.
+  \param pContext Build context.
+  \param uiTask Index of row block.
+  \param uiWorker Index of worker, unused.
+*/
+static void buildRows(void * pContext, uint32_t uiTask, uint32_t uiWorker);
+/*! \brief Check patterns.
+  Checks that every cell of a loaded matrix is a pattern code, cells index histograms of PATTERN_COUNT entries.
+  \param cpPatterns Cells to check.
+  \param uiCells Amount of cells.
+  \return 1 when all cells are below PATTERN_COUNT, else 0.
+*/
+static int8_t checkPatterns(const Pattern * cpPatterns, uint64_t uiCells);
+
+
+// ----------------- Global Function definitions --------------------------
+PatternMatrix buildPatternMatrix(Dictionary dWords, uint32_t uiThreads) {
+  PatternMatrix pmPatterns = (PatternMatrix)allocateMemory(NULL, sizeof(struct _pattern_matrix_), ATPatternMatrix);
+  if (!pmPatterns) {
+    return NULL;
+  }
+  uint32_t uiCount = getWordCount(dWords);
+  Pattern * pPatterns = (Pattern *)allocateMemory(NULL, sizeof(Pattern) * ((size_t)uiCount * uiCount + 1), ATPatternMatrix);
+  if (!pPatterns) {
+    freeMemory(NULL, pmPatterns);
+    return NULL;
+  }
+  struct BuildContext bcContext = { getWords(dWords), uiCount, pPatterns };
+  runParallel(&buildRows, &bcContext, (uiCount + ROWS_PER_TASK - 1) / ROWS_PER_TASK, uiThreads);
+  pmPatterns->pPatterns = pPatterns;
+  pmPatterns->uiCount = uiCount;
+  pmPatterns->uiDictionaryHash = getDictionaryHash(dWords);
+  pmPatterns->pMapping = NULL;
+  pmPatterns->szMapping = 0;
+  return pmPatterns;
+}
+
+PatternMatrix loadPatternMatrix(const char * path, Dictionary dWords) {
+  int iFile = open(path, O_RDONLY);
+  if (iFile < 0) {
+    return NULL;
+  }
+  struct stat sStat;
+  if (fstat(iFile, &sStat) || (size_t)sStat.st_size < sizeof(struct PatternHeader)) {
+    close(iFile);
+    return NULL;
+  }
+  void * pMapping = mmap(NULL, (size_t)sStat.st_size, PROT_READ, MAP_SHARED, iFile, 0);
+  close(iFile);
+  if (pMapping == MAP_FAILED) {
+    return NULL;
+  }
+  const struct PatternHeader * cpphHeader = (const struct PatternHeader *)pMapping;
+  uint64_t uiSize = (uint64_t)sStat.st_size;
+  uint64_t uiCells = (uint64_t)cpphHeader->uiCount * cpphHeader->uiCount;
+  int8_t iValid = !memcmp(cpphHeader->acMagic, FILE_MAGIC, sizeof(cpphHeader->acMagic))
+    && cpphHeader->uiVersion == FILE_VERSION
+    && cpphHeader->uiByteOrder == FILE_BYTE_ORDER
+    && cpphHeader->uiCount == getWordCount(dWords)
+    && cpphHeader->uiDataOffset <= uiSize
+    && uiSize - cpphHeader->uiDataOffset >= uiCells
+    && cpphHeader->uiDictionaryHash == getDictionaryHash(dWords)
+    && checkPatterns((const Pattern *)((const char *)pMapping + cpphHeader->uiDataOffset), uiCells);
+  PatternMatrix pmPatterns = iValid ? (PatternMatrix)allocateMemory(NULL, sizeof(struct _pattern_matrix_), ATPatternMatrix) : NULL;
+  if (!pmPatterns) {
+    munmap(pMapping, (size_t)sStat.st_size);
+    return NULL;
+  }
+  pmPatterns->pPatterns = (const Pattern *)((const char *)pMapping + cpphHeader->uiDataOffset);
+  pmPatterns->uiCount = cpphHeader->uiCount;
+  pmPatterns->uiDictionaryHash = cpphHeader->uiDictionaryHash;
+  pmPatterns->pMapping = pMapping;
+  pmPatterns->szMapping = (size_t)sStat.st_size;
+  return pmPatterns;
+}
+
+PatternMatrix openPatternMatrix(const char * caListPath, Dictionary dWords, uint32_t uiThreads) {
+  char * caCachePath = (char *)allocateMemory(NULL, strlen(caListPath) + sizeof(FILE_SUFFIX), ATOther);
+  if (!caCachePath) {
+    return NULL;
+  }
+  strcpy(caCachePath, caListPath);
+  strcat(caCachePath, FILE_SUFFIX);
+  PatternMatrix pmPatterns = loadPatternMatrix(caCachePath, dWords);
+  if (!pmPatterns) {
+    pmPatterns = buildPatternMatrix(dWords, uiThreads);
+    // a cache that can not be written only costs the next run a rebuild
+    if (pmPatterns && !writePatternMatrix(pmPatterns, caCachePath)) {
+      printf("Warning: Failed to write pattern cache '%s'.\n", caCachePath);
+    }
+  }
+  freeMemory(NULL, caCachePath);
+  return pmPatterns;
+}
+
+int8_t writePatternMatrix(PatternMatrix pmPatterns, const char * path) {
+  if (!pmPatterns) {
+    return 0;
+  }
+  struct PatternHeader phHeader;
+  memset(&phHeader, 0, sizeof(phHeader));
+  memcpy(phHeader.acMagic, FILE_MAGIC, sizeof(phHeader.acMagic));
+  phHeader.uiVersion = FILE_VERSION;
+  phHeader.uiByteOrder = FILE_BYTE_ORDER;
+  phHeader.uiDictionaryHash = pmPatterns->uiDictionaryHash;
+  phHeader.uiCount = pmPatterns->uiCount;
+  phHeader.uiDataOffset = FILE_ALIGNMENT;
+  // other processes may have the old matrix mapped, so it is replaced by a rename instead of being rewritten in place
+  char * caTempPath = (char *)allocateMemory(NULL, strlen(path) + sizeof(".tmp"), ATOther);
+  FILE * file = NULL;
+  if (caTempPath) {
+    strcpy(caTempPath, path);
+    strcat(caTempPath, ".tmp");
+    file = fopen(caTempPath, "wb");
+  }
+  if (!file) {
+    freeMemory(NULL, caTempPath);
+    return 0;
+  }
+  size_t szCells = (size_t)pmPatterns->uiCount * pmPatterns->uiCount;
+  static const char cacPadding[FILE_ALIGNMENT - sizeof(struct PatternHeader)];
+  int8_t iResult = fwrite(&phHeader, sizeof(phHeader), 1, file) == 1
+    && fwrite(cacPadding, sizeof(cacPadding), 1, file) == 1
+    && fwrite(pmPatterns->pPatterns, sizeof(Pattern), szCells, file) == szCells;
+  if (fclose(file)) {
+    iResult = 0;
+  }
+  if (iResult && rename(caTempPath, path)) {
+    iResult = 0;
+  }
+  if (!iResult) {
+    unlink(caTempPath);
+  }
+  freeMemory(NULL, caTempPath);
+  return iResult;
+}
+
+void destroyPatternMatrix(PatternMatrix pmPatterns) {
+  if (!pmPatterns) {
+    return;
+  }
+  if (pmPatterns->pMapping) {
+    munmap(pmPatterns->pMapping, pmPatterns->szMapping);
+  } else {
+    freeMemory(NULL, (void *)pmPatterns->pPatterns);
+  }
+  freeMemory(NULL, pmPatterns);
+}
+
+uint32_t getPatternMatrixSize(PatternMatrix pmPatterns) {
+  if (!pmPatterns) {
+    return 0;
+  }
+  return pmPatterns->uiCount;
+}
+
+const Pattern * getPatternRow(PatternMatrix pmPatterns, uint32_t uiGuess) {
+  if (!pmPatterns || uiGuess >= pmPatterns->uiCount) {
+    return NULL;
+  }
+  return pmPatterns->pPatterns + (size_t)uiGuess * pmPatterns->uiCount;
+}
+
+
+// ----------------- Local Function definitions ---------------------------
+static void buildRows(void * pContext, uint32_t uiTask, uint32_t uiWorker) {
+  struct BuildContext * pbcContext = (struct BuildContext *)pContext;
+  uint32_t uiRow = uiTask * ROWS_PER_TASK;
+  uint32_t uiEnd = uiRow + ROWS_PER_TASK < pbcContext->uiCount ? uiRow + ROWS_PER_TASK : pbcContext->uiCount;
+  for (; uiRow < uiEnd; ++uiRow) {
+    computePatterns(pbcContext->cpwWords[uiRow], pbcContext->cpwWords, pbcContext->uiCount, pbcContext->pPatterns + (size_t)uiRow * pbcContext->uiCount);
+  }
+}
+
+static int8_t checkPatterns(const Pattern * cpPatterns, uint64_t uiCells) {
+  Pattern pMax = 0;
+  uint64_t i;
+  // a branch free maximum is vectorized, so the scan costs about as much as reading the file
+  for (i = 0; i < uiCells; ++i) {
+    pMax = cpPatterns[i] > pMax ? cpPatterns[i] : pMax;
+  }
+  return pMax < PATTERN_COUNT;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+/*! \file patterns.h
+  \brief Precomputed guess by answer pattern matrix.
+  Holds the pattern code of every pair of dictionary words, one byte per pair, row per guess.
+  Matrices are cached on disk next to their word list and mapped on later runs.
+*/
+
+#include "dictionary.h"
+#include "feedback.h"
+#include <stdint.h>
+
+typedef struct _pattern_matrix_ * PatternMatrix;  //!< Pattern matrix type, read-only after creation.
+
+/*! \brief Builds a pattern matrix.
+  Fills the matrix of all pairs of dictionary words, blocks of rows are spread over worker threads.
+  Each matrix created by this function must be destroyed by 'destroyPatternMatrix(PatternMatrix)' to avoid memory leaks.
+  \param dWords Dictionary to build matrix for, must outlive the matrix.
+  \param uiThreads Amount of threads, 0 to use one per core.
+  \return Created matrix or NULL when memory could not be allocated.
+*/
+PatternMatrix buildPatternMatrix(Dictionary dWords, uint32_t uiThreads);
+/*! \brief Loads a pattern matrix.
+  Maps a matrix file written by 'writePatternMatrix' and uses it in place.
+  Every cell is checked to be a pattern code, so a stale or corrupt file is rejected instead of trusted.
+  \param path Relative or absolute path to matrix file.
+  \param dWords Dictionary the matrix must belong to, checked through its content hash.
+  \return Loaded matrix or NULL when file is missing, invalid, holds a cell of PATTERN_COUNT or more or belongs to another dictionary.
+*/
+PatternMatrix loadPatternMatrix(const char * path, Dictionary dWords);
+/*! \brief Loads or builds a pattern matrix.
+  Loads the cache of a word list when it is valid and matches the dictionary, otherwise builds the matrix and rewrites the cache.
+  The cache lives next to the word list, with '.patterns' appended to its path.
+  \param caListPath Path to word list the dictionary was loaded from.
+  \param dWords Dictionary to get matrix for.
+  \param uiThreads Amount of threads used when building, 0 to use one per core.
+  \return Matrix or NULL when it could neither be loaded nor built.
+*/
+PatternMatrix openPatternMatrix(const char * caListPath, Dictionary dWords, uint32_t uiThreads);
+/*! \brief Writes a pattern matrix.
+  Writes a matrix and the content hash of its dictionary to a file that 'loadPatternMatrix' can map.
+  The matrix is written to '<path>.tmp' first and renamed over the file, so mappings of a previous file stay intact.
+  \param pmPatterns Matrix to write.
+  \param path Relative or absolute path to output file.
+  \return 1 on success, else 0.
+*/
+int8_t writePatternMatrix(PatternMatrix pmPatterns, const char * path);
+/*! \brief Destroys a pattern matrix.
+  Frees or unmaps a matrix.
+  \param pmPatterns Matrix to destroy.
+*/
+void destroyPatternMatrix(PatternMatrix pmPatterns);
+
+/*! \brief Get size of matrix.
+  Returns the amount of rows, which equals the amount of columns and of dictionary words.
+  \param pmPatterns Matrix to get size of.
+  \return Amount of words.
+*/
+uint32_t getPatternMatrixSize(PatternMatrix pmPatterns);
+/*! \brief Get row of guess.
+  Returns the patterns of one guess against every answer, indexed like the dictionary.
+  \param pmPatterns Matrix to get row from.
+  \param uiGuess Dictionary index of guess.
+  \return Row of 'getPatternMatrixSize(PatternMatrix)' patterns, or NULL when index is out of bounds.
+*/
+const Pattern * getPatternRow(PatternMatrix pmPatterns, uint32_t uiGuess);
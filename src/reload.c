@@ -0,0 +1,237 @@
+#include "reload.h"
+
+#include "alloc.h"
+#include <errno.h>
+#include <limits.h>
+#include <libgen.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+// ----------------- Struct definitions -----------------------------------
+
+/*! \struct _dictionary_snapshot_
+  \brief Implementation of 'DictionarySnapshot' type.
+*/
+struct _dictionary_snapshot_ {
+  Dictionary dWords;                              //!< Published dictionary.
+  uint32_t uiVersion;                             //!< Publication number.
+  uint32_t uiReferences;                          //!< References of readers and, while current, of the source.
+};
+
+/*! \struct _dictionary_source_
+  \brief Implementation of 'DictionarySource' type.
+  Readers announce themselves in one of two counters, chosen by the parity of 'uiEpoch', while they turn the current pointer into a reference.
+  A publisher swaps the pointer, flips the epoch and waits for the counter of the old epoch to drain before dropping the reference of the source.
+  Readers arriving after the flip use the other counter, so a steady stream of readers never stalls a publisher.
+*/
+struct _dictionary_source_ {
+  struct _dictionary_snapshot_ * psCurrent;       //!< Current snapshot, accessed atomically.
+  uint32_t uiEpoch;                               //!< Grace period counter, accessed atomically.
+  uint32_t auiAcquiring[2];                       //!< Readers between loading 'psCurrent' and referencing it, per epoch parity.
+  pthread_mutex_t mPublish;                       //!< Serializes publishers.
+  pthread_t tWatcher;                             //!< Thread reloading the word list.
+  int8_t iWatching;                               //!< Watcher thread is running.
+  int iStop;                                      //!< Event file waking the watcher to stop.
+  int iNotify;                                    //!< Inotify instance watching the directory of the word list.
+  char * caPath;                                  //!< Watched word list.
+  dictionaryLoader fnLoad;                        //!< Loader of watched word list.
+};
+
+
+// ----------------- Local Function declarations --------------------------
+
+/*! \brief Create snapshot.
+  \param dWords Dictionary of snapshot.
+  \param uiVersion Version of snapshot.
+  \return Snapshot with one reference, or NULL when memory could not be allocated.
+*/
+static struct _dictionary_snapshot_ * createSnapshot(Dictionary dWords, uint32_t uiVersion);
+/*! \brief Watch word list.
+  Thread function waiting for changes of the word list and reloading it.
+  \param pArgument Source, as 'DictionarySource'.
+  \return NULL.
+*/
+static void * watchChanges(void * pArgument);
+
+
+// ----------------- Global Function definitions --------------------------
+DictionarySource createDictionarySource(Dictionary dWords) {
+  DictionarySource dsSource = (DictionarySource)allocateZeroedMemory(NULL, sizeof(struct _dictionary_source_), ATDictionaryWords);
+  if (!dsSource || !(dsSource->psCurrent = createSnapshot(dWords, 0))) {
+    freeMemory(NULL, dsSource);
+    destroyDictionary(dWords);
+    return NULL;
+  }
+  pthread_mutex_init(&dsSource->mPublish, NULL);
+  dsSource->iStop = -1;
+  dsSource->iNotify = -1;
+  return dsSource;
+}
+
+void destroyDictionarySource(DictionarySource dsSource) {
+  if (!dsSource) {
+    return;
+  }
+  if (dsSource->iWatching) {
+    uint64_t uiWake = 1;
+    if (write(dsSource->iStop, &uiWake, sizeof(uiWake)) == sizeof(uiWake)) {
+      pthread_join(dsSource->tWatcher, NULL);
+    } else {
+      pthread_cancel(dsSource->tWatcher);
+      pthread_join(dsSource->tWatcher, NULL);
+    }
+  }
+  if (dsSource->iStop >= 0) {
+    close(dsSource->iStop);
+  }
+  if (dsSource->iNotify >= 0) {
+    close(dsSource->iNotify);
+  }
+  releaseSnapshot(dsSource->psCurrent);
+  pthread_mutex_destroy(&dsSource->mPublish);
+  free(dsSource->caPath);
+  freeMemory(NULL, dsSource);
+}
+
+int8_t publishDictionary(DictionarySource dsSource, Dictionary dWords) {
+  pthread_mutex_lock(&dsSource->mPublish);
+  struct _dictionary_snapshot_ * psNew = createSnapshot(dWords, dsSource->psCurrent->uiVersion + 1);
+  if (!psNew) {
+    pthread_mutex_unlock(&dsSource->mPublish);
+    destroyDictionary(dWords);
+    return 0;
+  }
+  struct _dictionary_snapshot_ * psOld = __atomic_exchange_n(&dsSource->psCurrent, psNew, __ATOMIC_SEQ_CST);
+  uint32_t uiOldEpoch = __atomic_fetch_add(&dsSource->uiEpoch, 1, __ATOMIC_SEQ_CST);
+  // readers registered in the old epoch may have loaded the old pointer but not yet referenced it
+  while (__atomic_load_n(&dsSource->auiAcquiring[uiOldEpoch & 1], __ATOMIC_SEQ_CST)) {
+    sched_yield();
+  }
+  pthread_mutex_unlock(&dsSource->mPublish);
+  releaseSnapshot(psOld);
+  return 1;
+}
+
+DictionarySnapshot acquireSnapshot(DictionarySource dsSource) {
+  uint32_t uiEpoch;
+  // registering only counts when the epoch did not move meanwhile, else a publisher may already wait on the other counter
+  for (;;) {
+    uiEpoch = __atomic_load_n(&dsSource->uiEpoch, __ATOMIC_SEQ_CST);
+    __atomic_fetch_add(&dsSource->auiAcquiring[uiEpoch & 1], 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&dsSource->uiEpoch, __ATOMIC_SEQ_CST) == uiEpoch) {
+      break;
+    }
+    __atomic_fetch_sub(&dsSource->auiAcquiring[uiEpoch & 1], 1, __ATOMIC_SEQ_CST);
+  }
+  struct _dictionary_snapshot_ * psSnapshot = __atomic_load_n(&dsSource->psCurrent, __ATOMIC_SEQ_CST);
+  __atomic_fetch_add(&psSnapshot->uiReferences, 1, __ATOMIC_SEQ_CST);
+  __atomic_fetch_sub(&dsSource->auiAcquiring[uiEpoch & 1], 1, __ATOMIC_SEQ_CST);
+  return psSnapshot;
+}
+
+void releaseSnapshot(DictionarySnapshot dsSnapshot) {
+  if (dsSnapshot && __atomic_sub_fetch(&dsSnapshot->uiReferences, 1, __ATOMIC_ACQ_REL) == 0) {
+    destroyDictionary(dsSnapshot->dWords);
+    freeMemory(NULL, dsSnapshot);
+  }
+}
+
+Dictionary getSnapshotDictionary(DictionarySnapshot dsSnapshot) {
+  return dsSnapshot->dWords;
+}
+
+uint32_t getSnapshotVersion(DictionarySnapshot dsSnapshot) {
+  return dsSnapshot->uiVersion;
+}
+
+int8_t watchWordList(DictionarySource dsSource, const char * ccaPath, dictionaryLoader fnLoad) {
+  if (dsSource->iWatching) {
+    return 0;
+  }
+  dsSource->caPath = strdup(ccaPath);
+  dsSource->fnLoad = fnLoad;
+  if (dsSource->iStop < 0) {
+    dsSource->iStop = eventfd(0, EFD_CLOEXEC);
+  }
+  if (dsSource->iNotify < 0) {
+    dsSource->iNotify = inotify_init1(IN_CLOEXEC);
+  }
+  // the watch is in place before returning, so no change made afterwards is missed while the thread starts
+  char * caDirectoryPath = dsSource->caPath ? strdup(dsSource->caPath) : NULL;
+  int8_t iWatched = caDirectoryPath && dsSource->iNotify >= 0
+    && inotify_add_watch(dsSource->iNotify, dirname(caDirectoryPath), IN_CLOSE_WRITE | IN_MOVED_TO) >= 0;
+  free(caDirectoryPath);
+  if (!iWatched || dsSource->iStop < 0 || pthread_create(&dsSource->tWatcher, NULL, &watchChanges, dsSource)) {
+    free(dsSource->caPath);
+    dsSource->caPath = NULL;
+    return 0;
+  }
+  dsSource->iWatching = 1;
+  return 1;
+}
+
+
+// ----------------- Local Function definitions ---------------------------
+static struct _dictionary_snapshot_ * createSnapshot(Dictionary dWords, uint32_t uiVersion) {
+  struct _dictionary_snapshot_ * psSnapshot = (struct _dictionary_snapshot_ *)allocateMemory(NULL, sizeof(struct _dictionary_snapshot_), ATDictionaryWords);
+  if (!psSnapshot) {
+    return NULL;
+  }
+  psSnapshot->dWords = dWords;
+  psSnapshot->uiVersion = uiVersion;
+  psSnapshot->uiReferences = 1;
+  return psSnapshot;
+}
+
+static void * watchChanges(void * pArgument) {
+  DictionarySource dsSource = (DictionarySource)pArgument;
+  char * caNamePath = strdup(dsSource->caPath);
+  if (!caNamePath) {
+    printf("Warning: Failed to watch '%s' for changes.\n", dsSource->caPath);
+    return NULL;
+  }
+  // editors often replace a file by renaming a new one over it, so the directory is watched instead of the file,
+  // a list written in place is reloaded as well, which is safe as long as the loader copies the file instead of mapping it
+  const char * ccaName = basename(caNamePath);
+  struct pollfd apfWait[2] = { { dsSource->iNotify, POLLIN, 0 }, { dsSource->iStop, POLLIN, 0 } };
+  char caEvents[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+  for (;;) {
+    if (poll(apfWait, 2, -1) < 0 && errno != EINTR) {
+      break;
+    }
+    if (apfWait[1].revents) {
+      break;
+    }
+    if (!apfWait[0].revents) {
+      continue;
+    }
+    ssize_t sRead = read(dsSource->iNotify, caEvents, sizeof(caEvents));
+    int8_t iChanged = 0;
+    ssize_t sOffset = 0;
+    while (sOffset < sRead) {
+      const struct inotify_event * cpieEvent = (const struct inotify_event *)(caEvents + sOffset);
+      iChanged |= cpieEvent->len && !strcmp(cpieEvent->name, ccaName);
+      sOffset += sizeof(struct inotify_event) + cpieEvent->len;
+    }
+    if (!iChanged) {
+      continue;
+    }
+    Dictionary dWords = dsSource->fnLoad(dsSource->caPath);
+    if (!dWords || !getWordCount(dWords)) {
+      printf("Warning: Reloading '%s' failed, keeping current word list.\n", dsSource->caPath);
+      destroyDictionary(dWords);
+    } else if (publishDictionary(dsSource, dWords)) {
+      printf("Reloaded '%s' with %u words.\n", dsSource->caPath, getWordCount(dWords));
+    }
+    fflush(stdout);
+  }
+  free(caNamePath);
+  return NULL;
+}
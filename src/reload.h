@@ -0,0 +1,69 @@
+#pragma once
+
+/*! \file reload.h
+  \brief Hot reload of dictionaries.
+  A dictionary source publishes immutable, reference counted dictionary snapshots.
+  Readers acquire the current snapshot without locks and keep using it until they release it, even after a newer one was published.
+  A snapshot is freed once it is no longer current and its last reader released it.
+  A source can watch its word list with inotify and publish a freshly loaded dictionary whenever the file is rewritten or replaced.
+*/
+
+#include "dictionary.h"
+#include <stdint.h>
+
+typedef struct _dictionary_source_ * DictionarySource; //!< Publisher of dictionary snapshots.
+typedef struct _dictionary_snapshot_ * DictionarySnapshot; //!< Reference to a published dictionary.
+typedef Dictionary (*dictionaryLoader)(const char * path); //!< Loads a dictionary from a word list, returns NULL on failure.
+
+/*! \brief Creates a dictionary source.
+  Each source created by this function must be destroyed by 'destroyDictionarySource(DictionarySource)' to avoid memory leaks.
+  \param dWords Initial dictionary, owned by the source from now on.
+  \return Created source or NULL when memory could not be allocated, 'dWords' is destroyed then.
+*/
+DictionarySource createDictionarySource(Dictionary dWords);
+/*! \brief Destroys a dictionary source.
+  Stops watching and drops the current snapshot, snapshots still acquired stay valid until they are released.
+  \param dsSource Source to destroy.
+*/
+void destroyDictionarySource(DictionarySource dsSource);
+/*! \brief Publish dictionary.
+  Makes a dictionary the current snapshot, readers acquiring later get the new one.
+  Blocks until no reader can still be acquiring the previous snapshot, readers holding it are not waited for.
+  \param dsSource Source to publish in.
+  \param dWords Dictionary to publish, owned by the source from now on.
+  \return 1 on success, 0 when memory could not be allocated, 'dWords' is destroyed then.
+*/
+int8_t publishDictionary(DictionarySource dsSource, Dictionary dWords);
+/*! \brief Acquire snapshot.
+  Takes a reference to the current snapshot without taking a lock.
+  Each snapshot acquired by this function must be released by 'releaseSnapshot(DictionarySnapshot)'.
+  \param dsSource Source to acquire from.
+  \return Current snapshot.
+*/
+DictionarySnapshot acquireSnapshot(DictionarySource dsSource);
+/*! \brief Release snapshot.
+  Drops a reference, the last reference of a snapshot that is no longer current frees it.
+  \param dsSnapshot Snapshot to release, may be NULL.
+*/
+void releaseSnapshot(DictionarySnapshot dsSnapshot);
+/*! \brief Get dictionary of snapshot.
+  \param dsSnapshot Snapshot.
+  \return Dictionary, valid until snapshot is released.
+*/
+Dictionary getSnapshotDictionary(DictionarySnapshot dsSnapshot);
+/*! \brief Get version of snapshot.
+  \param dsSnapshot Snapshot.
+  \return 0 for the initial dictionary, incremented by every publication.
+*/
+uint32_t getSnapshotVersion(DictionarySnapshot dsSnapshot);
+/*! \brief Watch word list.
+  Starts a background thread that reloads a word list whenever it is written and closed or replaced by a rename, and publishes the result.
+  Failed or empty loads are reported and leave the current snapshot in place.
+  As the list may be rewritten in place while snapshots of it are in use, loaded dictionaries must not reference the file,
+  binary dictionaries are loaded with DOCopied instead of being mapped.
+  \param dsSource Source to publish in.
+  \param ccaPath Path to word list.
+  \param fnLoad Function loading the list, only called from the background thread.
+  \return 1 on success, 0 when watching could not be set up or is already running.
+*/
+int8_t watchWordList(DictionarySource dsSource, const char * ccaPath, dictionaryLoader fnLoad);
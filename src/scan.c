@@ -0,0 +1,110 @@
+#include "scan.h"
+
+#include <stdint.h>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#define SCAN_X86
+#endif
+
+/*! \brief Signature of scanner implementations. */
+typedef size_t (*scanFunction)(const char *, size_t);
+
+
+// ----------------- Local Variables --------------------------------------
+static scanFunction _fnScanLetters_ = NULL;      //!< Selected implementation, resolved on first use.
+
+
+// ----------------- Local Function declarations --------------------------
+
+/*! \brief Is letter.
+  Returns a value indicating byte is a letter, without branching on the character range.
+  \param cChar Byte to check.
+  \return 1 when letter, else 0.
+*/
+static inline int8_t isLetter(char cChar);
+/*! \brief Select scanner.
+  Selects the fastest scanner supported by the CPU.
+  \return Selected scanner.
+*/
+static scanFunction selectScanner();
+
+
+// ----------------- Global Function definitions --------------------------
+size_t scanLetters(const char * ccaData, size_t szLength) {
+  scanFunction fnScan = __atomic_load_n(&_fnScanLetters_, __ATOMIC_RELAXED);
+  // every thread resolves to the same implementation, so a race on first use is harmless
+  if (!fnScan) {
+    fnScan = selectScanner();
+    __atomic_store_n(&_fnScanLetters_, fnScan, __ATOMIC_RELAXED);
+  }
+  return fnScan(ccaData, szLength);
+}
+
+size_t scanLettersScalar(const char * ccaData, size_t szLength) {
+  size_t i;
+  for (i = 0; i < szLength && isLetter(ccaData[i]); ++i);
+  return i;
+}
+
+#ifdef SCAN_X86
+size_t scanLettersSSE2(const char * ccaData, size_t szLength) {
+  // folding to lower case and shifting 'a' to -128 turns the letter test into one signed compare
+  const __m128i mCase = _mm_set1_epi8(0x20);
+  const __m128i mShift = _mm_set1_epi8((char)(0x80 - 'a'));
+  const __m128i mLimit = _mm_set1_epi8((char)(-128 + 26));
+  size_t i;
+  for (i = 0; i + 16 <= szLength; i += 16) {
+    __m128i mData = _mm_loadu_si128((const __m128i *)(ccaData + i));
+    __m128i mShifted = _mm_add_epi8(_mm_or_si128(mData, mCase), mShift);
+    uint32_t uiMask = (uint32_t)_mm_movemask_epi8(_mm_cmplt_epi8(mShifted, mLimit));
+    if (uiMask != 0xFFFF) {
+      return i + (size_t)__builtin_ctz(~uiMask);
+    }
+  }
+  return i + scanLettersScalar(ccaData + i, szLength - i);
+}
+
+__attribute__((target("avx2")))
+size_t scanLettersAVX2(const char * ccaData, size_t szLength) {
+  // same compare as the SSE2 scanner, AVX2 only has a signed greater-than so operands are swapped
+  const __m256i mCase = _mm256_set1_epi8(0x20);
+  const __m256i mShift = _mm256_set1_epi8((char)(0x80 - 'a'));
+  const __m256i mLimit = _mm256_set1_epi8((char)(-128 + 26));
+  size_t i;
+  for (i = 0; i + 32 <= szLength; i += 32) {
+    __m256i mData = _mm256_loadu_si256((const __m256i *)(ccaData + i));
+    __m256i mShifted = _mm256_add_epi8(_mm256_or_si256(mData, mCase), mShift);
+    uint32_t uiMask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpgt_epi8(mLimit, mShifted));
+    if (uiMask != 0xFFFFFFFF) {
+      return i + (size_t)__builtin_ctz(~uiMask);
+    }
+  }
+  return i + scanLettersSSE2(ccaData + i, szLength - i);
+}
+#else
+size_t scanLettersSSE2(const char * ccaData, size_t szLength) {
+  return scanLettersScalar(ccaData, szLength);
+}
+
+size_t scanLettersAVX2(const char * ccaData, size_t szLength) {
+  return scanLettersScalar(ccaData, szLength);
+}
+#endif
+
+
+// ----------------- Local Function definitions ---------------------------
+static inline int8_t isLetter(char cChar) {
+  return (uint8_t)((cChar | 0x20) - 'a') < 26;
+}
+
+static scanFunction selectScanner() {
+#ifdef SCAN_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return &scanLettersAVX2;
+  }
+  return &scanLettersSSE2;
+#else
+  return &scanLettersScalar;
+#endif
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+/*! \file scan.h
+  \brief Character class scanning used by the tokenizer.
+  Scanners are implemented for SSE2 and AVX2, the best one supported by the CPU is selected at run-time.
+  A scalar implementation is always available and serves as reference for the vectorized ones.
+*/
+
+#include <stddef.h>
+
+/*! \brief Length of letter run.
+  Returns the amount of leading bytes in a buffer that are letters (a-z or A-Z).
+  Uses the fastest implementation supported by the CPU.
+  \param ccaData Buffer to scan.
+  \param szLength Amount of bytes in buffer.
+  \return Index of first byte that is not a letter, or 'szLength' when all bytes are letters.
+*/
+size_t scanLetters(const char * ccaData, size_t szLength);
+/*! \brief Length of letter run, scalar implementation.
+  Same as 'scanLetters', but checks one byte at a time.
+  \param ccaData Buffer to scan.
+  \param szLength Amount of bytes in buffer.
+  \return Index of first byte that is not a letter, or 'szLength' when all bytes are letters.
+*/
+size_t scanLettersScalar(const char * ccaData, size_t szLength);
+/*! \brief Length of letter run, SSE2 implementation.
+  Same as 'scanLetters', but checks 16 bytes at a time.
+  Falls back to the scalar implementation when not compiled for x86.
+  \param ccaData Buffer to scan.
+  \param szLength Amount of bytes in buffer.
+  \return Index of first byte that is not a letter, or 'szLength' when all bytes are letters.
+*/
+size_t scanLettersSSE2(const char * ccaData, size_t szLength);
+/*! \brief Length of letter run, AVX2 implementation.
+  Same as 'scanLetters', but checks 32 bytes at a time.
+  Must only be called when the CPU supports AVX2, falls back to the scalar implementation when not compiled for x86.
+  \param ccaData Buffer to scan.
+  \param szLength Amount of bytes in buffer.
+  \return Index of first byte that is not a letter, or 'szLength' when all bytes are letters.
+*/
+size_t scanLettersAVX2(const char * ccaData, size_t szLength);
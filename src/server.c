@@ -0,0 +1,505 @@
+#define _GNU_SOURCE
+
+#include "server.h"
+
+#include "alloc.h"
+#include "match.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SERVER_BACKLOG 1024
+#define SERVER_EVENTS 256
+#define SESSION_LINE 64
+#define SESSION_OUTPUT 512
+#define RESPONSE_MAX 64
+
+// ----------------- Struct definitions -----------------------------------
+
+/*! \struct Session
+  \brief Connection of one client.
+*/
+struct Session {
+  int iSocket;                                    //!< Socket of connection.
+  struct Match mMatch;                            //!< Current match.
+  DictionarySnapshot dsSnapshot;                  //!< Dictionary of current match, or NULL before the first match.
+  int8_t iInMatch;                                //!< A match was started.
+  int8_t iClosing;                                //!< Close once output is sent.
+  int8_t iDiscarding;                             //!< Skipping the rest of an overlong line.
+  int8_t iWriting;                                //!< Waiting for socket to accept output.
+  char caInput[SESSION_LINE];                     //!< Received bytes not yet handled.
+  uint32_t uiInput;                               //!< Amount of bytes in 'caInput'.
+  char caOutput[SESSION_OUTPUT];                  //!< Responses not yet sent.
+  uint32_t uiOutput;                              //!< Amount of bytes in 'caOutput'.
+  uint32_t uiSent;                                //!< Amount of bytes of 'caOutput' sent.
+  struct Session * psPrevious;                    //!< Previous open session.
+  struct Session * psNext;                        //!< Next open session.
+};
+
+/*! \struct Server
+  \brief State of a running server.
+*/
+struct Server {
+  DictionarySource dsSource;                      //!< Source of dictionaries of new matches.
+  int iEpoll;                                     //!< Event queue.
+  int iListener;                                  //!< Listening socket.
+  int iReserve;                                   //!< Spare descriptor given up to accept and drop a connection when out of descriptors, or -1.
+  int8_t iListenerPaused;                         //!< Listener is left out of the event queue until a session closes.
+  struct Session * psSessions;                    //!< Open sessions.
+  uint64_t uiRandom;                              //!< State of random generator picking words.
+  uint64_t uiConnections;                         //!< Amount of accepted connections.
+  uint64_t uiRequests;                            //!< Amount of handled requests.
+};
+
+
+// ----------------- Local Variables --------------------------------------
+static volatile sig_atomic_t stopRequested = 0;   //!< Set by signal handler to end event loop.
+
+
+// ----------------- Local Function declarations --------------------------
+
+/*! \brief Handle stop signal.
+  \param iSignal Received signal.
+*/
+static void requestStop(int iSignal);
+/*! \brief Accept connections.
+  Accepts all pending connections and registers a session for each.
+  Out of descriptors, the pending connection is accepted on the reserve descriptor and dropped,
+  without a reserve the listener is paused, as a level-triggered listener would otherwise wake the loop forever.
+  \param psServer Server.
+*/
+static void acceptSessions(struct Server * psServer);
+/*! \brief Set listener events.
+  Adds the listener to the event queue or leaves it out.
+  \param psServer Server.
+  \param iPaused 1 to leave the listener out, 0 to wait for connections again.
+*/
+static void pauseListener(struct Server * psServer, int8_t iPaused);
+/*! \brief Check socket file.
+  \param ccaPath Path to check.
+  \param psStat Receives status of the file at path.
+  \return 1 when the path is a socket, 0 when it is missing or something else.
+*/
+static int8_t isSocketFile(const char * ccaPath, struct stat * psStat);
+/*! \brief Close session.
+  Unregisters and frees a session.
+  \param psServer Server.
+  \param psSession Session to close.
+*/
+static void closeSession(struct Server * psServer, struct Session * psSession);
+/*! \brief Read from session.
+  Receives available bytes and handles every complete line, until the socket is drained or the client stops taking responses.
+  \param psServer Server.
+  \param psSession Session to read from.
+*/
+static void readSession(struct Server * psServer, struct Session * psSession);
+/*! \brief Handle buffered lines.
+  Handles complete lines as long as a response fits into the output buffer.
+  \param psServer Server.
+  \param psSession Session to handle lines of.
+*/
+static void handleLines(struct Server * psServer, struct Session * psSession);
+/*! \brief Handle request.
+  Handles one request line and queues its response.
+  \param psServer Server.
+  \param psSession Session of request.
+  \param caLine NUL-terminated request without line end.
+*/
+static void handleRequest(struct Server * psServer, struct Session * psSession, char * caLine);
+/*! \brief Handle guess.
+  Submits a guess and queues the response.
+  \param psSession Session of guess.
+  \param ccaWord Guessed word.
+*/
+static void handleGuess(struct Session * psSession, const char * ccaWord);
+/*! \brief Queue response.
+  Appends a formatted line to the output of a session.
+  \param psSession Session to respond to.
+  \param ccaFormat printf format of line, without line end.
+*/
+static void respond(struct Session * psSession, const char * ccaFormat, ...) __attribute__((format(printf, 2, 3)));
+/*! \brief Flush session.
+  Sends queued output and waits for the socket to become writable when it does not take all of it.
+  \param psServer Server.
+  \param psSession Session to flush.
+  \return 1 while session is open, 0 when it was closed.
+*/
+static int8_t flushSession(struct Server * psServer, struct Session * psSession);
+/*! \brief Next random number.
+  Advances a xorshift64* generator.
+  \param puiState Generator state, never 0.
+  \return Random number.
+*/
+static inline uint64_t nextRandom(uint64_t * puiState);
+
+
+// ----------------- Global Function definitions --------------------------
+int8_t runServer(DictionarySource dsSource, const char * ccaPath) {
+  struct sockaddr_un saAddress;
+  if (strlen(ccaPath) >= sizeof(saAddress.sun_path)) {
+    return 0;
+  }
+  memset(&saAddress, 0, sizeof(saAddress));
+  saAddress.sun_family = AF_UNIX;
+  strcpy(saAddress.sun_path, ccaPath);
+  // only a socket left behind by an earlier server is replaced, any other file at the path is kept
+  struct stat sSocket;
+  if (isSocketFile(ccaPath, &sSocket)) {
+    unlink(ccaPath);
+  } else if (errno != ENOENT) {
+    printf("Error: '%s' exists and is not a socket.\n", ccaPath);
+    return 0;
+  }
+  int iListener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (iListener < 0) {
+    return 0;
+  }
+  struct Server sServer = { dsSource, -1, iListener, open("/dev/null", O_RDONLY | O_CLOEXEC), 0, NULL, (uint64_t)time(NULL) * 2 + 1, 0, 0 };
+  struct epoll_event eeEvent = { EPOLLIN, { .ptr = NULL } };
+  if (bind(iListener, (struct sockaddr *)&saAddress, sizeof(saAddress)) || !isSocketFile(ccaPath, &sSocket) || listen(iListener, SERVER_BACKLOG)
+      || (sServer.iEpoll = epoll_create1(EPOLL_CLOEXEC)) < 0 || epoll_ctl(sServer.iEpoll, EPOLL_CTL_ADD, iListener, &eeEvent)) {
+    if (sServer.iEpoll >= 0) {
+      close(sServer.iEpoll);
+    }
+    if (sServer.iReserve >= 0) {
+      close(sServer.iReserve);
+    }
+    close(iListener);
+    return 0;
+  }
+
+  // without SA_RESTART a signal interrupts epoll_wait, which ends the loop
+  struct sigaction saStop;
+  memset(&saStop, 0, sizeof(saStop));
+  saStop.sa_handler = &requestStop;
+  sigaction(SIGINT, &saStop, NULL);
+  sigaction(SIGTERM, &saStop, NULL);
+  signal(SIGPIPE, SIG_IGN);
+  stopRequested = 0;
+
+  struct epoll_event aeeEvents[SERVER_EVENTS];
+  while (!stopRequested) {
+    int iEvents = epoll_wait(sServer.iEpoll, aeeEvents, SERVER_EVENTS, -1);
+    int i;
+    for (i = 0; i < iEvents; ++i) {
+      struct Session * psSession = (struct Session *)aeeEvents[i].data.ptr;
+      if (!psSession) {
+	acceptSessions(&sServer);
+	continue;
+      }
+      if (aeeEvents[i].events & EPOLLOUT) {
+	flushSession(&sServer, psSession);
+      } else if (aeeEvents[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+	readSession(&sServer, psSession);
+      }
+    }
+  }
+
+  printf("Served %lu connection(s) and %lu request(s).\n", (unsigned long)sServer.uiConnections, (unsigned long)sServer.uiRequests);
+  while (sServer.psSessions) {
+    closeSession(&sServer, sServer.psSessions);
+  }
+  close(sServer.iEpoll);
+  close(iListener);
+  if (sServer.iReserve >= 0) {
+    close(sServer.iReserve);
+  }
+  // the path may have been taken over by another server or file meanwhile, only the socket this server bound is removed
+  struct stat sCurrent;
+  if (isSocketFile(ccaPath, &sCurrent) && sCurrent.st_dev == sSocket.st_dev && sCurrent.st_ino == sSocket.st_ino) {
+    unlink(ccaPath);
+  }
+  return 1;
+}
+
+
+// ----------------- Local Function definitions ---------------------------
+static void requestStop(int iSignal) {
+  stopRequested = 1;
+}
+
+static void acceptSessions(struct Server * psServer) {
+  int iSocket;
+  for (;;) {
+    iSocket = accept4(psServer->iListener, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (iSocket < 0 && errno == EINTR) {
+      continue;
+    }
+    if (iSocket < 0 && (errno == EMFILE || errno == ENFILE)) {
+      // a connection left pending keeps the listener readable, so it is taken and dropped instead
+      if (psServer->iReserve < 0) {
+	pauseListener(psServer, 1);
+	return;
+      }
+      close(psServer->iReserve);
+      iSocket = accept4(psServer->iListener, NULL, NULL, SOCK_CLOEXEC);
+      int8_t iDropped = iSocket >= 0;
+      if (iDropped) {
+	close(iSocket);
+      } else if (errno == EMFILE || errno == ENFILE) {
+	pauseListener(psServer, 1);
+      }
+      psServer->iReserve = open("/dev/null", O_RDONLY | O_CLOEXEC);
+      if (!iDropped) {
+	return;
+      }
+      continue;
+    }
+    if (iSocket < 0) {
+      return;
+    }
+    struct Session * psSession = (struct Session *)allocateZeroedMemory(NULL, sizeof(struct Session), ATMatchState);
+    struct epoll_event eeEvent = { EPOLLIN, { .ptr = psSession } };
+    if (!psSession || epoll_ctl(psServer->iEpoll, EPOLL_CTL_ADD, iSocket, &eeEvent)) {
+      freeMemory(NULL, psSession);
+      close(iSocket);
+      continue;
+    }
+    psSession->iSocket = iSocket;
+    psSession->psNext = psServer->psSessions;
+    if (psServer->psSessions) {
+      psServer->psSessions->psPrevious = psSession;
+    }
+    psServer->psSessions = psSession;
+    ++psServer->uiConnections;
+  }
+}
+
+static void closeSession(struct Server * psServer, struct Session * psSession) {
+  epoll_ctl(psServer->iEpoll, EPOLL_CTL_DEL, psSession->iSocket, NULL);
+  close(psSession->iSocket);
+  releaseSnapshot(psSession->dsSnapshot);
+  if (psSession->psPrevious) {
+    psSession->psPrevious->psNext = psSession->psNext;
+  } else {
+    psServer->psSessions = psSession->psNext;
+  }
+  if (psSession->psNext) {
+    psSession->psNext->psPrevious = psSession->psPrevious;
+  }
+  freeMemory(NULL, psSession);
+  // the descriptor just closed lets the reserve be restored or a paused listener accept again
+  if (psServer->iReserve < 0) {
+    psServer->iReserve = open("/dev/null", O_RDONLY | O_CLOEXEC);
+  }
+  if (psServer->iListenerPaused) {
+    pauseListener(psServer, 0);
+  }
+}
+
+static void readSession(struct Server * psServer, struct Session * psSession) {
+  // complete lines never stay in a full buffer, handleLines drops overlong ones
+  while (psSession->uiInput < SESSION_LINE) {
+    ssize_t sRead = recv(psSession->iSocket, psSession->caInput + psSession->uiInput, SESSION_LINE - psSession->uiInput, 0);
+    if (sRead < 0 && errno == EINTR) {
+      continue;
+    }
+    if (sRead < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return;
+    }
+    if (sRead <= 0) {
+      closeSession(psServer, psSession);
+      return;
+    }
+    psSession->uiInput += (uint32_t)sRead;
+    handleLines(psServer, psSession);
+    // while the client does not take its responses its requests stay in the socket
+    if (!flushSession(psServer, psSession) || psSession->iWriting) {
+      return;
+    }
+  }
+}
+
+static void handleLines(struct Server * psServer, struct Session * psSession) {
+  uint32_t uiStart = 0;
+  uint32_t i;
+  for (i = 0; i < psSession->uiInput && !psSession->iClosing && psSession->uiOutput + RESPONSE_MAX <= SESSION_OUTPUT; ++i) {
+    if (psSession->caInput[i] != '\n') {
+      continue;
+    }
+    psSession->caInput[i] = '\0';
+    if (i > uiStart && psSession->caInput[i - 1] == '\r') {
+      psSession->caInput[i - 1] = '\0';
+    }
+    if (psSession->iDiscarding) {
+      psSession->iDiscarding = 0;
+    } else {
+      handleRequest(psServer, psSession, psSession->caInput + uiStart);
+    }
+    uiStart = i + 1;
+  }
+  if (uiStart == 0 && psSession->uiInput == SESSION_LINE) {
+    // no request is this long, drop it up to its line end
+    if (!psSession->iDiscarding) {
+      respond(psSession, "ERR TOOLONG");
+    }
+    psSession->iDiscarding = 1;
+    uiStart = psSession->uiInput;
+  }
+  memmove(psSession->caInput, psSession->caInput + uiStart, psSession->uiInput - uiStart);
+  psSession->uiInput -= uiStart;
+}
+
+static void handleRequest(struct Server * psServer, struct Session * psSession, char * caLine) {
+  char * pcArgument = strchr(caLine, ' ');
+  if (pcArgument) {
+    *pcArgument++ = '\0';
+  }
+  ++psServer->uiRequests;
+  if (!strcmp(caLine, "GUESS") && pcArgument) {
+    handleGuess(psSession, pcArgument);
+  } else if (!strcmp(caLine, "NEW") && (!pcArgument || !strcmp(pcArgument, "HARD"))) {
+    // a new match picks up the latest word list, the previous snapshot is dropped with the previous match
+    releaseSnapshot(psSession->dsSnapshot);
+    psSession->dsSnapshot = acquireSnapshot(psServer->dsSource);
+    Dictionary dWords = getSnapshotDictionary(psSession->dsSnapshot);
+    uint32_t uiIndex = (uint32_t)(nextRandom(&psServer->uiRandom) % getWordCount(dWords));
+    psSession->iInMatch = initMatchWithOptions(&psSession->mMatch, dWords, uiIndex, pcArgument ? MOHardMode : MODefault);
+    respond(psSession, "OK %s %d", getTip(&psSession->mMatch), getRemainingRounds(&psSession->mMatch));
+  } else if (!strcmp(caLine, "QUIT") && !pcArgument) {
+    respond(psSession, "BYE");
+    psSession->iClosing = 1;
+  } else {
+    respond(psSession, "ERR COMMAND");
+  }
+}
+
+static void handleGuess(struct Session * psSession, const char * ccaWord) {
+  static const char * ccaViolations[] = { "NONE", "FIXED", "EXCLUDED", "MISSING", "EXCESS" };
+  struct GuessFeedback gfFeedback;
+  char caDigits[WORD_LENGTH + 1];
+  char caWord[WORD_LENGTH + 1];
+  uint8_t i;
+  if (!psSession->iInMatch) {
+    respond(psSession, "ERR NOMATCH");
+    return;
+  }
+  enum GuessResults grResult = submitGuess(&psSession->mMatch, ccaWord, &gfFeedback);
+  if (grResult == GRAccepted || grResult == GRLost) {
+    for (i = 0; i < WORD_LENGTH; ++i) {
+      caDigits[i] = (char)('0' + gfFeedback.auiLetters[i]);
+    }
+    caDigits[WORD_LENGTH] = '\0';
+  }
+  switch (grResult) {
+  case GRAccepted:
+    respond(psSession, "FEEDBACK %s %d %s", caDigits, getRemainingRounds(&psSession->mMatch), getTip(&psSession->mMatch));
+    break;
+
+  case GRWon:
+    respond(psSession, "WON %d", MATCH_ROUNDS + 1 - getRemainingRounds(&psSession->mMatch));
+    break;
+
+  case GRLost:
+    decodeWord(getMatchWord(&psSession->mMatch), caWord);
+    respond(psSession, "LOST %s %s", caDigits, caWord);
+    break;
+
+  case GRInvalidWord:
+    respond(psSession, "ERR INVALID");
+    break;
+
+  case GRUnknownWord:
+    respond(psSession, "ERR UNKNOWN");
+    break;
+
+  case GRConstraintViolated: {
+    const struct ConstraintViolation * cpcvViolation = getViolation(&psSession->mMatch);
+    // fixed and excluded letters are bound to a position, missing and excess letters to a count
+    if (cpcvViolation->cvType == CVFixedLetter || cpcvViolation->cvType == CVExcludedLetter) {
+      respond(psSession, "ERR HARD %s %d %c", ccaViolations[cpcvViolation->cvType], cpcvViolation->uiPosition + 1, (char)('a' + cpcvViolation->uiLetter));
+    } else {
+      respond(psSession, "ERR HARD %s %c %d", ccaViolations[cpcvViolation->cvType % 5], (char)('a' + cpcvViolation->uiLetter), cpcvViolation->uiCount);
+    }
+    break;
+  }
+
+  default:
+    respond(psSession, "ERR NOMATCH");
+    break;
+  }
+}
+
+static void respond(struct Session * psSession, const char * ccaFormat, ...) {
+  va_list vlArguments;
+  va_start(vlArguments, ccaFormat);
+  int iLength = vsnprintf(psSession->caOutput + psSession->uiOutput, SESSION_OUTPUT - psSession->uiOutput - 1, ccaFormat, vlArguments);
+  va_end(vlArguments);
+  if (iLength > 0 && psSession->uiOutput + (uint32_t)iLength + 1 < SESSION_OUTPUT) {
+    psSession->uiOutput += (uint32_t)iLength;
+    psSession->caOutput[psSession->uiOutput++] = '\n';
+  }
+}
+
+static int8_t flushSession(struct Server * psServer, struct Session * psSession) {
+  while (psSession->uiOutput) {
+    while (psSession->uiSent < psSession->uiOutput) {
+      ssize_t sSent = send(psSession->iSocket, psSession->caOutput + psSession->uiSent, psSession->uiOutput - psSession->uiSent, MSG_NOSIGNAL);
+      if (sSent < 0 && errno == EINTR) {
+	continue;
+      }
+      if (sSent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+	if (!psSession->iWriting) {
+	  struct epoll_event eeEvent = { EPOLLOUT, { .ptr = psSession } };
+	  epoll_ctl(psServer->iEpoll, EPOLL_CTL_MOD, psSession->iSocket, &eeEvent);
+	  psSession->iWriting = 1;
+	}
+	return 1;
+      }
+      if (sSent < 0) {
+	closeSession(psServer, psSession);
+	return 0;
+      }
+      psSession->uiSent += (uint32_t)sSent;
+    }
+    psSession->uiOutput = 0;
+    psSession->uiSent = 0;
+    if (psSession->iClosing) {
+      closeSession(psServer, psSession);
+      return 0;
+    }
+    // lines held back while output was full are handled now
+    handleLines(psServer, psSession);
+  }
+  if (psSession->iWriting) {
+    struct epoll_event eeEvent = { EPOLLIN, { .ptr = psSession } };
+    epoll_ctl(psServer->iEpoll, EPOLL_CTL_MOD, psSession->iSocket, &eeEvent);
+    psSession->iWriting = 0;
+  }
+  return 1;
+}
+
+static void pauseListener(struct Server * psServer, int8_t iPaused) {
+  struct epoll_event eeEvent = { iPaused ? 0 : EPOLLIN, { .ptr = NULL } };
+  if (!epoll_ctl(psServer->iEpoll, EPOLL_CTL_MOD, psServer->iListener, &eeEvent)) {
+    psServer->iListenerPaused = iPaused;
+  }
+}
+
+static int8_t isSocketFile(const char * ccaPath, struct stat * psStat) {
+  if (lstat(ccaPath, psStat)) {
+    return 0;
+  }
+  if (!S_ISSOCK(psStat->st_mode)) {
+    errno = EEXIST;
+    return 0;
+  }
+  return 1;
+}
+
+static inline uint64_t nextRandom(uint64_t * puiState) {
+  *puiState ^= *puiState >> 12;
+  *puiState ^= *puiState << 25;
+  *puiState ^= *puiState >> 27;
+  return *puiState * 2685821657736338717ull;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+/*! \file server.h
+  \brief Game server.
+  Hosts matches for many clients over a Unix domain socket, all sharing read-only dictionary snapshots.
+  Every match keeps the snapshot it was started with, so a reloaded word list only affects matches started afterwards.
+  A single thread multiplexes all connections with epoll, every request is answered without blocking.
+
+  The protocol is line based, each request line gets exactly one response line:
+  - 'NEW' or 'NEW HARD' starts a match, answered by 'OK <tip> <rounds>'.
+  - 'GUESS <word>' is answered by 'FEEDBACK <digits> <remaining rounds> <tip>', 'WON <guesses>' or 'LOST <digits> <word>',
+    digits are the 'LetterFeedback' of each letter, '0' absent, '1' present, '2' correct.
+  - 'QUIT' is answered by 'BYE' before the connection is closed.
+  - Rejected requests are answered by 'ERR <reason>', reasons are COMMAND, TOOLONG, NOMATCH, INVALID, UNKNOWN
+    and 'HARD <FIXED|EXCLUDED> <position> <letter>' or 'HARD <MISSING|EXCESS> <letter> <count>' for hard mode violations.
+*/
+
+#include "reload.h"
+#include <stdint.h>
+
+/*! \brief Runs server.
+  Serves matches until SIGINT or SIGTERM is received.
+  Connections arriving while the process is out of descriptors are closed right away, or left pending until a session closes.
+  \param dsSource Source of dictionary snapshots for new matches.
+  \param ccaPath Path of Unix domain socket to create, an existing socket at this path is replaced, any other file is kept.
+  \return 1 after a clean shutdown, 0 when the socket could not be set up or the path holds something else than a socket.
+*/
+int8_t runServer(DictionarySource dsSource, const char * ccaPath);
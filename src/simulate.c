@@ -0,0 +1,160 @@
+#include "simulate.h"
+
+#include "alloc.h"
+#include "candidates.h"
+#include "parallel.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MATCHES_PER_TASK 16
+
+// ----------------- Struct definitions -----------------------------------
+
+/*! \struct SimulationWorker
+  \brief Resources and tally of one worker.
+*/
+struct SimulationWorker {
+  void * pState;                                  //!< Strategy state.
+  CandidateSet csCandidates;                      //!< Candidates of current match.
+  struct SimulationResults srResults;             //!< Tally of matches played by worker.
+};
+
+/*! \struct SimulationContext
+  \brief Shared state of a simulation.
+*/
+struct SimulationContext {
+  Dictionary dWords;                              //!< Dictionary of matches.
+  const struct Strategy * cpsStrategy;            //!< Strategy picking guesses.
+  const uint32_t * cpuiAnswers;                   //!< Answers.
+  uint32_t uiAnswers;                             //!< Amount of answers.
+  uint32_t uiOptions;                             //!< Options of matches.
+  struct SimulationWorker * pswWorkers;           //!< Worker resources, indexed by worker.
+};
+
+
+// ----------------- Local Function declarations --------------------------
+
+/*! \brief Play block of matches.
+  Parallel task playing MATCHES_PER_TASK matches with the resources of the worker.
+  \param pContext Simulation context.
+  \param uiTask Index of answer block.
+  \param uiWorker Index of worker.
+*/
+static void playMatches(void * pContext, uint32_t uiTask, uint32_t uiWorker);
+/*! \brief Next random number.
+  Advances a xorshift64* generator, used so samples do not depend on the C library.
+  \param puiState Generator state, never 0.
+  \return Random number.
+*/
+static inline uint64_t nextRandom(uint64_t * puiState);
+
+
+// ----------------- Global Function definitions --------------------------
+uint32_t sampleAnswers(uint32_t uiCount, uint32_t uiSample, uint64_t uiSeed, uint32_t * puiAnswers) {
+  uint32_t i;
+  if (uiSample >= uiCount) {
+    for (i = 0; i < uiCount; ++i) {
+      puiAnswers[i] = i;
+    }
+    return uiCount;
+  }
+  uint32_t * puiIndices = (uint32_t *)allocateMemory(NULL, sizeof(uint32_t) * uiCount, ATMatchState);
+  if (!puiIndices) {
+    return 0;
+  }
+  for (i = 0; i < uiCount; ++i) {
+    puiIndices[i] = i;
+  }
+  uint64_t uiState = uiSeed * 2 + 1;
+  // partial Fisher-Yates shuffle, the first 'uiSample' slots are the sample
+  for (i = 0; i < uiSample; ++i) {
+    uint32_t uiPick = i + (uint32_t)(nextRandom(&uiState) % (uiCount - i));
+    uint32_t uiSwap = puiIndices[uiPick];
+    puiIndices[uiPick] = puiIndices[i];
+    puiIndices[i] = uiSwap;
+    puiAnswers[i] = uiSwap;
+  }
+  freeMemory(NULL, puiIndices);
+  return uiSample;
+}
+
+int8_t runSimulation(Dictionary dWords, PatternMatrix pmPatterns, const struct Strategy * cpsStrategy, const uint32_t * cpuiAnswers, uint32_t uiAnswers, uint32_t uiOptions, uint32_t uiThreads, struct SimulationResults * psrResults) {
+  uint32_t uiWorkers = uiThreads ? uiThreads : getCoreCount();
+  uint32_t uiTasks = (uiAnswers + MATCHES_PER_TASK - 1) / MATCHES_PER_TASK;
+  if (uiWorkers > uiTasks) {
+    uiWorkers = uiTasks ? uiTasks : 1;
+  }
+  CandidateIndex ciIndex = createCandidateIndex(dWords);
+  struct SimulationWorker * pswWorkers = (struct SimulationWorker *)allocateZeroedMemory(NULL, sizeof(struct SimulationWorker) * uiWorkers, ATMatchState);
+  int8_t iResult = ciIndex && pswWorkers;
+  uint32_t i;
+  uint32_t j;
+  for (i = 0; iResult && i < uiWorkers; ++i) {
+    pswWorkers[i].pState = cpsStrategy->fnCreate(dWords, pmPatterns);
+    pswWorkers[i].csCandidates = createCandidateSet(ciIndex);
+    iResult = pswWorkers[i].pState && pswWorkers[i].csCandidates;
+  }
+  memset(psrResults, 0, sizeof(struct SimulationResults));
+  if (iResult) {
+    struct SimulationContext scContext = { dWords, cpsStrategy, cpuiAnswers, uiAnswers, uiOptions, pswWorkers };
+    struct timespec tsStart, tsEnd;
+    clock_gettime(CLOCK_MONOTONIC, &tsStart);
+    psrResults->uiWorkers = runParallel(&playMatches, &scContext, uiTasks, uiWorkers);
+    clock_gettime(CLOCK_MONOTONIC, &tsEnd);
+    psrResults->dSeconds = (tsEnd.tv_sec - tsStart.tv_sec) + (tsEnd.tv_nsec - tsStart.tv_nsec) / 1e9;
+    for (i = 0; i < uiWorkers; ++i) {
+      psrResults->uiMatches += pswWorkers[i].srResults.uiMatches;
+      psrResults->uiWins += pswWorkers[i].srResults.uiWins;
+      psrResults->uiGaveUp += pswWorkers[i].srResults.uiGaveUp;
+      for (j = 0; j < MATCH_ROUNDS; ++j) {
+	psrResults->auiWinsIn[j] += pswWorkers[i].srResults.auiWinsIn[j];
+      }
+    }
+  }
+  for (i = 0; pswWorkers && i < uiWorkers; ++i) {
+    if (pswWorkers[i].pState) {
+      cpsStrategy->fnDestroy(pswWorkers[i].pState);
+    }
+    destroyCandidateSet(pswWorkers[i].csCandidates);
+  }
+  freeMemory(NULL, pswWorkers);
+  destroyCandidateIndex(ciIndex);
+  return iResult;
+}
+
+
+// ----------------- Local Function definitions ---------------------------
+static void playMatches(void * pContext, uint32_t uiTask, uint32_t uiWorker) {
+  struct SimulationContext * pscContext = (struct SimulationContext *)pContext;
+  struct SimulationWorker * pswWorker = &pscContext->pswWorkers[uiWorker];
+  uint32_t uiAnswer = uiTask * MATCHES_PER_TASK;
+  uint32_t uiEnd = uiAnswer + MATCHES_PER_TASK < pscContext->uiAnswers ? uiAnswer + MATCHES_PER_TASK : pscContext->uiAnswers;
+  struct Match mMatch;
+  for (; uiAnswer < uiEnd; ++uiAnswer) {
+    if (!initMatchWithOptions(&mMatch, pscContext->dWords, pscContext->cpuiAnswers[uiAnswer], pscContext->uiOptions)) {
+      continue;
+    }
+    trackCandidates(&mMatch, pswWorker->csCandidates);
+    ++pswWorker->srResults.uiMatches;
+    while (getMatchState(&mMatch) == MSRunning) {
+      PackedWord pwGuess = pscContext->cpsStrategy->fnGuess(pswWorker->pState, &mMatch);
+      enum GuessResults grResult = submitPackedGuess(&mMatch, pwGuess, NULL);
+      if (grResult == GRWon) {
+	++pswWorker->srResults.uiWins;
+	++pswWorker->srResults.auiWinsIn[MATCH_ROUNDS - getRemainingRounds(&mMatch)];
+      } else if (grResult != GRAccepted && grResult != GRLost) {
+	// a strategy that can not name a legal guess would otherwise never finish
+	++pswWorker->srResults.uiGaveUp;
+	break;
+      }
+    }
+  }
+}
+
+static inline uint64_t nextRandom(uint64_t * puiState) {
+  *puiState ^= *puiState >> 12;
+  *puiState ^= *puiState << 25;
+  *puiState ^= *puiState >> 27;
+  return *puiState * 2685821657736338717ull;
+}
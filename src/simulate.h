@@ -0,0 +1,47 @@
+#pragma once
+
+/*! \file simulate.h
+  \brief Batch simulation.
+  Plays full matches with a strategy through the headless match engine, spread over worker threads.
+*/
+
+#include "dictionary.h"
+#include "match.h"
+#include "patterns.h"
+#include "strategy.h"
+#include <stdint.h>
+
+/*! \struct SimulationResults
+  \brief Outcome of a simulation.
+*/
+struct SimulationResults {
+  uint32_t uiMatches;                             //!< Amount of matches played.
+  uint32_t uiWins;                                //!< Amount of matches won.
+  uint32_t auiWinsIn[MATCH_ROUNDS];               //!< Amount of matches won with 1 to MATCH_ROUNDS guesses.
+  uint32_t uiGaveUp;                              //!< Amount of matches lost because the strategy had no legal guess.
+  double dSeconds;                                //!< Wall clock time of simulation.
+  uint32_t uiWorkers;                             //!< Amount of threads that played matches.
+};
+
+/*! \brief Sample answers.
+  Picks distinct dictionary indices uniformly at random, the same seed always gives the same sample.
+  \param uiCount Amount of dictionary words.
+  \param uiSample Amount of answers to pick, all words are picked in index order when not less than 'uiCount'.
+  \param uiSeed Seed of sample.
+  \param puiAnswers Receives min('uiSample', 'uiCount') indices.
+  \return Amount of indices written, 0 when memory could not be allocated.
+*/
+uint32_t sampleAnswers(uint32_t uiCount, uint32_t uiSample, uint64_t uiSeed, uint32_t * puiAnswers);
+/*! \brief Run simulation.
+  Plays one match per answer and blocks until all are done.
+  \param dWords Dictionary of matches.
+  \param pmPatterns Pattern matrix of dictionary passed to strategies, may be NULL.
+  \param cpsStrategy Strategy picking guesses.
+  \param cpuiAnswers Dictionary indices of answers.
+  \param uiAnswers Amount of answers.
+  \param uiOptions Combination of 'MatchOptions'.
+  \param uiThreads Amount of threads, 0 to use one per core.
+  \param psrResults Receives results.
+  \return 1 on success, 0 when resources could not be allocated.
+*/
+int8_t runSimulation(Dictionary dWords, PatternMatrix pmPatterns, const struct Strategy * cpsStrategy, const uint32_t * cpuiAnswers, uint32_t uiAnswers, uint32_t uiOptions, uint32_t uiThreads, struct SimulationResults * psrResults);
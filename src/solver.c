@@ -0,0 +1,216 @@
+#include "solver.h"
+
+#include "alloc.h"
+#include "parallel.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GUESSES_PER_TASK 64
+
+// ----------------- Struct definitions -----------------------------------
+
+/*! \struct _solver_
+  \brief Implementation of 'Solver' type.
+*/
+struct _solver_ {
+  Dictionary dWords;                              //!< Dictionary of guesses and answers.
+  PatternMatrix pmPatterns;                       //!< Pattern matrix, or NULL.
+  uint32_t uiThreads;                             //!< Amount of ranking threads.
+  uint32_t * puiCandidates;                       //!< Dictionary indices of candidates being ranked against, ascending.
+  PackedWord * pwCandidates;                      //!< Packed candidates, parallel to 'puiCandidates'.
+  uint32_t uiCandidates;                          //!< Amount of candidates being ranked against.
+  CandidateSet csCandidates;                      //!< Set being ranked against.
+  struct Suggestion sOpening;                     //!< Suggestion with every word a candidate, valid when 'iOpeningKnown'.
+  int8_t iOpeningKnown;                           //!< Opening suggestion computed.
+};
+
+/*! \struct RankContext
+  \brief Shared state of a parallel ranking.
+*/
+struct RankContext {
+  Solver sSolver;                                 //!< Solver being asked.
+  struct Suggestion * psBest;                     //!< Best suggestion per worker.
+  Pattern * pPatterns;                            //!< Pattern buffer per worker, 'uiCandidates' each, NULL with a matrix.
+  double * pdWeights;                             //!< c * log2(c) for c from 0 to 'uiCandidates'.
+  uint32_t uiGuesses;                             //!< Amount of guesses to rank.
+  int8_t iCandidatesOnly;                         //!< Guess k is candidate k instead of dictionary word k.
+};
+
+
+// ----------------- Local Function declarations --------------------------
+
+/*! \brief Rank block of guesses.
+  Parallel task computing the entropy of up to GUESSES_PER_TASK guesses and keeping the best in the slot of the worker.
+  \param pContext Rank context.
+  \param uiTask Index of guess block.
+  \param uiWorker Index of worker.
+*/
+static void rankGuesses(void * pContext, uint32_t uiTask, uint32_t uiWorker);
+/*! \brief Is better suggestion.
+  Orders suggestions by entropy, candidates and index.
+  \param sSolver Solver of suggestions.
+  \param cpsLeft Suggestion to check.
+  \param cpsRight Suggestion to compare with.
+  \return 1 when 'cpsLeft' is better than 'cpsRight', else 0.
+*/
+static int8_t isBetter(Solver sSolver, const struct Suggestion * cpsLeft, const struct Suggestion * cpsRight);
+
+
+// ----------------- Global Function definitions --------------------------
+Solver createSolver(Dictionary dWords, PatternMatrix pmPatterns, uint32_t uiThreads) {
+  uint32_t uiCount = getWordCount(dWords);
+  Solver sSolver = (Solver)allocateMemory(NULL, sizeof(struct _solver_), ATMatchState);
+  if (!sSolver) {
+    return NULL;
+  }
+  sSolver->dWords = dWords;
+  sSolver->pmPatterns = getPatternMatrixSize(pmPatterns) == uiCount ? pmPatterns : NULL;
+  sSolver->uiThreads = uiThreads ? uiThreads : getCoreCount();
+  sSolver->puiCandidates = (uint32_t *)allocateMemory(NULL, sizeof(uint32_t) * (uiCount + 1), ATMatchState);
+  sSolver->pwCandidates = (PackedWord *)allocateMemory(NULL, sizeof(PackedWord) * (uiCount + 1), ATMatchState);
+  sSolver->uiCandidates = 0;
+  sSolver->csCandidates = NULL;
+  sSolver->iOpeningKnown = 0;
+  if (!sSolver->puiCandidates || !sSolver->pwCandidates) {
+    destroySolver(sSolver);
+    return NULL;
+  }
+  return sSolver;
+}
+
+void destroySolver(Solver sSolver) {
+  if (!sSolver) {
+    return;
+  }
+  freeMemory(NULL, sSolver->puiCandidates);
+  freeMemory(NULL, sSolver->pwCandidates);
+  freeMemory(NULL, sSolver);
+}
+
+int8_t suggestGuess(Solver sSolver, CandidateSet csCandidates, int8_t iCandidatesOnly, struct Suggestion * psSuggestion) {
+  uint32_t uiCount = getWordCount(sSolver->dWords);
+  int8_t iOpening = getCandidateCount(csCandidates) == uiCount;
+  if (!getCandidateCount(csCandidates)) {
+    return 0;
+  }
+  // the opening only depends on the dictionary, rank it once per solver, every word is a candidate there anyway
+  if (iOpening && sSolver->iOpeningKnown) {
+    *psSuggestion = sSolver->sOpening;
+    return 1;
+  }
+  uint32_t i;
+  sSolver->csCandidates = csCandidates;
+  sSolver->uiCandidates = getCandidates(csCandidates, sSolver->puiCandidates);
+  for (i = 0; i < sSolver->uiCandidates; ++i) {
+    sSolver->pwCandidates[i] = getWord(sSolver->dWords, sSolver->puiCandidates[i]);
+  }
+  // with two candidates left guessing one of them is best, it either wins or reveals the other
+  if (sSolver->uiCandidates <= 2) {
+    psSuggestion->uiWord = sSolver->puiCandidates[0];
+    psSuggestion->dEntropy = sSolver->uiCandidates - 1.0;
+    psSuggestion->uiCandidates = sSolver->uiCandidates;
+    return 1;
+  }
+  struct RankContext rcContext = { sSolver, NULL, NULL, NULL, iCandidatesOnly ? sSolver->uiCandidates : uiCount, iCandidatesOnly };
+  rcContext.psBest = (struct Suggestion *)allocateMemory(NULL, sizeof(struct Suggestion) * sSolver->uiThreads, ATMatchState);
+  rcContext.pdWeights = (double *)allocateMemory(NULL, sizeof(double) * (sSolver->uiCandidates + 1), ATMatchState);
+  if (!sSolver->pmPatterns) {
+    rcContext.pPatterns = (Pattern *)allocateMemory(NULL, sizeof(Pattern) * sSolver->uiCandidates * sSolver->uiThreads, ATMatchState);
+  }
+  if (!rcContext.psBest || !rcContext.pdWeights || (!sSolver->pmPatterns && !rcContext.pPatterns)) {
+    freeMemory(NULL, rcContext.psBest);
+    freeMemory(NULL, rcContext.pdWeights);
+    freeMemory(NULL, rcContext.pPatterns);
+    return 0;
+  }
+  rcContext.pdWeights[0] = 0.0;
+  for (i = 1; i <= sSolver->uiCandidates; ++i) {
+    rcContext.pdWeights[i] = i * log2((double)i);
+  }
+  for (i = 0; i < sSolver->uiThreads; ++i) {
+    rcContext.psBest[i].uiWord = UINT32_MAX;
+    rcContext.psBest[i].dEntropy = -1.0;
+    rcContext.psBest[i].uiCandidates = sSolver->uiCandidates;
+  }
+  uint32_t uiWorkers = runParallel(&rankGuesses, &rcContext, (rcContext.uiGuesses + GUESSES_PER_TASK - 1) / GUESSES_PER_TASK, sSolver->uiThreads);
+  *psSuggestion = rcContext.psBest[0];
+  for (i = 1; i < uiWorkers; ++i) {
+    if (isBetter(sSolver, &rcContext.psBest[i], psSuggestion)) {
+      *psSuggestion = rcContext.psBest[i];
+    }
+  }
+  freeMemory(NULL, rcContext.psBest);
+  freeMemory(NULL, rcContext.pdWeights);
+  freeMemory(NULL, rcContext.pPatterns);
+  if (iOpening) {
+    sSolver->sOpening = *psSuggestion;
+    sSolver->iOpeningKnown = 1;
+  }
+  return 1;
+}
+
+
+// ----------------- Local Function definitions ---------------------------
+static void rankGuesses(void * pContext, uint32_t uiTask, uint32_t uiWorker) {
+  struct RankContext * prcContext = (struct RankContext *)pContext;
+  Solver sSolver = prcContext->sSolver;
+  uint32_t uiRank = uiTask * GUESSES_PER_TASK;
+  uint32_t uiEnd = uiRank + GUESSES_PER_TASK < prcContext->uiGuesses ? uiRank + GUESSES_PER_TASK : prcContext->uiGuesses;
+  struct Suggestion * psBest = &prcContext->psBest[uiWorker];
+  uint32_t auiCounts[PATTERN_COUNT];
+  double dTotal = log2((double)sSolver->uiCandidates);
+  uint32_t i;
+  memset(auiCounts, 0, sizeof(auiCounts));
+  for (; uiRank < uiEnd; ++uiRank) {
+    uint32_t uiGuess = prcContext->iCandidatesOnly ? sSolver->puiCandidates[uiRank] : uiRank;
+    const Pattern * cpRow = NULL;
+    Pattern * pPatterns = NULL;
+    if (sSolver->pmPatterns) {
+      cpRow = getPatternRow(sSolver->pmPatterns, uiGuess);
+      for (i = 0; i < sSolver->uiCandidates; ++i) {
+	++auiCounts[cpRow[sSolver->puiCandidates[i]]];
+      }
+    } else {
+      pPatterns = prcContext->pPatterns + (size_t)uiWorker * sSolver->uiCandidates;
+      computePatterns(getWord(sSolver->dWords, uiGuess), sSolver->pwCandidates, sSolver->uiCandidates, pPatterns);
+      for (i = 0; i < sSolver->uiCandidates; ++i) {
+	++auiCounts[pPatterns[i]];
+      }
+    }
+    // sum c * log2(c) over the histogram and clear it for the next guess
+    double dSum = 0.0;
+    if (sSolver->uiCandidates < PATTERN_COUNT) {
+      // few candidates only touch few patterns, visit just those
+      for (i = 0; i < sSolver->uiCandidates; ++i) {
+	Pattern pPattern = cpRow ? cpRow[sSolver->puiCandidates[i]] : pPatterns[i];
+	dSum += prcContext->pdWeights[auiCounts[pPattern]];
+	auiCounts[pPattern] = 0;
+      }
+    } else {
+      for (i = 0; i < PATTERN_COUNT; ++i) {
+	dSum += prcContext->pdWeights[auiCounts[i]];
+	auiCounts[i] = 0;
+      }
+    }
+    struct Suggestion sGuess = { uiGuess, dTotal - dSum / sSolver->uiCandidates, sSolver->uiCandidates };
+    if (isBetter(sSolver, &sGuess, psBest)) {
+      *psBest = sGuess;
+    }
+  }
+}
+
+static int8_t isBetter(Solver sSolver, const struct Suggestion * cpsLeft, const struct Suggestion * cpsRight) {
+  if (cpsRight->uiWord == UINT32_MAX) {
+    return 1;
+  }
+  // entropies of equal histograms must compare equal regardless of summation noise
+  if (fabs(cpsLeft->dEntropy - cpsRight->dEntropy) > 1e-9) {
+    return cpsLeft->dEntropy > cpsRight->dEntropy;
+  }
+  int8_t iLeftCandidate = isCandidate(sSolver->csCandidates, cpsLeft->uiWord);
+  if (iLeftCandidate != isCandidate(sSolver->csCandidates, cpsRight->uiWord)) {
+    return iLeftCandidate;
+  }
+  return cpsLeft->uiWord < cpsRight->uiWord;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+/*! \file solver.h
+  \brief Entropy solver.
+  Suggests the guess with the highest expected information gain over a candidate set.
+  The expected gain of a guess is the entropy of the distribution of patterns it produces over the candidates.
+*/
+
+#include "candidates.h"
+#include "dictionary.h"
+#include "feedback.h"
+#include "patterns.h"
+#include <stdint.h>
+
+typedef struct _solver_ * Solver;                 //!< Solver type.
+
+/*! \struct Suggestion
+  \brief Guess suggested by a solver.
+*/
+struct Suggestion {
+  uint32_t uiWord;                                //!< Dictionary index of suggested guess.
+  double dEntropy;                                //!< Expected information gain in bits.
+  uint32_t uiCandidates;                          //!< Amount of candidates the suggestion was ranked against.
+};
+
+/*! \brief Creates a solver.
+  Each solver created by this function must be destroyed by 'destroySolver(Solver)' to avoid memory leaks.
+  \param dWords Dictionary of allowed guesses and answers, must outlive the solver.
+  \param pmPatterns Pattern matrix of 'dWords' used to rank guesses, or NULL to compute patterns while ranking; must outlive the solver.
+  \param uiThreads Amount of threads used to rank guesses, 0 to use one per core.
+  \return Created solver or NULL when memory could not be allocated.
+*/
+Solver createSolver(Dictionary dWords, PatternMatrix pmPatterns, uint32_t uiThreads);
+/*! \brief Destroys a solver.
+  \param sSolver Solver to destroy.
+*/
+void destroySolver(Solver sSolver);
+/*! \brief Suggest guess.
+  Ranks dictionary words by expected information gain over a candidate set.
+  Ties are broken in favour of candidates, then of lower indices, so results do not depend on the amount of threads.
+  \param sSolver Solver to ask.
+  \param csCandidates Candidates over the dictionary of the solver.
+  \param iCandidatesOnly Only rank candidates as guesses, as needed when every guess must be consistent with the feedback so far.
+  \param psSuggestion Receives the best guess.
+  \return 1 on success, 0 when no candidate is left or memory could not be allocated.
+*/
+int8_t suggestGuess(Solver sSolver, CandidateSet csCandidates, int8_t iCandidatesOnly, struct Suggestion * psSuggestion);
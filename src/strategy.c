@@ -0,0 +1,137 @@
+#include "strategy.h"
+
+#include "alloc.h"
+#include "solver.h"
+#include <stdlib.h>
+#include <string.h>
+
+// ----------------- Struct definitions -----------------------------------
+
+/*! \struct EntropyState
+  \brief Thread state of 'entropy' strategy.
+*/
+struct EntropyState {
+  Dictionary dWords;                              //!< Dictionary of matches.
+  Solver sSolver;                                 //!< Solver of thread.
+  PackedWord apwOpenings[2][LETTER_COUNT];        //!< First guess per hard mode flag and revealed first letter, INVALID_WORD until ranked.
+};
+
+
+// ----------------- Local Function declarations --------------------------
+
+/*! \brief Create state of 'first' strategy.
+  The strategy has no state.
+  \param dWords Dictionary of matches.
+  \param pmPatterns Pattern matrix, unused.
+  \return Dictionary as state.
+*/
+static void * createFirst(Dictionary dWords, PatternMatrix pmPatterns);
+/*! \brief Destroy state of 'first' strategy.
+  \param pState State to destroy.
+*/
+static void destroyFirst(void * pState);
+/*! \brief Guess first candidate.
+  \param pState Dictionary of matches.
+  \param cpmMatch Match to guess in.
+  \return First remaining candidate.
+*/
+static PackedWord guessFirst(void * pState, const struct Match * cpmMatch);
+/*! \brief Create state of 'entropy' strategy.
+  Creates a single threaded solver, matches are already spread over threads.
+  \param dWords Dictionary of matches.
+  \param pmPatterns Pattern matrix of dictionary, or NULL.
+  \return Created 'struct EntropyState'.
+*/
+static void * createEntropy(Dictionary dWords, PatternMatrix pmPatterns);
+/*! \brief Destroy state of 'entropy' strategy.
+  \param pState State to destroy.
+*/
+static void destroyEntropy(void * pState);
+/*! \brief Guess word with highest information gain.
+  Only candidates are guessed in hard mode.
+  \param pState Entropy state.
+  \param cpmMatch Match to guess in.
+  \return Suggested guess.
+*/
+static PackedWord guessEntropy(void * pState, const struct Match * cpmMatch);
+
+
+// ----------------- Local Variables --------------------------------------
+static const struct Strategy strategies[] = {     //!< Built-in strategies.
+  { "first", &createFirst, &destroyFirst, &guessFirst, 0 },
+  { "entropy", &createEntropy, &destroyEntropy, &guessEntropy, 1 }
+};
+
+
+// ----------------- Global Function definitions --------------------------
+const struct Strategy * findStrategy(const char * ccaName) {
+  uint32_t i;
+  for (i = 0; i < sizeof(strategies) / sizeof(strategies[0]); ++i) {
+    if (!strcmp(strategies[i].ccaName, ccaName)) {
+      return &strategies[i];
+    }
+  }
+  return NULL;
+}
+
+
+// ----------------- Local Function definitions ---------------------------
+static void * createFirst(Dictionary dWords, PatternMatrix pmPatterns) {
+  return dWords;
+}
+
+static void destroyFirst(void * pState) {
+}
+
+static PackedWord guessFirst(void * pState, const struct Match * cpmMatch) {
+  return getWord((Dictionary)pState, getNextCandidate(getMatchCandidates(cpmMatch), 0));
+}
+
+static void * createEntropy(Dictionary dWords, PatternMatrix pmPatterns) {
+  struct EntropyState * pesState = (struct EntropyState *)allocateMemory(NULL, sizeof(struct EntropyState), ATMatchState);
+  if (!pesState) {
+    return NULL;
+  }
+  uint8_t i;
+  pesState->dWords = dWords;
+  for (i = 0; i < LETTER_COUNT; ++i) {
+    pesState->apwOpenings[0][i] = INVALID_WORD;
+    pesState->apwOpenings[1][i] = INVALID_WORD;
+  }
+  pesState->sSolver = createSolver(dWords, pmPatterns, 1);
+  if (!pesState->sSolver) {
+    freeMemory(NULL, pesState);
+    return NULL;
+  }
+  return pesState;
+}
+
+static void destroyEntropy(void * pState) {
+  struct EntropyState * pesState = (struct EntropyState *)pState;
+  if (!pesState) {
+    return;
+  }
+  destroySolver(pesState->sSolver);
+  freeMemory(NULL, pesState);
+}
+
+static PackedWord guessEntropy(void * pState, const struct Match * cpmMatch) {
+  struct EntropyState * pesState = (struct EntropyState *)pState;
+  struct Suggestion sSuggestion;
+  int8_t iHardMode = (getMatchOptions(cpmMatch) & MOHardMode) != 0;
+  PackedWord * ppwOpening = NULL;
+  // before the first guess only the tip is known, so there are just as many openings as letters
+  if (getRemainingRounds(cpmMatch) == MATCH_ROUNDS) {
+    ppwOpening = &pesState->apwOpenings[iHardMode][(getTip(cpmMatch)[0] - 'a') % LETTER_COUNT];
+    if (*ppwOpening != INVALID_WORD) {
+      return *ppwOpening;
+    }
+  }
+  if (!suggestGuess(pesState->sSolver, getMatchCandidates(cpmMatch), iHardMode, &sSuggestion)) {
+    return INVALID_WORD;
+  }
+  if (ppwOpening) {
+    *ppwOpening = getWord(pesState->dWords, sSuggestion.uiWord);
+  }
+  return getWord(pesState->dWords, sSuggestion.uiWord);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+/*! \file strategy.h
+  \brief Guessing strategies.
+  A strategy picks guesses for matches that track their candidates, see 'trackCandidates'.
+  Every thread playing matches creates its own strategy state, so guess functions need no locking.
+*/
+
+#include "dictionary.h"
+#include "match.h"
+#include "patterns.h"
+#include <stdint.h>
+
+typedef void * (*strategyCreate)(Dictionary dWords, PatternMatrix pmPatterns); //!< Creates state of one thread, returns NULL on failure.
+typedef void (*strategyDestroy)(void * pState);  //!< Destroys state of one thread.
+typedef PackedWord (*strategyGuess)(void * pState, const struct Match * cpmMatch); //!< Returns next guess for a match, INVALID_WORD to give up.
+
+/*! \struct Strategy
+  \brief Guessing strategy.
+*/
+struct Strategy {
+  const char * ccaName;                           //!< Name used to select strategy.
+  strategyCreate fnCreate;                        //!< Creates thread state.
+  strategyDestroy fnDestroy;                      //!< Destroys thread state.
+  strategyGuess fnGuess;                          //!< Picks a guess.
+  int8_t iUsesPatterns;                           //!< Strategy benefits from a pattern matrix.
+};
+
+/*! \brief Find strategy.
+  Looks up a built-in strategy by name.
+  'first' guesses the first remaining candidate, 'entropy' guesses the word with the highest expected information gain.
+  \param ccaName Name of strategy.
+  \return Strategy or NULL when there is none with this name.
+*/
+const struct Strategy * findStrategy(const char * ccaName);
@@ -0,0 +1,182 @@
+#include "strpool.h"
+
+#include "alloc.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define POOL_BLOCK_SIZE (64 * 1024)
+#define POOL_TABLE_START 1024
+
+// ----------------- Struct definitions -----------------------------------
+
+/*! \struct PoolSlot
+  \brief Slot of the lookup table.
+  The hash is kept so collisions and growing the table never compare or rehash text.
+*/
+struct PoolSlot {
+  const char * ccaText;                           //!< Pooled string, or NULL when slot is empty.
+  uint32_t uiHash;                                //!< Hash of string.
+  uint32_t uiLength;                              //!< Amount of characters in string.
+};
+
+/*! \struct _string_pool_
+  \brief Implementation of 'StringPool' type.
+  Strings are stored back to back and NUL-terminated in the blocks of an arena.
+  Interned strings are found through an open addressing table with linear probing, kept at most half full.
+  The table is only allocated once a string is interned.
+*/
+struct _string_pool_ {
+  Arena aText;                                    //!< Arena holding the strings.
+  size_t szBytes;                                 //!< Amount of bytes used by strings.
+  struct PoolSlot * psSlots;                      //!< Lookup table of interned strings, or NULL.
+  uint32_t uiSlots;                               //!< Amount of slots, a power of two.
+  uint32_t uiInterned;                            //!< Amount of interned strings.
+  uint32_t uiStrings;                             //!< Amount of strings.
+};
+
+
+// ----------------- Local Function declarations --------------------------
+
+/*! \brief Hash string.
+  Computes the 32 bit FNV-1a hash of a string.
+  \param ccaText First character of string.
+  \param uiLength Amount of characters in string.
+  \return Hash of string.
+*/
+static inline uint32_t hashString(const char * ccaText, uint32_t uiLength);
+/*! \brief Grow table.
+  Allocates the lookup table or doubles it and reinserts all interned strings.
+  \param spPool Pool to grow table of.
+  \return 1 on success, else 0.
+*/
+static int8_t growTable(StringPool spPool);
+
+
+// ----------------- Global Function definitions --------------------------
+StringPool createStringPool() {
+  StringPool spPool = (StringPool)allocateMemory(NULL, sizeof(struct _string_pool_), ATDictionaryWords);
+  if (!spPool) {
+    return NULL;
+  }
+  spPool->aText = createArena(POOL_BLOCK_SIZE, ATDictionaryWords);
+  if (!spPool->aText) {
+    freeMemory(NULL, spPool);
+    return NULL;
+  }
+  spPool->szBytes = 0;
+  spPool->psSlots = NULL;
+  spPool->uiSlots = 0;
+  spPool->uiInterned = 0;
+  spPool->uiStrings = 0;
+  return spPool;
+}
+
+void clearStringPool(StringPool spPool) {
+  if (!spPool) {
+    return;
+  }
+  clearArena(spPool->aText);
+  spPool->szBytes = 0;
+  spPool->uiStrings = 0;
+  if (spPool->uiInterned) {
+    memset(spPool->psSlots, 0, sizeof(struct PoolSlot) * spPool->uiSlots);
+    spPool->uiInterned = 0;
+  }
+}
+
+void destroyStringPool(StringPool spPool) {
+  if (!spPool) {
+    return;
+  }
+  destroyArena(spPool->aText);
+  freeMemory(NULL, spPool->psSlots);
+  freeMemory(NULL, spPool);
+}
+
+const char * internString(StringPool spPool, const char * ccaText, uint32_t uiLength) {
+  if (!spPool || (uiLength && !ccaText) || (!spPool->psSlots && !growTable(spPool))) {
+    return NULL;
+  }
+  uint32_t uiHash = hashString(ccaText, uiLength);
+  uint32_t uiMask = spPool->uiSlots - 1;
+  uint32_t uiSlot = uiHash & uiMask;
+  while (spPool->psSlots[uiSlot].ccaText) {
+    const struct PoolSlot * cpsSlot = &spPool->psSlots[uiSlot];
+    if (cpsSlot->uiHash == uiHash && cpsSlot->uiLength == uiLength && !memcmp(cpsSlot->ccaText, ccaText, uiLength)) {
+      return cpsSlot->ccaText;
+    }
+    uiSlot = (uiSlot + 1) & uiMask;
+  }
+  const char * ccaCopy = storeString(spPool, ccaText, uiLength);
+  if (!ccaCopy) {
+    return NULL;
+  }
+  spPool->psSlots[uiSlot].ccaText = ccaCopy;
+  spPool->psSlots[uiSlot].uiHash = uiHash;
+  spPool->psSlots[uiSlot].uiLength = uiLength;
+  // the string is already pooled, a failed grow only makes later lookups slower
+  if (++spPool->uiInterned > spPool->uiSlots / 2) {
+    growTable(spPool);
+  }
+  return ccaCopy;
+}
+
+const char * storeString(StringPool spPool, const char * ccaText, uint32_t uiLength) {
+  if (!spPool || (uiLength && !ccaText)) {
+    return NULL;
+  }
+  char * pCopy = (char *)allocateArenaBytes(spPool->aText, (size_t)uiLength + 1);
+  if (!pCopy) {
+    return NULL;
+  }
+  memcpy(pCopy, ccaText, uiLength);
+  pCopy[uiLength] = '\0';
+  spPool->szBytes += (size_t)uiLength + 1;
+  ++spPool->uiStrings;
+  return pCopy;
+}
+
+uint32_t getPooledStringCount(StringPool spPool) {
+  return spPool ? spPool->uiStrings : 0;
+}
+
+size_t getStringPoolSize(StringPool spPool) {
+  return spPool ? spPool->szBytes : 0;
+}
+
+
+// ----------------- Local Function definitions ---------------------------
+static inline uint32_t hashString(const char * ccaText, uint32_t uiLength) {
+  uint32_t uiHash = 2166136261u;
+  uint32_t i;
+  for (i = 0; i < uiLength; ++i) {
+    uiHash ^= (uint8_t)ccaText[i];
+    uiHash *= 16777619u;
+  }
+  return uiHash;
+}
+
+static int8_t growTable(StringPool spPool) {
+  if (spPool->uiSlots > UINT32_MAX / 2) {
+    return 0;
+  }
+  uint32_t uiSlots = spPool->uiSlots ? spPool->uiSlots * 2 : POOL_TABLE_START;
+  struct PoolSlot * psSlots = (struct PoolSlot *)allocateZeroedMemory(NULL, sizeof(struct PoolSlot) * uiSlots, ATDictionaryWords);
+  if (!psSlots) {
+    return 0;
+  }
+  uint32_t i;
+  for (i = 0; i < spPool->uiSlots; ++i) {
+    if (spPool->psSlots[i].ccaText) {
+      uint32_t uiSlot = spPool->psSlots[i].uiHash & (uiSlots - 1);
+      while (psSlots[uiSlot].ccaText) {
+	uiSlot = (uiSlot + 1) & (uiSlots - 1);
+      }
+      psSlots[uiSlot] = spPool->psSlots[i];
+    }
+  }
+  freeMemory(NULL, spPool->psSlots);
+  spPool->psSlots = psSlots;
+  spPool->uiSlots = uiSlots;
+  return 1;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+/*! \file strpool.h
+  \brief Interned string pool.
+  Strings are copied back to back into large blocks, either stored as they come or interned so equal strings share one copy.
+  Containers created with borrowed entries can point into a pool, the pool releases all strings at once.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct _string_pool_ * StringPool;        //!< String pool type.
+
+/*! \brief Creates a string pool.
+  Creates a new, empty string pool and returns it.
+  Each pool created by this function must be destroyed by 'destroyStringPool(StringPool)' to avoid memory leaks.
+  \return Created pool or NULL when memory could not be allocated.
+*/
+StringPool createStringPool();
+/*! \brief Clears a string pool.
+  Releases all strings of the pool in one bulk operation, pointers to them are no longer valid.
+  The first block and the lookup table are kept, so refilling the pool does not allocate again.
+  \param spPool Pool to clear.
+*/
+void clearStringPool(StringPool spPool);
+/*! \brief Destroys a string pool.
+  Destroys a pool and all its strings.
+  \param spPool Pool to destroy.
+*/
+void destroyStringPool(StringPool spPool);
+
+/*! \brief Intern string.
+  Returns the pooled copy of a string, copying it into the pool when it is not pooled yet.
+  The copy is NUL-terminated and stays valid until the pool is cleared or destroyed.
+  \param spPool Pool to intern string in.
+  \param ccaText First character of string, does not need to be NUL-terminated.
+  \param uiLength Amount of characters in string.
+  \return Pooled string, equal strings always return the same pointer, or NULL when memory could not be allocated.
+*/
+const char * internString(StringPool spPool, const char * ccaText, uint32_t uiLength);
+/*! \brief Store string.
+  Copies a string into the pool without looking for an equal one, in constant time.
+  Stored strings are not found by 'internString', use it when repeats are rare or removed later anyway.
+  \param spPool Pool to store string in.
+  \param ccaText First character of string, does not need to be NUL-terminated.
+  \param uiLength Amount of characters in string.
+  \return Pooled NUL-terminated copy, valid until the pool is cleared or destroyed, or NULL when memory could not be allocated.
+*/
+const char * storeString(StringPool spPool, const char * ccaText, uint32_t uiLength);
+/*! \brief Get amount of strings.
+  Returns the amount of strings in the pool.
+  \param spPool Pool to get size of.
+  \return Amount of strings.
+*/
+uint32_t getPooledStringCount(StringPool spPool);
+/*! \brief Get amount of pooled bytes.
+  Returns the amount of bytes used by pooled strings, including their terminators.
+  \param spPool Pool to get size of.
+  \return Amount of bytes.
+*/
+size_t getStringPoolSize(StringPool spPool);
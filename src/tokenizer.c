@@ -1,26 +1,164 @@
 #include "tokenizer.h"
 
-#include "list.h"
+#include "parallel.h"
+#include "scan.h"
 #include <ctype.h>
+#include <fcntl.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define TOKEN_BUFFER_START 32
+#define BATCH_TEXT_START (TOKEN_BATCH_SIZE * 8)
+#define READ_BUFFER_START 4096
+#define CHUNK_TOKENS_START 1024
+#define PARSE_CHUNKS_PER_THREAD 4
+#define PARSE_CHUNK_MIN (1 << 20)
+#define PARSE_CHUNK_MAX (1 << 30)
 
 // ----------------- Struct definitions -----------------------------------
 
+/*! \struct TokenBuffer
+  \brief Growable byte buffer holding the token under construction.
+  The buffer is reused for every token of a parse run, it only grows when a token longer than any previous one is found.
+*/
+struct TokenBuffer {
+  char * pData;                                   //!< Characters of current token, not NUL-terminated.
+  uint32_t uiLength;                              //!< Amount of characters in current token.
+  uint32_t uiCapacity;                            //!< Amount of characters 'pData' can hold.
+};
+
+/*! \struct InputData
+  \brief Contents of a parsed file.
+  Regular files are mapped into memory, other files (pipes, character devices) are read into a heap buffer.
+*/
+struct InputData {
+  const char * pData;                             //!< First byte of input.
+  size_t szLength;                                //!< Amount of bytes in input.
+  int8_t iMapped;                                 //!< 1 when 'pData' is a mapping, 0 when it is a heap buffer.
+  const struct Allocator * cpaAllocator;          //!< Allocator of heap buffer, NULL for the default.
+};
+
+/*! \struct TokenBatch
+  \brief Tokens collected for one call of a batch callback.
+  Texts are copied NUL-terminated into one buffer, the buffer only grows while the batch is empty, so views into it stay valid.
+*/
+struct TokenBatch {
+  struct TokenView * ptvTokens;                   //!< Views of collected tokens, TOKEN_BATCH_SIZE entries.
+  uint32_t uiTokens;                              //!< Amount of collected tokens.
+  enum TokenType ttType;                          //!< Type of collected tokens.
+  char * pText;                                   //!< Texts of collected tokens.
+  uint32_t uiTextLength;                          //!< Amount of characters used in 'pText'.
+  uint32_t uiTextCapacity;                        //!< Amount of characters 'pText' can hold.
+};
+
 /*! \struct ParseContext
   \brief Context of tokenizer.
 */
 struct ParseContext {
-  FILE * file;                                    //!< File parsed by tokenizer.
-  List list;                                      //!< List to mimic dynamic string.
+  struct InputData idInput;                       //!< Input parsed by tokenizer.
+  struct TokenBuffer tbToken;                     //!< Copy of token under construction, only used when token is not contiguous in input.
+  struct TokenView tvToken;                       //!< Token under construction.
+  int8_t iBuffered;                               //!< 1 when 'tvToken' lives in 'tbToken', 0 when it points into input.
   int iLine;                                      //!< Line number of tokenizer.
   int iColumn;                                    //!< Column number of tokenizer.
-  parserCallback fnCallback;                      //!< Callback for external token processing.
+  const char * ccaError;                          //!< Message of the error that stopped the tokenizer, or NULL.
+  parserCallback fnCallback;                      //!< Callback for external token processing, receives copies.
+  parserViewCallback fnViewCallback;              //!< Callback for external token processing, receives views.
+  parserContextCallback fnContextCallback;        //!< Callback for external token processing, receives views and 'pCallbackContext'.
+  void * pCallbackContext;                        //!< Context of 'fnContextCallback' or 'fnBatchCallback'.
+  parserBatchCallback fnBatchCallback;            //!< Callback for external token processing, receives batches of views and 'pCallbackContext'.
+  struct TokenBatch tbBatch;                      //!< Batch under construction, only used with 'fnBatchCallback'.
+  const struct ParseOptions * cpoOptions;         //!< Filters of tokens, or NULL.
+  int8_t iRejected;                               //!< 1 when the token under construction failed a filter and is only measured.
+  const struct Allocator * cpaAllocator;          //!< Allocator of buffers and copied tokens, NULL for the default.
+};
+
+/*! \struct ChunkToken
+  \brief Token collected from a chunk, kept until the chunk is sent.
+  Tokens contiguous in the input are kept as offset into the chunk, others are copied to the pool of the chunk.
+*/
+struct ChunkToken {
+  uint32_t uiOffset;                              //!< Offset of first character in chunk or pool.
+  uint32_t uiLength;                              //!< Amount of characters in token.
+  uint8_t uiType;                                 //!< Type of token, as 'enum TokenType'.
+  int8_t iPooled;                                 //!< 1 when 'uiOffset' is an offset into the pool, 0 when into the chunk.
+};
+
+/*! \struct ParseChunk
+  \brief Range of the input parsed by one task.
+  A chunk always starts right after a ';' or at the start of the input, where the serial tokenizer has no token under construction.
+  Line and column of its context start at 1 and 0 and are made absolute once all chunks before it are parsed.
+*/
+struct ParseChunk {
+  const char * ccaBegin;                          //!< First character of chunk.
+  const char * ccaEnd;                            //!< End of chunk.
+  struct ParseContext pcContext;                  //!< Context of tokenizer, holds line and column relative to chunk after parsing.
+  struct ChunkToken * pctTokens;                  //!< Collected tokens in chunk order.
+  uint32_t uiTokens;                              //!< Amount of collected tokens.
+  uint32_t uiTokenCapacity;                       //!< Amount of tokens 'pctTokens' can hold.
+  char * pPool;                                   //!< Copies of tokens that are not contiguous in the input.
+  uint32_t uiPoolLength;                          //!< Amount of characters in pool.
+  uint32_t uiPoolCapacity;                        //!< Amount of characters 'pPool' can hold.
+  enum ParseResults prResult;                     //!< Result of parsing chunk.
+  int8_t iOutOfMemory;                            //!< 1 when collecting a token failed.
+  int8_t iParsed;                                 //!< 1 when the task of the chunk finished, guarded by 'mSend'.
+};
+
+/*! \struct ParallelParse
+  \brief Shared state of one 'parseFileParallel' call.
+*/
+struct ParallelParse {
+  struct ParseChunk * ppcChunks;                  //!< Chunks in file order.
+  uint32_t uiChunks;                              //!< Amount of chunks.
+  uint32_t uiFailed;                              //!< Index of first chunk that failed or was canceled, 'uiChunks' when none, lowered atomically.
+  parserContextCallback fnCallback;               //!< Callback of caller.
+  void * pContext;                                //!< Context of callback.
+  int8_t iCollect;                                //!< 1 when tokens are collected and sent in file order.
+  pthread_mutex_t mSend;                          //!< Guards sending state.
+  uint32_t uiSent;                                //!< Amount of chunks sent, guarded by 'mSend'.
+  int8_t iSending;                                //!< 1 while a worker sends chunks, guarded by 'mSend'.
+  uint32_t uiCanceledChunk;                       //!< Chunk the callback canceled in, only valid when 'uiCanceledToken' is set.
+  uint32_t uiCanceledToken;                       //!< Amount of tokens of canceled chunk sent including the canceling one, 0 when not canceled.
 };
 
 
 // ----------------- Local Function declarations --------------------------
 
+/*! \brief Load input.
+  Maps a file into memory, or reads it completely when it can not be mapped.
+  \param path Relative or absolute path to file.
+  \param pidInput Input to initialize.
+  \param cpaAllocator Allocator of heap buffer, NULL for the default.
+  \return 1 on success, else 0.
+*/
+static int8_t loadInput(const char * path, struct InputData * pidInput, const struct Allocator * cpaAllocator);
+/*! \brief Release input.
+  Unmaps or frees input loaded by 'loadInput'.
+  \param pidInput Input to release.
+*/
+static void releaseInput(struct InputData * pidInput);
+/*! \brief Parse input.
+  Loads a file and runs the tokenizer over all of it.
+  \param path Relative or absolute path to a text file.
+  \param ppcContext Context of tokenizer, only callbacks need to be set.
+  \return ROk on success, error code otherwise.
+*/
+static enum ParseResults parseInput(const char * path, struct ParseContext * ppcContext);
+/*! \brief Parse range.
+  Runs the tokenizer over a range of the input, starting with no token under construction.
+  Line and column of the context are continued from their current values.
+  On error 'ccaError' of the context is set and line and column point to the error, nothing is reported.
+  \param ccaBegin First character of range.
+  \param ccaEnd End of range, a newline directly before it is treated as the end of the file.
+  \param ppcContext Context of tokenizer.
+  \return ROk on success, error code otherwise.
+*/
+static enum ParseResults parseRange(const char * ccaBegin, const char * ccaEnd, struct ParseContext * ppcContext);
 /*! \brief Report error.
   Reports an error to stdin.
   \param ccaMessage Message to print.
@@ -32,12 +170,31 @@ static inline void reportError(const char * ccaMessage, const struct ParseContex
   \param ppcContext Context to free.
 */
 static inline void cleanUp(struct ParseContext * ppcContext);
-/*! \brief Report error and clean up.
-  Reports an error to stdin and frees memory.
-  \param ccaMessage Message to print.
-  \param ppcContext Context of the tokenizer.
+/*! \brief Append character to token.
+  Appends a character to the token buffer, growing the buffer when it is full.
+  \param cChar Character to append.
+  \param ppcContext Context of tokenizer.
+  \return 1 on success, else 0.
+*/
+static inline int8_t appendChar(char cChar, struct ParseContext * ppcContext);
+/*! \brief Parse letters.
+  Adds a run of letters to the token under construction.
+  As long as a token is contiguous in the input it is only a view, it is copied to the token buffer once an ignored character splits it.
+  \param ccaLetters Location of first letter in input.
+  \param uiCount Amount of letters in run.
+  \param ppcContext Context of tokenizer.
+  \return 1 on success, else 0.
+*/
+static inline int8_t parseLetters(const char * ccaLetters, uint32_t uiCount, struct ParseContext * ppcContext);
+/*! \brief Accept letters.
+  Checks a run of letters added to a token against the filters of the options.
+  \param ccaLetters Location of first letter in input.
+  \param uiCount Amount of letters in run.
+  \param uiLength Amount of letters already in token.
+  \param cpoOptions Filters of tokens.
+  \return 1 when token can still pass the filters, else 0.
 */
-static inline void reportAndClean(const char * ccaMessage, struct ParseContext * ppcContext);
+static inline int8_t acceptLetters(const char * ccaLetters, uint32_t uiCount, uint32_t uiLength, const struct ParseOptions * cpoOptions);
 /*! \brief Parse new line char.
   Parses a new line char to support for '\n', '\n\r' and '\r'.
   \param ppcContext Context of tokenizer.
@@ -48,93 +205,468 @@ static enum ParseResults parseNewLine(struct ParseContext * ppcContext);
   Parses an expression.
   \param ppcContext Context of tokenizer.
   \return Parse result.
-*/  
+*/
 static enum ParseResults parseExpression(struct ParseContext * ppcContext);
+/*! \brief Add token to batch.
+  Copies a token into the batch, sending the batch first when it is full or holds another token type.
+  \param ttType Type of token.
+  \param ptvToken Token to add.
+  \param ppcContext Context of tokenizer.
+  \return ROk on success, RErrCanceled when the callback canceled or RErrOutOfMemory.
+*/
+static enum ParseResults batchToken(enum TokenType ttType, const struct TokenView * ptvToken, struct ParseContext * ppcContext);
+/*! \brief Send batch.
+  Passes the collected tokens to the batch callback and empties the batch.
+  \param ppcContext Context of tokenizer.
+  \return Return value of callback, 1 when batch is empty.
+*/
+static int8_t sendBatch(struct ParseContext * ppcContext);
+/*! \brief Split input.
+  Splits input into chunks of about equal size, each ending right after a ';' or at the end of the input.
+  \param ccaInput First character of input.
+  \param szLength Amount of characters in input.
+  \param uiChunks Amount of chunks to aim for.
+  \param pppcChunks Receives the allocated chunks.
+  \return Amount of chunks, 0 when memory could not be allocated.
+*/
+static uint32_t splitInput(const char * ccaInput, size_t szLength, uint32_t uiChunks, struct ParseChunk ** pppcChunks);
+/*! \brief Parse chunk.
+  Parallel task running the tokenizer over one chunk, chunks after the first failed one are skipped.
+  \param pContext Parallel parse, as 'struct ParallelParse *'.
+  \param uiTask Index of chunk.
+  \param uiWorker Index of worker, unused.
+*/
+static void parseChunk(void * pContext, uint32_t uiTask, uint32_t uiWorker);
+/*! \brief Collect token.
+  Tokenizer callback keeping a token of a chunk until the chunk is sent.
+  \param pContext Chunk, as 'struct ParseChunk *'.
+  \param ttType Type of token.
+  \param ptvToken Token data.
+  \return 0 when memory could not be allocated, otherwise 1.
+*/
+static int8_t collectToken(void * pContext, enum TokenType ttType, const struct TokenView * ptvToken);
+/*! \brief Send chunks.
+  Marks a chunk as parsed and sends all parsed chunks that directly follow the sent ones.
+  Only one worker sends at a time, a worker finding another one sending leaves its chunk to it.
+  \param pppParse Parallel parse.
+  \param uiChunk Index of parsed chunk.
+*/
+static void sendChunks(struct ParallelParse * pppParse, uint32_t uiChunk);
+/*! \brief Send chunk.
+  Passes the collected tokens of a chunk to the callback and frees them.
+  \param pppParse Parallel parse.
+  \param uiChunk Index of chunk.
+*/
+static void sendChunk(struct ParallelParse * pppParse, uint32_t uiChunk);
+/*! \brief Count token.
+  Tokenizer callback canceling once a number of tokens is reached, used to find where a callback canceled.
+  \param pContext Amount of tokens left, as 'uint32_t *'.
+  \param ttType Type of token, unused.
+  \param ptvToken Token data, unused.
+  \return 0 when the counted token is reached, otherwise 1.
+*/
+static int8_t countToken(void * pContext, enum TokenType ttType, const struct TokenView * ptvToken);
+/*! \brief Lower failed chunk.
+  Atomically lowers the index of the first failed chunk.
+  \param pppParse Parallel parse.
+  \param uiChunk Index of failed chunk.
+*/
+static inline void lowerFailed(struct ParallelParse * pppParse, uint32_t uiChunk);
+/*! \brief Finish parallel parse.
+  Determines the result of a parallel parse and reports its first error at the position the serial tokenizer reports.
+  \param pppParse Parallel parse whose tasks all finished.
+  \return ROk on success, error code otherwise.
+*/
+static enum ParseResults finishParallel(struct ParallelParse * pppParse);
 
 
 // ----------------- Global Function definitions --------------------------
 enum ParseResults parseFile(const char * path, parserCallback fnCallback) {
+  return parseFileWithOptions(path, fnCallback, NULL);
+}
+
+enum ParseResults parseFileWithOptions(const char * path, parserCallback fnCallback, const struct ParseOptions * cpoOptions) {
   struct ParseContext pcContext;
-  pcContext.file = fopen(path, "r");
-  if (!pcContext.file) {
+  pcContext.fnCallback = fnCallback;
+  pcContext.fnViewCallback = NULL;
+  pcContext.fnContextCallback = NULL;
+  pcContext.fnBatchCallback = NULL;
+  pcContext.cpoOptions = cpoOptions;
+  return parseInput(path, &pcContext);
+}
+
+enum ParseResults parseFileMapped(const char * path, parserViewCallback fnCallback) {
+  struct ParseContext pcContext;
+  pcContext.fnCallback = NULL;
+  pcContext.fnViewCallback = fnCallback;
+  pcContext.fnContextCallback = NULL;
+  pcContext.fnBatchCallback = NULL;
+  pcContext.cpoOptions = NULL;
+  return parseInput(path, &pcContext);
+}
+
+enum ParseResults parseFileMappedWithContext(const char * path, parserContextCallback fnCallback, void * pContext) {
+  struct ParseContext pcContext;
+  pcContext.fnCallback = NULL;
+  pcContext.fnViewCallback = NULL;
+  pcContext.fnContextCallback = fnCallback;
+  pcContext.fnBatchCallback = NULL;
+  pcContext.pCallbackContext = pContext;
+  pcContext.cpoOptions = NULL;
+  return parseInput(path, &pcContext);
+}
+
+enum ParseResults parseFileBatched(const char * path, parserBatchCallback fnCallback, void * pContext) {
+  return parseFileBatchedWithOptions(path, fnCallback, pContext, NULL);
+}
+
+enum ParseResults parseFileBatchedWithOptions(const char * path, parserBatchCallback fnCallback, void * pContext, const struct ParseOptions * cpoOptions) {
+  struct ParseContext pcContext;
+  pcContext.fnCallback = NULL;
+  pcContext.fnViewCallback = NULL;
+  pcContext.fnContextCallback = NULL;
+  pcContext.fnBatchCallback = fnCallback;
+  pcContext.pCallbackContext = pContext;
+  pcContext.cpoOptions = cpoOptions;
+  return parseInput(path, &pcContext);
+}
+
+enum ParseResults parseFileParallel(const char * path, parserContextCallback fnCallback, void * pContext, uint32_t uiThreads, uint32_t uiOptions) {
+  struct InputData idInput;
+  if (!uiThreads) {
+    uiThreads = getCoreCount();
+  }
+  if (uiThreads < 2) {
+    return parseFileMappedWithContext(path, fnCallback, pContext);
+  }
+  if (!loadInput(path, &idInput, NULL)) {
+    printf("Error: Failed to read '%s'\n", path);
+    return RErrFileAccess;
+  }
+  // several chunks per thread even out chunks that parse slower, but chunks stay large enough to be worth a task
+  uint64_t uiChunks = (uint64_t)uiThreads * PARSE_CHUNKS_PER_THREAD;
+  if (uiChunks > idInput.szLength / PARSE_CHUNK_MIN) {
+    uiChunks = idInput.szLength / PARSE_CHUNK_MIN;
+  }
+  if (uiChunks < idInput.szLength / PARSE_CHUNK_MAX + 1) {
+    uiChunks = idInput.szLength / PARSE_CHUNK_MAX + 1;
+  }
+  struct ParallelParse ppParse;
+  ppParse.uiChunks = splitInput(idInput.pData, idInput.szLength, (uint32_t)uiChunks, &ppParse.ppcChunks);
+  if (!ppParse.uiChunks) {
+    releaseInput(&idInput);
+    printf("Error: Out of memory\n");
+    return RErrOutOfMemory;
+  }
+  ppParse.uiFailed = ppParse.uiChunks;
+  ppParse.fnCallback = fnCallback;
+  ppParse.pContext = pContext;
+  // a single chunk is already in file order
+  ppParse.iCollect = !(uiOptions & PPOUnordered) && ppParse.uiChunks > 1;
+  pthread_mutex_init(&ppParse.mSend, NULL);
+  ppParse.uiSent = 0;
+  ppParse.iSending = 0;
+  ppParse.uiCanceledChunk = 0;
+  ppParse.uiCanceledToken = 0;
+
+  runParallel(&parseChunk, &ppParse, ppParse.uiChunks, uiThreads);
+  enum ParseResults result = finishParallel(&ppParse);
+
+  uint32_t i;
+  for (i = 0; i < ppParse.uiChunks; ++i) {
+    freeMemory(NULL, ppParse.ppcChunks[i].pctTokens);
+    freeMemory(NULL, ppParse.ppcChunks[i].pPool);
+  }
+  freeMemory(NULL, ppParse.ppcChunks);
+  pthread_mutex_destroy(&ppParse.mSend);
+  releaseInput(&idInput);
+  return result;
+}
+
+char * copyToken(const struct TokenView * ptvToken) {
+  if (!ptvToken) {
+    return NULL;
+  }
+  char * token = (char *)malloc(sizeof(char) * (ptvToken->uiLength + 1));
+  if (!token) {
+    return NULL;
+  }
+  memcpy(token, ptvToken->pText, sizeof(char) * ptvToken->uiLength);
+  token[ptvToken->uiLength] = '\0';
+  return token;
+}
+
+char * copyTokenWithAllocator(const struct TokenView * ptvToken, const struct Allocator * cpaAllocator) {
+  if (!ptvToken) {
+    return NULL;
+  }
+  char * token = (char *)allocateMemory(cpaAllocator, sizeof(char) * (ptvToken->uiLength + 1), ATTokenBuffers);
+  if (!token) {
+    return NULL;
+  }
+  memcpy(token, ptvToken->pText, sizeof(char) * ptvToken->uiLength);
+  token[ptvToken->uiLength] = '\0';
+  return token;
+}
+
+
+// ----------------- Local Function definitions ---------------------------
+static int8_t loadInput(const char * path, struct InputData * pidInput, const struct Allocator * cpaAllocator) {
+  int iFile = open(path, O_RDONLY);
+  if (iFile < 0) {
     return 0;
   }
-  
-  pcContext.list = createList();
-  pcContext.iLine = 1;
-  pcContext.iColumn = 0;
-  pcContext.fnCallback = fnCallback;
+  pidInput->cpaAllocator = cpaAllocator;
+  struct stat sStat;
+  if (fstat(iFile, &sStat)) {
+    close(iFile);
+    return 0;
+  }
+  // map regular files, a mapping stays valid after the descriptor is closed
+  if (S_ISREG(sStat.st_mode)) {
+    pidInput->szLength = (size_t)sStat.st_size;
+    pidInput->iMapped = 1;
+    if (!pidInput->szLength) {
+      pidInput->pData = NULL;
+      close(iFile);
+      return 1;
+    }
+    void * pMapping = mmap(NULL, pidInput->szLength, PROT_READ, MAP_PRIVATE, iFile, 0);
+    if (pMapping != MAP_FAILED) {
+      madvise(pMapping, pidInput->szLength, MADV_SEQUENTIAL);
+      pidInput->pData = (const char *)pMapping;
+      close(iFile);
+      return 1;
+    }
+  }
+  // anything that can not be mapped is read completely
+  size_t szCapacity = READ_BUFFER_START;
+  char * pBuffer = (char *)allocateMemory(cpaAllocator, szCapacity, ATTokenBuffers);
+  pidInput->szLength = 0;
+  pidInput->iMapped = 0;
+  while (pBuffer) {
+    if (pidInput->szLength == szCapacity) {
+      char * pGrown = (char *)reallocateMemory(cpaAllocator, pBuffer, szCapacity * 2, ATTokenBuffers);
+      if (!pGrown) {
+	break;
+      }
+      pBuffer = pGrown;
+      szCapacity *= 2;
+    }
+    ssize_t ssRead = read(iFile, pBuffer + pidInput->szLength, szCapacity - pidInput->szLength);
+    if (ssRead < 0) {
+      break;
+    }
+    if (!ssRead) {
+      pidInput->pData = pBuffer;
+      close(iFile);
+      return 1;
+    }
+    pidInput->szLength += (size_t)ssRead;
+  }
+  freeMemory(cpaAllocator, pBuffer);
+  close(iFile);
+  return 0;
+}
+
+static void releaseInput(struct InputData * pidInput) {
+  if (pidInput->iMapped) {
+    if (pidInput->pData) {
+      munmap((void *)pidInput->pData, pidInput->szLength);
+    }
+  } else {
+    freeMemory(pidInput->cpaAllocator, (void *)pidInput->pData);
+  }
+}
+
+static enum ParseResults parseInput(const char * path, struct ParseContext * ppcContext) {
+  ppcContext->cpaAllocator = ppcContext->cpoOptions ? ppcContext->cpoOptions->cpaAllocator : NULL;
+  if (!loadInput(path, &ppcContext->idInput, ppcContext->cpaAllocator)) {
+    printf("Error: Failed to read '%s'\n", path);
+    return RErrFileAccess;
+  }
+
+  ppcContext->tbToken.pData = NULL;
+  ppcContext->tbToken.uiLength = 0;
+  ppcContext->tbToken.uiCapacity = 0;
+  ppcContext->iLine = 1;
+  ppcContext->iColumn = 0;
+  struct TokenBatch * ptbBatch = &ppcContext->tbBatch;
+  ptbBatch->ptvTokens = NULL;
+  ptbBatch->uiTokens = 0;
+  ptbBatch->pText = NULL;
+  ptbBatch->uiTextLength = 0;
+  ptbBatch->uiTextCapacity = 0;
+  if (ppcContext->fnBatchCallback) {
+    ptbBatch->ptvTokens = (struct TokenView *)allocateMemory(ppcContext->cpaAllocator, sizeof(struct TokenView) * TOKEN_BATCH_SIZE, ATTokenBuffers);
+    if (!ptbBatch->ptvTokens) {
+      ppcContext->ccaError = "Out of memory";
+      reportError(ppcContext->ccaError, ppcContext);
+      cleanUp(ppcContext);
+      return RErrOutOfMemory;
+    }
+  }
+  enum ParseResults result = parseRange(ppcContext->idInput.pData, ppcContext->idInput.pData + ppcContext->idInput.szLength, ppcContext);
+  // tokens found before the end or an error are still pending in the last batch
+  if (ppcContext->fnBatchCallback && result != RErrCanceled && !sendBatch(ppcContext) && !result) {
+    ppcContext->ccaError = "Unexpected ';'";
+    result = RErrCanceled;
+  }
+  if (result) {
+    reportError(ppcContext->ccaError, ppcContext);
+  }
+  cleanUp(ppcContext);
+  return result;
+}
+
+static enum ParseResults parseRange(const char * ccaBegin, const char * ccaEnd, struct ParseContext * ppcContext) {
+  ppcContext->tvToken.pText = NULL;
+  ppcContext->tvToken.uiLength = 0;
+  ppcContext->iBuffered = 0;
+  ppcContext->iRejected = 0;
+  ppcContext->ccaError = NULL;
   enum ParseResults result = ROk;
 
-  int iRead;
-  while ((iRead = fgetc(pcContext.file)) != EOF) {
-    ++pcContext.iColumn;
-    
-    switch (iRead) {
+  const char * ccaRead = ccaBegin;
+  while (ccaRead < ccaEnd) {
+    char cRead = *ccaRead;
+    ++ppcContext->iColumn;
+
+    switch (cRead) {
     case '\n':
-      {
-	fpos_t pPos;
-	fgetpos(pcContext.file, &pPos);
-	int iTmpRead = fgetc(pcContext.file);
-	if (iTmpRead == EOF) {
-	  // reportAndClean("Unexpected end of file", &pcContext);
-	  cleanUp(&pcContext);
-	  return ROk;
-	}
-	if (iTmpRead != '\r') {
-	  fsetpos(pcContext.file, &pPos);
-	}
+      if (ccaRead + 1 == ccaEnd) {
+	// ppcContext->ccaError = "Unexpected end of file";
+	return ROk;
+      }
+      if (ccaRead[1] == '\r') {
+	++ccaRead;
       }
     case '\r':
-      if ((result = parseNewLine(&pcContext))) {
-	reportAndClean("Unexpected newline", &pcContext);
+      if ((result = parseNewLine(ppcContext))) {
+	ppcContext->ccaError = "Unexpected newline";
 	return result;
       }
       break;
 
     case ';':
-      if ((result = parseExpression(&pcContext))) {
-	reportAndClean("Unexpected ';'", &pcContext);
+      if ((result = parseExpression(ppcContext))) {
+	// a token that could not be copied or batched is no syntax error
+	ppcContext->ccaError = result == RErrOutOfMemory ? "Out of memory" : "Unexpected ';'";
 	return result;
       }
       break;
 
     default:
-      if ((iRead >= 'a' && iRead <= 'z') || (iRead >= 'A' && iRead <= 'Z')) {
-	char * buf = (char *)malloc(sizeof(char));
-	*buf = (char)iRead;
-	addEntry(pcContext.list, getEnd(pcContext.list), (void *)buf);
-      } else if (isspace((char)iRead)) {
+      if ((cRead >= 'a' && cRead <= 'z') || (cRead >= 'A' && cRead <= 'Z')) {
+	// consume the whole letter run at once, the vectorized scanner finds the next ';', newline or other non-letter
+	uint32_t uiRun = 1 + (uint32_t)scanLetters(ccaRead + 1, (size_t)(ccaEnd - ccaRead - 1));
+	if (!parseLetters(ccaRead, uiRun, ppcContext)) {
+	  ppcContext->ccaError = "Out of memory";
+	  return RErrOutOfMemory;
+	}
+	ppcContext->iColumn += uiRun - 1;
+	ccaRead += uiRun - 1;
+      } else if (isspace((unsigned char)cRead)) {
 	
-	if (getSize(pcContext.list) > 0) {
-	  reportAndClean("Missing ';'", &pcContext);
+	if (ppcContext->tvToken.uiLength > 0) {
+	  ppcContext->ccaError = "Missing ';'";
 	  return RErrMissingToken;
 	}
       }
       break;
     }
+    ++ccaRead;
   }
-
-  cleanUp(&pcContext);
   return ROk;
 }
 
-
-// ----------------- Local Function definitions ---------------------------
 static inline void reportError(const char * ccaMessage, const struct ParseContext * cppcContext) {
   printf("Errror: %s at line %d[%d]\n", ccaMessage, cppcContext->iLine, cppcContext->iColumn);
 }
 static inline void cleanUp(struct ParseContext * ppcContext) {
-  destroyList(ppcContext->list);
-  fclose(ppcContext->file);
+  freeMemory(ppcContext->cpaAllocator, ppcContext->tbToken.pData);
+  if (ppcContext->fnBatchCallback) {
+    freeMemory(ppcContext->cpaAllocator, ppcContext->tbBatch.ptvTokens);
+    freeMemory(ppcContext->cpaAllocator, ppcContext->tbBatch.pText);
+  }
+  releaseInput(&ppcContext->idInput);
 }
-static inline void reportAndClean(const char * ccaMessage, struct ParseContext * ppcContext) {
-  reportError(ccaMessage, ppcContext);
-  cleanUp(ppcContext);
+static inline int8_t appendChar(char cChar, struct ParseContext * ppcContext) {
+  struct TokenBuffer * ptbToken = &ppcContext->tbToken;
+  // grow geometrically so a token of n characters costs O(log n) allocations once per parse run, not per token
+  if (ptbToken->uiLength == ptbToken->uiCapacity) {
+    uint32_t uiCapacity = ptbToken->uiCapacity ? ptbToken->uiCapacity * 2 : TOKEN_BUFFER_START;
+    char * pData = (char *)reallocateMemory(ppcContext->cpaAllocator, ptbToken->pData, sizeof(char) * uiCapacity, ATTokenBuffers);
+    if (!pData) {
+      return 0;
+    }
+    ptbToken->pData = pData;
+    ptbToken->uiCapacity = uiCapacity;
+  }
+  ptbToken->pData[ptbToken->uiLength++] = cChar;
+  return 1;
+}
+
+static inline int8_t parseLetters(const char * ccaLetters, uint32_t uiCount, struct ParseContext * ppcContext) {
+  struct TokenView * ptvToken = &ppcContext->tvToken;
+  if (ppcContext->cpoOptions && !ppcContext->iRejected && !acceptLetters(ccaLetters, uiCount, ptvToken->uiLength, ppcContext->cpoOptions)) {
+    ppcContext->iRejected = 1;
+  }
+  // a rejected token is only measured for syntax checks, it is never copied
+  if (ppcContext->iRejected) {
+    ptvToken->uiLength += uiCount;
+    return 1;
+  }
+  // first run starts a view, runs directly following it only extend the view
+  if (!ptvToken->uiLength) {
+    ptvToken->pText = ccaLetters;
+    ptvToken->uiLength = uiCount;
+    return 1;
+  }
+  if (!ppcContext->iBuffered && ptvToken->pText + ptvToken->uiLength == ccaLetters) {
+    ptvToken->uiLength += uiCount;
+    return 1;
+  }
+  uint32_t i;
+  // an ignored character split the token, continue it in the token buffer
+  if (!ppcContext->iBuffered) {
+    ppcContext->tbToken.uiLength = 0;
+    for (i = 0; i < ptvToken->uiLength; ++i) {
+      if (!appendChar(ptvToken->pText[i], ppcContext)) {
+	return 0;
+      }
+    }
+    ppcContext->iBuffered = 1;
+  }
+  for (i = 0; i < uiCount; ++i) {
+    if (!appendChar(ccaLetters[i], ppcContext)) {
+      return 0;
+    }
+  }
+  ptvToken->uiLength = ppcContext->tbToken.uiLength;
+  return 1;
+}
+
+static inline int8_t acceptLetters(const char * ccaLetters, uint32_t uiCount, uint32_t uiLength, const struct ParseOptions * cpoOptions) {
+  if (cpoOptions->uiMaxLength && uiCount > cpoOptions->uiMaxLength - uiLength) {
+    return 0;
+  }
+  // with both or no classes set every letter is allowed
+  uint32_t uiClasses = cpoOptions->uiCharClasses & (CCLower | CCUpper);
+  if (uiClasses == CCLower || uiClasses == CCUpper) {
+    char cFrom = uiClasses == CCLower ? 'A' : 'a';
+    uint32_t i;
+    for (i = 0; i < uiCount; ++i) {
+      if (ccaLetters[i] >= cFrom && ccaLetters[i] <= cFrom + 25) {
+	return 0;
+      }
+    }
+  }
+  return 1;
 }
 
 static enum ParseResults parseNewLine(struct ParseContext * ppcContext) {
-  if (getSize(ppcContext->list) > 0) {
+  if (ppcContext->tvToken.uiLength > 0) {
     return RErrInvalidToken;
   }
   ++ppcContext->iLine;
@@ -143,17 +675,38 @@ static enum ParseResults parseNewLine(struct ParseContext * ppcContext) {
 }
 
 static enum ParseResults parseExpression(struct ParseContext * ppcContext) {
-  int iSize;
-  if ((iSize = getSize(ppcContext->list)) > 0) {
-    char * token = (char *)malloc(sizeof(char) * (iSize + 1));
-    int i;
-    Iterator iter;
-    for (i = 0, iter = getBegin(ppcContext->list); i < iSize && iter; ++i, moveNext(&iter)) {
-      token[i] = *(char *)getCurrent(iter);
-    }
-    token[i] = '\0';
-    clearList(ppcContext->list);
-    if (!(*ppcContext->fnCallback)(TTText, (Token)token)) {
+  struct TokenView * ptvToken = &ppcContext->tvToken;
+  if (ptvToken->uiLength > 0) {
+    int8_t iContinue;
+    // filtered tokens end here without being sent
+    if (ppcContext->iRejected || (ppcContext->cpoOptions && ptvToken->uiLength < ppcContext->cpoOptions->uiMinLength)) {
+      ptvToken->uiLength = 0;
+      ppcContext->iBuffered = 0;
+      ppcContext->iRejected = 0;
+      return ROk;
+    }
+    if (ppcContext->iBuffered) {
+      ptvToken->pText = ppcContext->tbToken.pData;
+    }
+    if (ppcContext->fnBatchCallback) {
+      enum ParseResults result = batchToken(TTText, ptvToken, ppcContext);
+      ptvToken->uiLength = 0;
+      ppcContext->iBuffered = 0;
+      return result;
+    } else if (ppcContext->fnContextCallback) {
+      iContinue = (*ppcContext->fnContextCallback)(ppcContext->pCallbackContext, TTText, ptvToken);
+    } else if (ppcContext->fnViewCallback) {
+      iContinue = (*ppcContext->fnViewCallback)(TTText, ptvToken);
+    } else {
+      char * token = ppcContext->cpaAllocator ? copyTokenWithAllocator(ptvToken, ppcContext->cpaAllocator) : copyToken(ptvToken);
+      if (!token) {
+	return RErrOutOfMemory;
+      }
+      iContinue = (*ppcContext->fnCallback)(TTText, (Token)token);
+    }
+    ptvToken->uiLength = 0;
+    ppcContext->iBuffered = 0;
+    if (!iContinue) {
       return RErrCanceled;
     }
     return ROk;
@@ -161,3 +714,257 @@ static enum ParseResults parseExpression(struct ParseContext * ppcContext) {
     return RErrInvalidToken;
   }  
 }
+
+static enum ParseResults batchToken(enum TokenType ttType, const struct TokenView * ptvToken, struct ParseContext * ppcContext) {
+  struct TokenBatch * ptbBatch = &ppcContext->tbBatch;
+  if (ptbBatch->uiTokens && (ptbBatch->uiTokens == TOKEN_BATCH_SIZE || ptbBatch->ttType != ttType
+			     || ptbBatch->uiTextLength + ptvToken->uiLength + 1 > ptbBatch->uiTextCapacity)) {
+    if (!sendBatch(ppcContext)) {
+      return RErrCanceled;
+    }
+  }
+  // views point into the text, so it only grows while the batch is empty
+  if (ptvToken->uiLength + 1 > ptbBatch->uiTextCapacity) {
+    uint32_t uiCapacity = ptbBatch->uiTextCapacity ? ptbBatch->uiTextCapacity : BATCH_TEXT_START;
+    while (uiCapacity < ptvToken->uiLength + 1) {
+      uiCapacity *= 2;
+    }
+    char * pText = (char *)reallocateMemory(ppcContext->cpaAllocator, ptbBatch->pText, uiCapacity, ATTokenBuffers);
+    if (!pText) {
+      return RErrOutOfMemory;
+    }
+    ptbBatch->pText = pText;
+    ptbBatch->uiTextCapacity = uiCapacity;
+  }
+  char * pToken = ptbBatch->pText + ptbBatch->uiTextLength;
+  memcpy(pToken, ptvToken->pText, ptvToken->uiLength);
+  pToken[ptvToken->uiLength] = '\0';
+  ptbBatch->uiTextLength += ptvToken->uiLength + 1;
+  ptbBatch->ptvTokens[ptbBatch->uiTokens].pText = pToken;
+  ptbBatch->ptvTokens[ptbBatch->uiTokens].uiLength = ptvToken->uiLength;
+  ptbBatch->ttType = ttType;
+  ++ptbBatch->uiTokens;
+  return ROk;
+}
+
+static int8_t sendBatch(struct ParseContext * ppcContext) {
+  struct TokenBatch * ptbBatch = &ppcContext->tbBatch;
+  if (!ptbBatch->uiTokens) {
+    return 1;
+  }
+  int8_t iContinue = (*ppcContext->fnBatchCallback)(ppcContext->pCallbackContext, ptbBatch->ttType, ptbBatch->ptvTokens, ptbBatch->uiTokens);
+  ptbBatch->uiTokens = 0;
+  ptbBatch->uiTextLength = 0;
+  return iContinue;
+}
+
+static uint32_t splitInput(const char * ccaInput, size_t szLength, uint32_t uiChunks, struct ParseChunk ** pppcChunks) {
+  struct ParseChunk * ppcChunks = (struct ParseChunk *)allocateZeroedMemory(NULL, sizeof(struct ParseChunk) * (uiChunks ? uiChunks : 1), ATTokenBuffers);
+  *pppcChunks = ppcChunks;
+  if (!ppcChunks) {
+    return 0;
+  }
+  uint32_t uiCount = 0;
+  const char * ccaBegin = ccaInput;
+  const char * ccaEnd = ccaInput + szLength;
+  uint32_t i;
+  for (i = 1; i <= uiChunks && ccaBegin < ccaEnd; ++i) {
+    const char * ccaSplit = ccaEnd;
+    // move the boundary to the next ';', so no chunk starts inside a token
+    if (i < uiChunks) {
+      ccaSplit = ccaInput + (size_t)((uint64_t)szLength * i / uiChunks);
+      if (ccaSplit < ccaBegin) {
+	ccaSplit = ccaBegin;
+      }
+      const char * ccaSeparator = (const char *)memchr(ccaSplit, ';', (size_t)(ccaEnd - ccaSplit));
+      ccaSplit = ccaSeparator ? ccaSeparator + 1 : ccaEnd;
+    }
+    ppcChunks[uiCount].ccaBegin = ccaBegin;
+    ppcChunks[uiCount].ccaEnd = ccaSplit;
+    ++uiCount;
+    ccaBegin = ccaSplit;
+  }
+  // an empty input is still one empty chunk
+  if (!uiCount) {
+    ppcChunks[0].ccaBegin = ccaInput;
+    ppcChunks[0].ccaEnd = ccaInput;
+    uiCount = 1;
+  }
+  return uiCount;
+}
+
+static void parseChunk(void * pContext, uint32_t uiTask, uint32_t uiWorker) {
+  struct ParallelParse * pppParse = (struct ParallelParse *)pContext;
+  struct ParseChunk * ppcChunk = &pppParse->ppcChunks[uiTask];
+  (void)uiWorker;
+  ppcChunk->prResult = ROk;
+  // tasks are claimed in order, so every chunk before a failed one is already running and none of them is skipped
+  if (uiTask <= __atomic_load_n(&pppParse->uiFailed, __ATOMIC_RELAXED)) {
+    struct ParseContext * ppcContext = &ppcChunk->pcContext;
+    ppcContext->fnCallback = NULL;
+    ppcContext->fnViewCallback = NULL;
+    ppcContext->fnBatchCallback = NULL;
+    ppcContext->cpoOptions = NULL;
+    ppcContext->cpaAllocator = NULL;
+    if (pppParse->iCollect) {
+      ppcContext->fnContextCallback = &collectToken;
+      ppcContext->pCallbackContext = ppcChunk;
+    } else {
+      ppcContext->fnContextCallback = pppParse->fnCallback;
+      ppcContext->pCallbackContext = pppParse->pContext;
+    }
+    ppcContext->tbToken.pData = NULL;
+    ppcContext->tbToken.uiLength = 0;
+    ppcContext->tbToken.uiCapacity = 0;
+    ppcContext->iLine = 1;
+    ppcContext->iColumn = 0;
+    ppcChunk->prResult = parseRange(ppcChunk->ccaBegin, ppcChunk->ccaEnd, ppcContext);
+    freeMemory(NULL, ppcContext->tbToken.pData);
+    if (ppcChunk->prResult) {
+      lowerFailed(pppParse, uiTask);
+    }
+  }
+  if (pppParse->iCollect) {
+    sendChunks(pppParse, uiTask);
+  }
+}
+
+static int8_t collectToken(void * pContext, enum TokenType ttType, const struct TokenView * ptvToken) {
+  struct ParseChunk * ppcChunk = (struct ParseChunk *)pContext;
+  if (ppcChunk->uiTokens == ppcChunk->uiTokenCapacity) {
+    uint32_t uiCapacity = ppcChunk->uiTokenCapacity ? ppcChunk->uiTokenCapacity * 2 : CHUNK_TOKENS_START;
+    struct ChunkToken * pctTokens = (struct ChunkToken *)reallocateMemory(NULL, ppcChunk->pctTokens, sizeof(struct ChunkToken) * uiCapacity, ATTokenBuffers);
+    if (!pctTokens) {
+      ppcChunk->iOutOfMemory = 1;
+      return 0;
+    }
+    ppcChunk->pctTokens = pctTokens;
+    ppcChunk->uiTokenCapacity = uiCapacity;
+  }
+  struct ChunkToken * pctToken = &ppcChunk->pctTokens[ppcChunk->uiTokens];
+  pctToken->uiLength = ptvToken->uiLength;
+  pctToken->uiType = (uint8_t)ttType;
+  // views into the chunk stay valid until it is sent, tokens from the token buffer do not
+  if (ptvToken->pText >= ppcChunk->ccaBegin && ptvToken->pText < ppcChunk->ccaEnd) {
+    pctToken->uiOffset = (uint32_t)(ptvToken->pText - ppcChunk->ccaBegin);
+    pctToken->iPooled = 0;
+  } else {
+    if (ppcChunk->uiPoolLength + ptvToken->uiLength > ppcChunk->uiPoolCapacity) {
+      uint32_t uiCapacity = ppcChunk->uiPoolCapacity ? ppcChunk->uiPoolCapacity : TOKEN_BUFFER_START;
+      while (uiCapacity < ppcChunk->uiPoolLength + ptvToken->uiLength) {
+	uiCapacity *= 2;
+      }
+      char * pPool = (char *)reallocateMemory(NULL, ppcChunk->pPool, uiCapacity, ATTokenBuffers);
+      if (!pPool) {
+	ppcChunk->iOutOfMemory = 1;
+	return 0;
+      }
+      ppcChunk->pPool = pPool;
+      ppcChunk->uiPoolCapacity = uiCapacity;
+    }
+    memcpy(ppcChunk->pPool + ppcChunk->uiPoolLength, ptvToken->pText, ptvToken->uiLength);
+    pctToken->uiOffset = ppcChunk->uiPoolLength;
+    pctToken->iPooled = 1;
+    ppcChunk->uiPoolLength += ptvToken->uiLength;
+  }
+  ++ppcChunk->uiTokens;
+  return 1;
+}
+
+static void sendChunks(struct ParallelParse * pppParse, uint32_t uiChunk) {
+  pthread_mutex_lock(&pppParse->mSend);
+  pppParse->ppcChunks[uiChunk].iParsed = 1;
+  if (pppParse->iSending) {
+    pthread_mutex_unlock(&pppParse->mSend);
+    return;
+  }
+  pppParse->iSending = 1;
+  while (pppParse->uiSent < pppParse->uiChunks && pppParse->ppcChunks[pppParse->uiSent].iParsed) {
+    uint32_t uiSend = pppParse->uiSent++;
+    // the callback runs unlocked, so workers finishing meanwhile only mark their chunk
+    pthread_mutex_unlock(&pppParse->mSend);
+    sendChunk(pppParse, uiSend);
+    pthread_mutex_lock(&pppParse->mSend);
+  }
+  pppParse->iSending = 0;
+  pthread_mutex_unlock(&pppParse->mSend);
+}
+
+static void sendChunk(struct ParallelParse * pppParse, uint32_t uiChunk) {
+  struct ParseChunk * ppcChunk = &pppParse->ppcChunks[uiChunk];
+  // chunks after the first failed one are dropped, the failed one still sends the tokens found before its error
+  if (uiChunk <= __atomic_load_n(&pppParse->uiFailed, __ATOMIC_RELAXED)) {
+    uint32_t i;
+    struct TokenView tvToken;
+    for (i = 0; i < ppcChunk->uiTokens; ++i) {
+      const struct ChunkToken * cpctToken = &ppcChunk->pctTokens[i];
+      tvToken.pText = (cpctToken->iPooled ? ppcChunk->pPool : ppcChunk->ccaBegin) + cpctToken->uiOffset;
+      tvToken.uiLength = cpctToken->uiLength;
+      if (!(*pppParse->fnCallback)(pppParse->pContext, (enum TokenType)cpctToken->uiType, &tvToken)) {
+	pppParse->uiCanceledChunk = uiChunk;
+	pppParse->uiCanceledToken = i + 1;
+	lowerFailed(pppParse, uiChunk);
+	break;
+      }
+    }
+  }
+  freeMemory(NULL, ppcChunk->pctTokens);
+  freeMemory(NULL, ppcChunk->pPool);
+  ppcChunk->pctTokens = NULL;
+  ppcChunk->pPool = NULL;
+}
+
+static int8_t countToken(void * pContext, enum TokenType ttType, const struct TokenView * ptvToken) {
+  uint32_t * puiLeft = (uint32_t *)pContext;
+  (void)ttType;
+  (void)ptvToken;
+  return --*puiLeft > 0;
+}
+
+static inline void lowerFailed(struct ParallelParse * pppParse, uint32_t uiChunk) {
+  uint32_t uiFailed = __atomic_load_n(&pppParse->uiFailed, __ATOMIC_RELAXED);
+  while (uiChunk < uiFailed && !__atomic_compare_exchange_n(&pppParse->uiFailed, &uiFailed, uiChunk, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+  }
+}
+
+static enum ParseResults finishParallel(struct ParallelParse * pppParse) {
+  uint32_t uiFailed = pppParse->uiFailed;
+  if (uiFailed == pppParse->uiChunks) {
+    return ROk;
+  }
+  struct ParseChunk * ppcFailed = &pppParse->ppcChunks[uiFailed];
+  enum ParseResults result = ppcFailed->prResult;
+  if (pppParse->uiCanceledToken) {
+    // parse the chunk again up to the canceling token, its ';' is where the serial tokenizer stops
+    uint32_t uiLeft = pppParse->uiCanceledToken;
+    struct ParseContext * ppcContext = &ppcFailed->pcContext;
+    ppcContext->fnContextCallback = &countToken;
+    ppcContext->pCallbackContext = &uiLeft;
+    ppcContext->tbToken.pData = NULL;
+    ppcContext->tbToken.uiLength = 0;
+    ppcContext->tbToken.uiCapacity = 0;
+    ppcContext->iLine = 1;
+    ppcContext->iColumn = 0;
+    result = parseRange(ppcFailed->ccaBegin, ppcFailed->ccaEnd, ppcContext);
+    freeMemory(NULL, ppcContext->tbToken.pData);
+  } else if (ppcFailed->iOutOfMemory) {
+    ppcFailed->pcContext.ccaError = "Out of memory";
+    result = RErrOutOfMemory;
+  }
+  // every chunk before the failed one was parsed completely, their line counts give the position of the chunk
+  int iLine = 1;
+  int iColumn = 0;
+  uint32_t i;
+  for (i = 0; i < uiFailed; ++i) {
+    const struct ParseContext * cppcContext = &pppParse->ppcChunks[i].pcContext;
+    iColumn = cppcContext->iLine > 1 ? cppcContext->iColumn : iColumn + cppcContext->iColumn;
+    iLine += cppcContext->iLine - 1;
+  }
+  struct ParseContext * ppcContext = &ppcFailed->pcContext;
+  if (ppcContext->iLine == 1) {
+    ppcContext->iColumn += iColumn;
+  }
+  ppcContext->iLine += iLine - 1;
+  reportError(ppcContext->ccaError, ppcContext);
+  return result;
+}
@@ -4,8 +4,11 @@
   \brief Basic text stream tokenizer.
 */
 
+#include "alloc.h"
 #include <stdint.h>
 
+#define TOKEN_BATCH_SIZE 4096                     //!< Largest amount of tokens passed to a batch callback at once.
+
 /*! \enum TokenType
   \brief Supported token types.
 */
@@ -20,11 +23,54 @@ enum ParseResults {
   ROk = 0,                                        //!< No errors.
   RErrCanceled,                                   //!< Parse operation canceled by callback.
   RErrInvalidToken,                               //!< Invalid or unexpected token found.
-  RErrMissingToken                                //!< Missing token.
+  RErrMissingToken,                               //!< Missing token.
+  RErrOutOfMemory,                                //!< Failed to allocate memory.
+  RErrFileAccess                                  //!< Failed to open or read input file.
+};
+
+/*! \enum ParallelParseOptions
+  \brief Options of 'parseFileParallel'.
+*/
+enum ParallelParseOptions {
+  PPODefault = 0,                                 //!< Tokens are sent in file order and callbacks never run concurrently.
+  PPOUnordered = 1                                //!< Tokens are sent from the parsing threads as they are found, chunks in any order.
+};
+
+/*! \enum CharClasses
+  \brief Character classes tokens can be limited to, may be combined.
+*/
+enum CharClasses {
+  CCAny = 0,                                      //!< Any letter.
+  CCLower = 1,                                    //!< Lower case letters a-z.
+  CCUpper = 2                                     //!< Upper case letters A-Z.
+};
+
+/*! \struct ParseOptions
+  \brief Token filters applied by the tokenizer while scanning, and the allocator of the parse run.
+  A token failing a filter is still checked for syntax errors, but it is never copied, allocated or passed to the callback.
+  Lengths count letters only, like the length of a token.
+*/
+struct ParseOptions {
+  uint32_t uiMinLength;                           //!< Least amount of letters of a token.
+  uint32_t uiMaxLength;                           //!< Most amount of letters of a token, 0 for no limit.
+  uint32_t uiCharClasses;                         //!< Combination of 'CharClasses' every letter must be in, CCAny for any letter.
+  const struct Allocator * cpaAllocator;          //!< Allocator of buffers and of tokens passed to a 'parserCallback', which must then be released through it. NULL for the default, tokens then come from malloc.
+};
+
+/*! \struct TokenView
+  \brief View of a token in the parsed input.
+  The text is not NUL-terminated and only valid during the callback it is passed to, use 'copyToken' to keep it.
+*/
+struct TokenView {
+  const char * pText;                             //!< First character of token.
+  uint32_t uiLength;                              //!< Amount of characters in token.
 };
 
 typedef const char * Token;                       //!< Token type.
 typedef int8_t (*parserCallback)(enum TokenType, Token); //!< Type of tokenizer callback.
+typedef int8_t (*parserViewCallback)(enum TokenType, const struct TokenView *); //!< Type of tokenizer callback receiving token views.
+typedef int8_t (*parserContextCallback)(void *, enum TokenType, const struct TokenView *); //!< Type of tokenizer callback receiving a context and token views.
+typedef int8_t (*parserBatchCallback)(void *, enum TokenType, const struct TokenView *, uint32_t); //!< Type of tokenizer callback receiving a context and an array of token views of one type.
 
 /*! \brief Generate token stream from file stream.
   Generates a token stream from a file stream.
@@ -36,3 +82,81 @@ typedef int8_t (*parserCallback)(enum TokenType, Token); //!< Type of tokenizer
   \return ROk on success, error code otherwise.
 */
 enum ParseResults parseFile(const char * path, parserCallback fnCallback);
+/*! \brief Generate filtered token stream from file stream.
+  Works like 'parseFile', but tokens failing the filters of the options are skipped while scanning.
+  \param path Relative or absolute path to a text file, file must exists.
+  \param fnCallback Pointer to function called when a new token is available.
+  \param cpoOptions Filters of tokens, NULL to pass all tokens.
+  \return ROk on success, error code otherwise.
+*/
+enum ParseResults parseFileWithOptions(const char * path, parserCallback fnCallback, const struct ParseOptions * cpoOptions);
+/*! \brief Generate token view stream from memory mapped file.
+  Generates a token stream from a file mapped into memory.
+  Tokens are send to the callback as views into the mapping, no memory is allocated per token.
+  A view is only valid during the callback, tokens that must be kept are copied with 'copyToken'.
+  When the callback returns 0, the parse operation cancels.
+  \param path Relative or absolute path to a text file, file must exists.
+  \param fnCallback Pointer to function called when a new token is available.
+  \return ROk on success, error code otherwise.
+*/
+enum ParseResults parseFileMapped(const char * path, parserViewCallback fnCallback);
+/*! \brief Generate token view stream with context.
+  Works like 'parseFileMapped', but passes a context to every callback.
+  Each parse run only touches its own state and context, so several files can be parsed concurrently on different threads.
+  \param path Relative or absolute path to a text file, file must exists.
+  \param fnCallback Pointer to function called when a new token is available.
+  \param pContext Context passed to the callback.
+  \return ROk on success, error code otherwise.
+*/
+enum ParseResults parseFileMappedWithContext(const char * path, parserContextCallback fnCallback, void * pContext);
+/*! \brief Generate token view stream from file in parallel.
+  Splits a file into chunks that end at a ';' and tokenizes the chunks on separate threads.
+  Tokens and errors are the same as for 'parseFileMapped', errors are reported with the line and column the serial tokenizer reports.
+  By default the tokens of each chunk are collected and sent in file order as soon as all chunks before it are sent, one callback at a time.
+  No token after the first error is sent.
+  With 'PPOUnordered' nothing is collected, callbacks run concurrently on the parsing threads and must be thread-safe.
+  Tokens of a chunk still arrive in order, but chunks arrive in any order, and chunks after an error may have been sent before it was found.
+  Small files and a single thread fall back to the serial tokenizer.
+  \param path Relative or absolute path to a text file, file must exists.
+  \param fnCallback Pointer to function called when a new token is available.
+  \param pContext Context passed to the callback.
+  \param uiThreads Amount of threads, 0 to use one per core.
+  \param uiOptions Combination of 'ParallelParseOptions'.
+  \return ROk on success, error code otherwise.
+*/
+enum ParseResults parseFileParallel(const char * path, parserContextCallback fnCallback, void * pContext, uint32_t uiThreads, uint32_t uiOptions);
+/*! \brief Generate batched token stream from file.
+  Generates a token stream from a file mapped into memory and sends it to the callback in batches of up to TOKEN_BATCH_SIZE tokens.
+  All tokens of a batch have the same type, their texts are copied NUL-terminated into one contiguous buffer the views point into.
+  A batch is only valid during the callback, tokens that must be kept are copied.
+  Tokens found before an error are sent before the error is reported.
+  When the callback returns 0, the parse operation cancels, the error is reported at the token that completed the batch.
+  \param path Relative or absolute path to a text file, file must exists.
+  \param fnCallback Pointer to function called when a batch of tokens is available.
+  \param pContext Context passed to the callback.
+  \return ROk on success, error code otherwise.
+*/
+enum ParseResults parseFileBatched(const char * path, parserBatchCallback fnCallback, void * pContext);
+/*! \brief Generate filtered batched token stream from file.
+  Works like 'parseFileBatched', but tokens failing the filters of the options are skipped while scanning.
+  \param path Relative or absolute path to a text file, file must exists.
+  \param fnCallback Pointer to function called when a batch of tokens is available.
+  \param pContext Context passed to the callback.
+  \param cpoOptions Filters of tokens, NULL to pass all tokens.
+  \return ROk on success, error code otherwise.
+*/
+enum ParseResults parseFileBatchedWithOptions(const char * path, parserBatchCallback fnCallback, void * pContext, const struct ParseOptions * cpoOptions);
+/*! \brief Copy token view.
+  Copies the text of a token view into a new NUL-terminated string.
+  Returned string must be freed by caller.
+  \param ptvToken Token to copy.
+  \return Copy of token or NULL when memory could not be allocated.
+*/
+char * copyToken(const struct TokenView * ptvToken);
+/*! \brief Copy token view with allocator.
+  Works like 'copyToken', but allocates the copy with an allocator, e.g. an arena releasing all copies at once.
+  \param ptvToken Token to copy.
+  \param cpaAllocator Allocator of copy, NULL for the default, the copy must be freed through it.
+  \return Copy of token or NULL when memory could not be allocated.
+*/
+char * copyTokenWithAllocator(const struct TokenView * ptvToken, const struct Allocator * cpaAllocator);
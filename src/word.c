@@ -0,0 +1,55 @@
+#include "word.h"
+
+#include <stddef.h>
+
+#define LETTER_MASK ((1u << WORD_LETTER_BITS) - 1)
+
+// ----------------- Global Function definitions --------------------------
+PackedWord encodeWord(const char * ccaWord) {
+  if (!ccaWord) {
+    return INVALID_WORD;
+  }
+  uint8_t i;
+  // stop at NUL so words shorter than five letters never read past their end
+  for (i = 0; i < WORD_LENGTH; ++i) {
+    if (!ccaWord[i]) {
+      return INVALID_WORD;
+    }
+  }
+  if (ccaWord[WORD_LENGTH]) {
+    return INVALID_WORD;
+  }
+  return encodeLetters(ccaWord);
+}
+
+PackedWord encodeLetters(const char * ccaLetters) {
+  if (!ccaLetters) {
+    return INVALID_WORD;
+  }
+  PackedWord pwWord = 0;
+  uint8_t i;
+  for (i = 0; i < WORD_LENGTH; ++i) {
+    // folding to lower case maps both ranges onto 0..25, anything else lands outside
+    uint8_t uiLetter = (uint8_t)((ccaLetters[i] | 0x20) - 'a');
+    if (uiLetter >= 26) {
+      return INVALID_WORD;
+    }
+    pwWord = (pwWord << WORD_LETTER_BITS) | uiLetter;
+  }
+  return pwWord;
+}
+
+void decodeWord(PackedWord pwWord, char * caWord) {
+  if (!caWord) {
+    return;
+  }
+  uint8_t i;
+  for (i = 0; i < WORD_LENGTH; ++i) {
+    caWord[i] = (char)('a' + getLetter(pwWord, i));
+  }
+  caWord[WORD_LENGTH] = '\0';
+}
+
+uint8_t getLetter(PackedWord pwWord, uint8_t uiPosition) {
+  return (uint8_t)((pwWord >> ((WORD_LENGTH - 1 - uiPosition) * WORD_LETTER_BITS)) & LETTER_MASK);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+/*! \file word.h
+  \brief Packed representation of five letter words.
+  A word is stored in 25 bits, 5 bits per letter with the first letter in the most significant bits.
+  Comparing packed words as integers therefore orders them alphabetically.
+*/
+
+#include <stdint.h>
+
+#define WORD_LENGTH 5                             //!< Amount of letters in a word.
+#define LETTER_COUNT 26                           //!< Amount of distinct letters, a-z.
+#define WORD_LETTER_BITS 5                        //!< Amount of bits per packed letter.
+#define WORD_BITS (WORD_LENGTH * WORD_LETTER_BITS) //!< Amount of bits in a packed word.
+#define WORD_SPACE (1u << WORD_BITS)              //!< Amount of distinct packed values.
+#define INVALID_WORD UINT32_MAX                   //!< Value that never represents a word.
+
+typedef uint32_t PackedWord;                      //!< Packed five letter word.
+
+/*! \brief Encode word.
+  Packs a NUL-terminated word of exactly five letters (a-z or A-Z), case is ignored.
+  \param ccaWord Word to encode.
+  \return Packed word or INVALID_WORD when input is not a five letter word.
+*/
+PackedWord encodeWord(const char * ccaWord);
+/*! \brief Encode letters.
+  Packs five letters that are not necessarily NUL-terminated, case is ignored.
+  \param ccaLetters First of five letters to encode.
+  \return Packed word or INVALID_WORD when input contains a character that is not a letter.
+*/
+PackedWord encodeLetters(const char * ccaLetters);
+/*! \brief Decode word.
+  Unpacks a word to lower case letters.
+  \param pwWord Word to decode.
+  \param caWord Buffer receiving the NUL-terminated word, must hold at least WORD_LENGTH + 1 characters.
+*/
+void decodeWord(PackedWord pwWord, char * caWord);
+/*! \brief Get letter of word.
+  Returns the letter at a position as index in the alphabet.
+  \param pwWord Word to get letter from.
+  \param uiPosition Position of letter, 0 is the first letter.
+  \return Letter index, 0 for 'a' to 25 for 'z'.
+*/
+uint8_t getLetter(PackedWord pwWord, uint8_t uiPosition);
@@ -0,0 +1,195 @@
+#include "wordlist.h"
+
+#include "alloc.h"
+#include "parallel.h"
+#include "tokenizer.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define WORD_BUFFER_START 1024
+#define RADIX_LOW_BITS 13
+#define RADIX_HIGH_BITS (WORD_BITS - RADIX_LOW_BITS)
+
+// ----------------- Struct definitions -----------------------------------
+
+/*! \struct WordBuffer
+  \brief Growable buffer of packed words collected from one list.
+*/
+struct WordBuffer {
+  PackedWord * pwWords;                           //!< Words in list order.
+  uint32_t uiCount;                               //!< Amount of words.
+  uint32_t uiCapacity;                            //!< Amount of words 'pwWords' can hold.
+  enum ParseResults prResult;                     //!< Result of parsing the list.
+};
+
+/*! \struct MergeRun
+  \brief Shared state of one 'mergeWordLists' call.
+  Every list has its own buffer, so workers never share state and the merge order does not depend on scheduling.
+*/
+struct MergeRun {
+  const char * const * ccaPaths;                  //!< Paths to lists.
+  struct WordBuffer * pwbLists;                   //!< Buffer per list.
+  uint32_t uiListThreads;                         //!< Amount of threads parsing each list.
+};
+
+
+// ----------------- Local Function declarations --------------------------
+
+/*! \brief Collect word.
+  Tokenizer callback appending five letter tokens packed to a word buffer.
+  \param pContext Word buffer, as 'struct WordBuffer *'.
+  \param ttType Type of the token to process.
+  \param ptvToken Token data.
+  \return 0 to cancel on unsupported token type or when buffer can not grow, otherwise 1.
+*/
+static int8_t collectWord(void * pContext, enum TokenType ttType, const struct TokenView * ptvToken);
+/*! \brief Parse list.
+  Parallel task parsing one list into its word buffer, in chunks on several threads when there are threads to spare.
+  \param pContext Merge run, as 'struct MergeRun *'.
+  \param uiTask Index of list.
+  \param uiWorker Index of worker, unused.
+*/
+static void parseList(void * pContext, uint32_t uiTask, uint32_t uiWorker);
+/*! \brief Radix sort words.
+  Sorts packed words in two counting passes over the low and high bits of the packed value.
+  \param pwWords Words to sort, receives sorted words.
+  \param pwTemp Buffer of at least 'uiCount' words used between passes.
+  \param uiCount Amount of words.
+*/
+static void radixSort(PackedWord * pwWords, PackedWord * pwTemp, uint32_t uiCount);
+/*! \brief Radix pass.
+  Stable counting sort of words by a bit field of their packed value.
+  \param cpwFrom Words to sort.
+  \param pwTo Buffer receiving sorted words.
+  \param uiCount Amount of words.
+  \param uiShift Position of lowest bit of field.
+  \param uiBits Amount of bits in field.
+  \param puiOffsets Buffer of at least 2^'uiBits' counters.
+*/
+static void radixPass(const PackedWord * cpwFrom, PackedWord * pwTo, uint32_t uiCount, uint8_t uiShift, uint8_t uiBits, uint32_t * puiOffsets);
+
+
+// ----------------- Global Function definitions --------------------------
+Dictionary mergeWordLists(const char * const * ccaPaths, uint32_t uiPaths, uint32_t uiThreads, uint32_t * puiFailed) {
+  if (puiFailed) {
+    *puiFailed = uiPaths;
+  }
+  struct WordBuffer * pwbLists = (struct WordBuffer *)allocateZeroedMemory(NULL, sizeof(struct WordBuffer) * (uiPaths ? uiPaths : 1), ATDictionaryWords);
+  if (!pwbLists) {
+    return NULL;
+  }
+  struct MergeRun mrRun;
+  mrRun.ccaPaths = ccaPaths;
+  mrRun.pwbLists = pwbLists;
+  if (!uiThreads) {
+    uiThreads = getCoreCount();
+  }
+  // with fewer lists than threads the remaining threads split each list into chunks
+  mrRun.uiListThreads = uiPaths && uiPaths < uiThreads ? uiThreads / uiPaths : 1;
+  runParallel(&parseList, &mrRun, uiPaths, uiThreads);
+
+  uint32_t i;
+  uint64_t uiTotal = 0;
+  int8_t iParsed = 1;
+  for (i = 0; i < uiPaths; ++i) {
+    if (pwbLists[i].prResult != ROk) {
+      if (puiFailed) {
+	*puiFailed = i;
+      }
+      iParsed = 0;
+      break;
+    }
+    uiTotal += pwbLists[i].uiCount;
+  }
+  Dictionary dWords = NULL;
+  PackedWord * pwWords = NULL;
+  PackedWord * pwTemp = NULL;
+  if (iParsed && uiTotal < UINT32_MAX) {
+    pwWords = (PackedWord *)allocateMemory(NULL, sizeof(PackedWord) * (uiTotal ? uiTotal : 1), ATDictionaryWords);
+    pwTemp = (PackedWord *)allocateMemory(NULL, sizeof(PackedWord) * (uiTotal ? uiTotal : 1), ATDictionaryWords);
+  }
+  if (pwWords && pwTemp) {
+    uint32_t uiCount = 0;
+    for (i = 0; i < uiPaths; ++i) {
+      memcpy(pwWords + uiCount, pwbLists[i].pwWords, sizeof(PackedWord) * pwbLists[i].uiCount);
+      uiCount += pwbLists[i].uiCount;
+      freeMemory(NULL, pwbLists[i].pwWords);
+      pwbLists[i].pwWords = NULL;
+    }
+    radixSort(pwWords, pwTemp, uiCount);
+    // repeats are adjacent once sorted
+    uint32_t uiUnique = 0;
+    for (i = 0; i < uiCount; ++i) {
+      if (!uiUnique || pwWords[uiUnique - 1] != pwWords[i]) {
+	pwWords[uiUnique++] = pwWords[i];
+      }
+    }
+    dWords = createPackedDictionary(pwWords, uiUnique);
+  }
+  freeMemory(NULL, pwTemp);
+  freeMemory(NULL, pwWords);
+  for (i = 0; i < uiPaths; ++i) {
+    freeMemory(NULL, pwbLists[i].pwWords);
+  }
+  freeMemory(NULL, pwbLists);
+  return dWords;
+}
+
+
+// ----------------- Local Function definitions ---------------------------
+static int8_t collectWord(void * pContext, enum TokenType ttType, const struct TokenView * ptvToken) {
+  struct WordBuffer * pwbList = (struct WordBuffer *)pContext;
+  if (ttType != TTText) {
+    return 0;
+  }
+  if (ptvToken->uiLength != WORD_LENGTH) {
+    return 1;
+  }
+  PackedWord pwWord = encodeLetters(ptvToken->pText);
+  if (pwWord == INVALID_WORD) {
+    return 1;
+  }
+  if (pwbList->uiCount == pwbList->uiCapacity) {
+    uint32_t uiCapacity = pwbList->uiCapacity ? pwbList->uiCapacity * 2 : WORD_BUFFER_START;
+    PackedWord * pwWords = (PackedWord *)reallocateMemory(NULL, pwbList->pwWords, sizeof(PackedWord) * uiCapacity, ATDictionaryWords);
+    if (!pwWords) {
+      return 0;
+    }
+    pwbList->pwWords = pwWords;
+    pwbList->uiCapacity = uiCapacity;
+  }
+  pwbList->pwWords[pwbList->uiCount++] = pwWord;
+  return 1;
+}
+
+static void parseList(void * pContext, uint32_t uiTask, uint32_t uiWorker) {
+  struct MergeRun * pmrRun = (struct MergeRun *)pContext;
+  (void)uiWorker;
+  pmrRun->pwbLists[uiTask].prResult = parseFileParallel(pmrRun->ccaPaths[uiTask], &collectWord, &pmrRun->pwbLists[uiTask], pmrRun->uiListThreads, PPODefault);
+}
+
+static void radixSort(PackedWord * pwWords, PackedWord * pwTemp, uint32_t uiCount) {
+  uint32_t auiOffsets[1u << RADIX_LOW_BITS];
+  radixPass(pwWords, pwTemp, uiCount, 0, RADIX_LOW_BITS, auiOffsets);
+  radixPass(pwTemp, pwWords, uiCount, RADIX_LOW_BITS, RADIX_HIGH_BITS, auiOffsets);
+}
+
+static void radixPass(const PackedWord * cpwFrom, PackedWord * pwTo, uint32_t uiCount, uint8_t uiShift, uint8_t uiBits, uint32_t * puiOffsets) {
+  uint32_t uiBuckets = 1u << uiBits;
+  uint32_t uiMask = uiBuckets - 1;
+  uint32_t i;
+  memset(puiOffsets, 0, sizeof(uint32_t) * uiBuckets);
+  for (i = 0; i < uiCount; ++i) {
+    ++puiOffsets[(cpwFrom[i] >> uiShift) & uiMask];
+  }
+  // turn counts into start offsets of buckets
+  uint32_t uiStart = 0;
+  for (i = 0; i < uiBuckets; ++i) {
+    uint32_t uiBucket = puiOffsets[i];
+    puiOffsets[i] = uiStart;
+    uiStart += uiBucket;
+  }
+  for (i = 0; i < uiCount; ++i) {
+    pwTo[puiOffsets[(cpwFrom[i] >> uiShift) & uiMask]++] = cpwFrom[i];
+  }
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+/*! \file wordlist.h
+  \brief Merging of text word lists.
+  Lists are parsed concurrently, one tokenizer per thread or several per list when there are fewer lists than threads.
+  Their words are merged into one sorted dictionary without repeats.
+*/
+
+#include "dictionary.h"
+#include <stdint.h>
+
+/*! \brief Merge word lists.
+  Parses text word lists concurrently and merges all five letter words of them into one dictionary.
+  Words are sorted by a radix sort on their packed value, so merging takes linear time, and words repeated within or across lists are kept once.
+  Each dictionary created by this function must be destroyed by 'destroyDictionary(Dictionary)' to avoid memory leaks.
+  \param ccaPaths Relative or absolute paths to text word lists.
+  \param uiPaths Amount of lists.
+  \param uiThreads Amount of threads, 0 to use one per core.
+  \param puiFailed Receives the index of the first list that could not be parsed, or 'uiPaths' when the error is not tied to a list. May be NULL.
+  \return Dictionary in alphabetical order, or NULL when a list could not be parsed or memory could not be allocated.
+*/
+Dictionary mergeWordLists(const char * const * ccaPaths, uint32_t uiPaths, uint32_t uiThreads, uint32_t * puiFailed);
@@ -0,0 +1,178 @@
+/*! \file alloc.c
+  \brief Allocator test.
+  Grows, resizes and clears arenas and checks contents, alignment and size, including allocations larger than a block.
+  Allocates aligned memory through malloc and a memory counter, and checks nodes of unrolled lists are accounted.
+  Allocations go through a memory counter, so memory left behind is reported.
+*/
+
+#include "../src/alloc.h"
+#include "../src/list.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_BLOCK_SIZE 4096                      //!< Size of regular blocks of test arena.
+#define TEST_ALIGNMENT 1024                       //!< Alignment of aligned allocations.
+#define TEST_UNROLLED_ENTRIES 1000                //!< Amount of entries of unrolled list, spanning several nodes.
+
+// ----------------- Local Variables --------------------------------------
+
+static uint32_t uiFailures;                       //!< Amount of failed checks.
+
+// ----------------- Local Function declarations --------------------------
+
+/*! \brief Checks arena.
+  Grows the last allocation in place, moves one that has bytes behind it, adds an oversized block and clears the arena.
+  \param aArena Arena to check, empty or cleared.
+  \param uiRound Round of check, the first one starts with an empty arena.
+*/
+static void checkArena(Arena aArena, uint32_t uiRound);
+/*! \brief Checks aligned memory.
+  \param cpaAllocator Allocator to check, NULL for the default.
+*/
+static void checkAligned(const struct Allocator * cpaAllocator);
+/*! \brief Checks memory.
+  \param cpcMemory Memory to check.
+  \param szSize Amount of bytes.
+  \param cValue Value of every byte.
+  \return 1 when all bytes hold the value, else 0.
+*/
+static int8_t isFilled(const char * cpcMemory, size_t szSize, char cValue);
+/*! \brief Checks condition.
+  \param iCondition Condition that must hold.
+  \param ccaName Name of check reported on failure.
+*/
+static void check(int iCondition, const char * ccaName);
+
+// ----------------- Global Function definitions --------------------------
+
+int main(void) {
+  struct MemoryStats msStats;
+  uint32_t i;
+  MemoryCounter mcCounter = createMemoryCounter(NULL);
+  if (!mcCounter) {
+    return 1;
+  }
+  checkAligned(NULL);
+  setDefaultAllocator(getCounterAllocator(mcCounter));
+
+  Arena aArena = createArena(TEST_BLOCK_SIZE, ATOther);
+  check(aArena && !getArenaSize(aArena), "create arena");
+  for (i = 0; aArena && i < 3; ++i) {
+    checkArena(aArena, i);
+  }
+  destroyArena(aArena);
+  getMemoryStats(mcCounter, ATOther, &msStats);
+  check(msStats.uiLive == 0 && msStats.szBytes == 0, "release arena");
+
+  checkAligned(NULL);
+  getMemoryStats(mcCounter, ATListNodes, &msStats);
+  check(msStats.uiAllocations == 1 && msStats.uiLive == 0 && msStats.szPeakBytes >= 2 * TEST_ALIGNMENT, "count aligned memory");
+
+  // nodes of unrolled lists are accounted to the default allocator like the list itself
+  List list = createUnrolledList(sizeof(uint64_t));
+  uint64_t uiItem;
+  for (uiItem = 0; list && uiItem < TEST_UNROLLED_ENTRIES; ++uiItem) {
+    check(addEntry(list, getEnd(list), &uiItem), "add unrolled entry");
+  }
+  getMemoryStats(mcCounter, ATListNodes, &msStats);
+  check(msStats.uiLive > 2 && msStats.szBytes >= TEST_UNROLLED_ENTRIES * sizeof(uint64_t), "count unrolled nodes");
+  destroyList(list);
+  getMemoryStats(mcCounter, ATListNodes, &msStats);
+  check(msStats.uiLive == 0 && msStats.szBytes == 0, "release unrolled nodes");
+
+  setDefaultAllocator(NULL);
+  destroyMemoryCounter(mcCounter);
+  printf("alloc: %u failures\n", uiFailures);
+  return uiFailures ? 1 : 0;
+}
+
+// ----------------- Local Function definitions ---------------------------
+
+static void checkArena(Arena aArena, uint32_t uiRound) {
+  const struct Allocator * cpaArena = getArenaAllocator(aArena);
+  size_t szBlock = getArenaSize(aArena);
+  size_t szSize;
+  char * pMemory = (char *)allocateMemory(cpaArena, 10, ATOther);
+  if (!pMemory) {
+    check(0, "allocate from arena");
+    return;
+  }
+  memset(pMemory, 'a', 10);
+  if (!uiRound) {
+    szBlock = getArenaSize(aArena);
+    check(szBlock >= TEST_BLOCK_SIZE, "allocate first block");
+  }
+  check(getArenaSize(aArena) == szBlock && !((uintptr_t)pMemory % 16), "allocate from first block");
+
+  // the last allocation grows in place while its block has room
+  for (szSize = 16; szSize <= TEST_BLOCK_SIZE / 2; szSize *= 2) {
+    char * pGrown = (char *)reallocateMemory(cpaArena, pMemory, szSize, ATOther);
+    check(pGrown == pMemory && isFilled(pGrown, szSize / 2, 'a'), "grow in place");
+    memset(pGrown, 'a', szSize);
+  }
+  check(getArenaSize(aArena) == szBlock, "grow within block");
+
+  // bytes behind the last allocation must not be overwritten by growing it
+  char * pBytes = (char *)allocateArenaBytes(aArena, 3);
+  check(pBytes != NULL, "allocate bytes");
+  if (pBytes) {
+    memcpy(pBytes, "xyz", 3);
+  }
+  char * pMoved = (char *)reallocateMemory(cpaArena, pMemory, TEST_BLOCK_SIZE / 2 + 16, ATOther);
+  check(pMoved && pMoved != pMemory && isFilled(pMoved, TEST_BLOCK_SIZE / 2, 'a'), "move allocation with bytes behind it");
+  check(!pBytes || !memcmp(pBytes, "xyz", 3), "keep bytes behind moved allocation");
+  check(getArenaSize(aArena) == 2 * szBlock, "grow arena by a block");
+
+  // an allocation larger than a block gets a block of its own
+  char * pLarge = (char *)allocateMemory(cpaArena, 3 * TEST_BLOCK_SIZE, ATOther);
+  check(pLarge && getArenaSize(aArena) >= 2 * szBlock + 3 * TEST_BLOCK_SIZE, "allocate oversized block");
+  if (pLarge) {
+    memset(pLarge, 'b', 3 * TEST_BLOCK_SIZE);
+  }
+  char * pSmall = (char *)allocateMemory(cpaArena, 24, ATOther);
+  check(pSmall && !((uintptr_t)pSmall % 16), "allocate after oversized block");
+  if (pSmall) {
+    memset(pSmall, 'c', 24);
+  }
+  check(!pLarge || isFilled(pLarge, 3 * TEST_BLOCK_SIZE, 'b'), "keep oversized block");
+  check(!pMoved || isFilled(pMoved, TEST_BLOCK_SIZE / 2, 'a'), "keep moved allocation");
+
+  // the kept block still holds old data, zeroed memory has to be cleared
+  clearArena(aArena);
+  check(getArenaSize(aArena) == szBlock, "clear to first block");
+  char * pZeroed = (char *)allocateZeroedMemory(cpaArena, TEST_BLOCK_SIZE / 2, ATOther);
+  check(pZeroed && isFilled(pZeroed, TEST_BLOCK_SIZE / 2, 0), "allocate zeroed from kept block");
+  check(getArenaSize(aArena) == szBlock, "reuse first block");
+  clearArena(aArena);
+}
+
+static void checkAligned(const struct Allocator * cpaAllocator) {
+  char * pMemory = (char *)allocateAlignedMemory(cpaAllocator, TEST_ALIGNMENT, 2 * TEST_ALIGNMENT, ATListNodes);
+  check(pMemory && !((uintptr_t)pMemory % TEST_ALIGNMENT), "allocate aligned memory");
+  if (pMemory) {
+    memset(pMemory, 'a', 2 * TEST_ALIGNMENT);
+  }
+  freeAlignedMemory(cpaAllocator, pMemory);
+  check(!allocateAlignedMemory(cpaAllocator, 3, 6, ATListNodes), "reject alignment other than a power of two");
+  check(!allocateAlignedMemory(cpaAllocator, TEST_ALIGNMENT, TEST_ALIGNMENT + 1, ATListNodes), "reject size other than a multiple of alignment");
+}
+
+static int8_t isFilled(const char * cpcMemory, size_t szSize, char cValue) {
+  size_t i;
+  for (i = 0; i < szSize; ++i) {
+    if (cpcMemory[i] != cValue) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+static void check(int iCondition, const char * ccaName) {
+  if (!iCondition) {
+    fprintf(stderr, "alloc: %s failed\n", ccaName);
+    ++uiFailures;
+  }
+}
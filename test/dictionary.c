@@ -0,0 +1,143 @@
+/*! \file dictionary.c
+  \brief Binary dictionary test.
+  Writes a dictionary file, checks it loads, then checks files with out of range, repeated or unsorted words are rejected,
+  as are files with unknown flags or a presence bitmap that does not match the words.
+*/
+
+#include "../src/dictionary.h"
+#include "../src/word.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TEST_FLAGS 16                             //!< Offset of the flags in the file header.
+#define TEST_WORDS_OFFSET 24                      //!< Offset of the word section offset in the file header.
+#define TEST_INDEX_OFFSET 32                      //!< Offset of the presence bitmap offset in the file header.
+
+// ----------------- Local Variables --------------------------------------
+
+static const char * ccaWords[] = { "crane", "about", "zebra", "moist", "plumb" }; //!< Words of test dictionary.
+static uint32_t uiFailures;                       //!< Amount of failed checks.
+
+// ----------------- Local Function declarations --------------------------
+
+/*! \brief Loads patched file.
+  Copies a dictionary file, overwrites bytes of the copy and loads it.
+  \param ccaPath Path of dictionary file.
+  \param uiSection Offset of the header field holding the offset of the patched section, or 0 to patch relative to the file start.
+  \param uiOffset Offset of patched bytes in section.
+  \param cpData Bytes written.
+  \param szSize Amount of bytes written.
+  \return 1 when patched file loaded, 0 when it was rejected.
+*/
+static int8_t loadPatched(const char * ccaPath, uint32_t uiSection, uint64_t uiOffset, const void * cpData, size_t szSize);
+/*! \brief Loads file with patched word.
+  \param ccaPath Path of dictionary file.
+  \param uiIndex Index of word to replace in sorted word section.
+  \param pwWord Word written instead.
+  \return 1 when patched file loaded, 0 when it was rejected.
+*/
+static int8_t loadPatchedWord(const char * ccaPath, uint32_t uiIndex, PackedWord pwWord);
+/*! \brief Loads file with patched presence bits.
+  Overwrites the byte of the presence bitmap holding the bit of a word.
+  \param ccaPath Path of dictionary file.
+  \param ccaWord Word whose bitmap byte is overwritten.
+  \param uiByte Byte written.
+  \return 1 when patched file loaded, 0 when it was rejected.
+*/
+static int8_t loadPatchedBits(const char * ccaPath, const char * ccaWord, uint8_t uiByte);
+/*! \brief Checks condition.
+  \param iCondition Condition that must hold.
+  \param ccaName Name of check reported on failure.
+*/
+static void check(int iCondition, const char * ccaName);
+
+// ----------------- Global Function definitions --------------------------
+
+int main(void) {
+  PackedWord apwWords[sizeof(ccaWords) / sizeof(ccaWords[0])];
+  uint32_t i;
+  int8_t iWithIndex;
+  for (i = 0; i < sizeof(ccaWords) / sizeof(ccaWords[0]); ++i) {
+    apwWords[i] = encodeWord(ccaWords[i]);
+  }
+  Dictionary dWords = createPackedDictionary(apwWords, sizeof(apwWords) / sizeof(apwWords[0]));
+  char caPath[] = "/tmp/dictionaryXXXXXX";
+  int iFile = mkstemp(caPath);
+  if (!dWords || iFile < 0) {
+    return 1;
+  }
+  close(iFile);
+  for (iWithIndex = 0; iWithIndex < 2; ++iWithIndex) {
+    check(writeDictionary(dWords, caPath, iWithIndex), "write");
+    Dictionary dLoaded = loadDictionary(caPath);
+    check(dLoaded && getWordCount(dLoaded) == getWordCount(dWords) && containsWord(dLoaded, "zebra"), "load");
+    destroyDictionary(dLoaded);
+    dLoaded = loadDictionaryWithOptions(caPath, DOCopied);
+    check(dLoaded && getWordCount(dLoaded) == getWordCount(dWords) && containsWord(dLoaded, "zebra"), "load copied");
+    destroyDictionary(dLoaded);
+    // sorted words are about, crane, moist, plumb, zebra, a replaced word only loads when no bitmap still holds the old one
+    check(loadPatchedWord(caPath, 1, encodeWord("cranf")) == !iWithIndex, iWithIndex ? "reject word missing from bitmap" : "load with patched word");
+    check(!loadPatchedWord(caPath, 4, WORD_SPACE), "reject word out of range");
+    check(!loadPatchedWord(caPath, 0, (PackedWord)-1), "reject word out of range");
+    check(!loadPatchedWord(caPath, 2, encodeWord("crane")), "reject repeated word");
+    check(!loadPatchedWord(caPath, 3, encodeWord("crane")), "reject unsorted word");
+    uint32_t uiFlags = (uint32_t)iWithIndex | 2;
+    check(!loadPatched(caPath, 0, TEST_FLAGS, &uiFlags, sizeof(uiFlags)), "reject unknown flag");
+    if (iWithIndex) {
+      check(loadPatchedBits(caPath, "crane", 0xFF) == 0, "reject bitmap with extra words");
+      check(loadPatchedBits(caPath, "crane", 0x00) == 0, "reject bitmap missing a word");
+    }
+  }
+  unlink(caPath);
+  destroyDictionary(dWords);
+  printf("dictionary: %u failures\n", uiFailures);
+  return uiFailures ? 1 : 0;
+}
+
+// ----------------- Local Function definitions ---------------------------
+
+static int8_t loadPatched(const char * ccaPath, uint32_t uiSection, uint64_t uiOffset, const void * cpData, size_t szSize) {
+  FILE * file = fopen(ccaPath, "rb");
+  if (!file) {
+    return 0;
+  }
+  static char acData[1 << 23];
+  size_t szFile = fread(acData, 1, sizeof(acData), file);
+  fclose(file);
+  uint64_t uiSectionOffset = 0;
+  if (uiSection) {
+    memcpy(&uiSectionOffset, acData + uiSection, sizeof(uiSectionOffset));
+  }
+  memcpy(acData + uiSectionOffset + uiOffset, cpData, szSize);
+  char caPatched[] = "/tmp/dictionaryXXXXXX";
+  int iFile = mkstemp(caPatched);
+  if (iFile < 0) {
+    return 0;
+  }
+  int8_t iWritten = write(iFile, acData, szFile) == (ssize_t)szFile;
+  close(iFile);
+  Dictionary dLoaded = iWritten ? loadDictionary(caPatched) : NULL;
+  unlink(caPatched);
+  destroyDictionary(dLoaded);
+  return dLoaded != NULL;
+}
+
+static int8_t loadPatchedWord(const char * ccaPath, uint32_t uiIndex, PackedWord pwWord) {
+  return loadPatched(ccaPath, TEST_WORDS_OFFSET, uiIndex * sizeof(PackedWord), &pwWord, sizeof(pwWord));
+}
+
+static int8_t loadPatchedBits(const char * ccaPath, const char * ccaWord, uint8_t uiByte) {
+  // the bitmap is an array of little-endian 64 bit words, so bit n lives in byte n / 8
+  return loadPatched(ccaPath, TEST_INDEX_OFFSET, encodeWord(ccaWord) / 8, &uiByte, sizeof(uiByte));
+}
+
+static void check(int iCondition, const char * ccaName) {
+  if (!iCondition) {
+    fprintf(stderr, "dictionary: %s failed\n", ccaName);
+    ++uiFailures;
+  }
+}
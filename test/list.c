@@ -0,0 +1,461 @@
+/*! \file list.c
+  \brief List test.
+  Checks entries are moved between lists sharing options and allocator, and splices between lists of different allocators are rejected without changing either list.
+  Checks ranges are spliced within and between lists, and ranges holding the target iterator are rejected.
+  Checks a pooled list keeps removing and adding entries after taking over the slabs of another.
+  Checks sorting keeps entries of equal keys in order, and a failed append leaves the list as it was.
+  Checks unrolled lists keep, walk and remove payloads of sizes down to a single byte.
+*/
+
+#include "../src/alloc.h"
+#include "../src/list.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_ENTRIES 8                            //!< Amount of entries per list.
+#define TEST_UNROLLED_ENTRIES 300                 //!< Amount of entries per unrolled list, spanning several nodes for every payload size.
+#define TEST_SORT_KEYS 5                          //!< Amount of distinct keys of sorted entries, so every key repeats.
+
+// ----------------- Struct definitions -----------------------------------
+
+/*! \struct SortItem
+  \brief Data of sorted entries.
+*/
+struct SortItem {
+  uint32_t uiKey;                                 //!< Key entries are sorted by.
+  uint32_t uiOrder;                               //!< Position entry was added at, increases among entries of equal key when sort is stable.
+};
+
+/*! \struct FailingAllocator
+  \brief Context of an allocator failing once its budget of allocations is spent.
+*/
+struct FailingAllocator {
+  uint32_t uiBudget;                              //!< Amount of allocations that still succeed.
+  uint32_t uiLive;                                //!< Amount of allocations not freed yet.
+};
+
+// ----------------- Local Variables --------------------------------------
+
+static uint32_t auiValues[2 * TEST_ENTRIES];      //!< Data of entries, borrowed by the lists.
+static struct SortItem asiItems[TEST_UNROLLED_ENTRIES]; //!< Data of sorted entries, borrowed by linked lists and copied by unrolled ones.
+static uint32_t uiFailures;                       //!< Amount of failed checks.
+
+// ----------------- Local Function declarations --------------------------
+
+/*! \brief Creates filled list.
+  \param uiOptions Options of list.
+  \param cpaAllocator Allocator of list, NULL for the default.
+  \param uiFirst Index of first value in 'auiValues'.
+  \return Created list with TEST_ENTRIES entries, or NULL on failure.
+*/
+static List createFilledList(uint32_t uiOptions, const struct Allocator * cpaAllocator, uint32_t uiFirst);
+/*! \brief Checks splice between two lists.
+  \param uiOptions Options of both lists.
+  \param cpaTarget Allocator of target list.
+  \param cpaSource Allocator of source list.
+  \param iExpected 1 when splices must succeed, 0 when they must be rejected.
+  \param ccaName Name of check reported on failure.
+*/
+static void checkSplice(uint32_t uiOptions, const struct Allocator * cpaTarget, const struct Allocator * cpaSource, int8_t iExpected, const char * ccaName);
+/*! \brief Checks splice of ranges.
+  Moves ranges within a list, to its front and from another list, and checks ranges holding the target iterator or running backwards are rejected.
+  \param uiOptions Options of both lists.
+*/
+static void checkSpliceRange(uint32_t uiOptions);
+/*! \brief Checks pooled list after taking over slabs.
+  Splices a whole pooled list into another, then removes entries from both slabs of the target and adds them back.
+*/
+static void checkSlabHandOver();
+/*! \brief Checks failed appends.
+  Appends items holding NULL and items running out of memory halfway, and checks the list is left unchanged and nothing leaks.
+*/
+static void checkAppendRollback();
+/*! \brief Checks stable sort.
+  \param uiOptions Options of list, LOUnrolled for an unrolled list of 'SortItem' payloads.
+*/
+static void checkSort(uint32_t uiOptions);
+/*! \brief Compares keys of two 'SortItem's.
+  \param cpLeft Left item.
+  \param cpRight Right item.
+  \return Negative, zero or positive like 'strcmp'.
+*/
+static int compareItems(const void * cpLeft, const void * cpRight);
+/*! \brief Checks order of list.
+  Walks the list in both directions and compares its data with values of 'auiValues'.
+  \param list List to check.
+  \param cpuiExpected Indices in 'auiValues' of expected data, in order.
+  \param uiCount Expected amount of entries.
+  \param ccaName Name of check reported on failure.
+*/
+static void checkOrder(List list, const uint32_t * cpuiExpected, uint32_t uiCount, const char * ccaName);
+/*! \brief Allocates unless budget is spent.
+  \param pContext 'FailingAllocator' of allocation.
+  \param szSize Amount of bytes.
+  \param atTag Tag of allocation, ignored.
+  \return Allocated memory or NULL.
+*/
+static void * allocateFailing(void * pContext, size_t szSize, enum AllocationTags atTag);
+/*! \brief Resizes unless budget is spent.
+  \param pContext 'FailingAllocator' of allocation.
+  \param pMemory Memory to resize, or NULL to allocate.
+  \param szSize Amount of bytes.
+  \param atTag Tag of allocation, ignored.
+  \return Resized memory or NULL.
+*/
+static void * reallocateFailing(void * pContext, void * pMemory, size_t szSize, enum AllocationTags atTag);
+/*! \brief Frees memory of failing allocator.
+  \param pContext 'FailingAllocator' of allocation.
+  \param pMemory Memory to free.
+*/
+static void freeFailing(void * pContext, void * pMemory);
+/*! \brief Checks unrolled list.
+  Appends entries, walks them in both directions, looks one up by index and removes every other entry.
+  \param uiItemSize Size of payloads.
+*/
+static void checkUnrolled(uint32_t uiItemSize);
+/*! \brief Fills payload.
+  \param pucItem Payload to fill.
+  \param uiItemSize Size of payload.
+  \param uiValue Value payload is derived from.
+*/
+static void fillItem(unsigned char * pucItem, uint32_t uiItemSize, uint32_t uiValue);
+/*! \brief Checks condition.
+  \param iCondition Condition that must hold.
+  \param ccaName Name of check reported on failure.
+*/
+static void check(int iCondition, const char * ccaName);
+
+// ----------------- Global Function definitions --------------------------
+
+int main(void) {
+  uint32_t i;
+  for (i = 0; i < 2 * TEST_ENTRIES; ++i) {
+    auiValues[i] = i;
+  }
+  Arena aFirst = createArena(0, ATListNodes);
+  Arena aSecond = createArena(0, ATListNodes);
+  if (!aFirst || !aSecond) {
+    return 1;
+  }
+  static const uint32_t cauiOptions[] = { LOBorrowedItems, LOPooledNodes | LOBorrowedItems };
+  for (i = 0; i < sizeof(cauiOptions) / sizeof(cauiOptions[0]); ++i) {
+    checkSplice(cauiOptions[i], NULL, NULL, 1, "splice with default allocator");
+    checkSplice(cauiOptions[i], getArenaAllocator(aFirst), getArenaAllocator(aFirst), 1, "splice with same arena");
+    checkSplice(cauiOptions[i], NULL, getArenaAllocator(aFirst), 0, "reject splice from arena to default");
+    checkSplice(cauiOptions[i], getArenaAllocator(aFirst), NULL, 0, "reject splice from default to arena");
+    checkSplice(cauiOptions[i], getArenaAllocator(aFirst), getArenaAllocator(aSecond), 0, "reject splice between arenas");
+  }
+  destroyArena(aFirst);
+  destroyArena(aSecond);
+  for (i = 0; i < sizeof(cauiOptions) / sizeof(cauiOptions[0]); ++i) {
+    checkSpliceRange(cauiOptions[i]);
+  }
+  checkSlabHandOver();
+  checkAppendRollback();
+  for (i = 0; i < TEST_UNROLLED_ENTRIES; ++i) {
+    asiItems[i].uiKey = (i * 7 + 3) % TEST_SORT_KEYS;
+    asiItems[i].uiOrder = i;
+  }
+  checkSort(LOBorrowedItems);
+  checkSort(LOPooledNodes | LOBorrowedItems);
+  checkSort(LOUnrolled);
+  static const uint32_t cauiItemSizes[] = { 1, 2, 3, UNROLLED_ITEM_MAX };
+  for (i = 0; i < sizeof(cauiItemSizes) / sizeof(cauiItemSizes[0]); ++i) {
+    checkUnrolled(cauiItemSizes[i]);
+  }
+  printf("list: %u failures\n", uiFailures);
+  return uiFailures ? 1 : 0;
+}
+
+// ----------------- Local Function definitions ---------------------------
+
+static List createFilledList(uint32_t uiOptions, const struct Allocator * cpaAllocator, uint32_t uiFirst) {
+  List list = createListWithAllocator(uiOptions, cpaAllocator);
+  uint32_t i;
+  for (i = 0; list && i < TEST_ENTRIES; ++i) {
+    if (!addEntry(list, getEnd(list), &auiValues[uiFirst + i])) {
+      destroyList(list);
+      return NULL;
+    }
+  }
+  return list;
+}
+
+static void checkSplice(uint32_t uiOptions, const struct Allocator * cpaTarget, const struct Allocator * cpaSource, int8_t iExpected, const char * ccaName) {
+  List lTarget = createFilledList(uiOptions, cpaTarget, 0);
+  List lSource = createFilledList(uiOptions, cpaSource, TEST_ENTRIES);
+  Iterator it;
+  uint32_t i = 0;
+  if (!lTarget || !lSource) {
+    check(0, "create lists");
+  } else {
+    // pooled lists only accept whole list splices across lists, so that is what is checked for both kinds
+    int8_t iResult = spliceList(lTarget, getEnd(lTarget), lSource, NULL, NULL);
+    check(iResult == iExpected, ccaName);
+    uint32_t uiExpected = iExpected ? 2 * TEST_ENTRIES : TEST_ENTRIES;
+    check(getSize(lTarget) == uiExpected && getSize(lSource) == 2 * TEST_ENTRIES - uiExpected, ccaName);
+    for (it = getBegin(lTarget); it; moveNext(&it), ++i) {
+      check(getCurrent(it) == &auiValues[i], ccaName);
+    }
+    check(i == uiExpected, ccaName);
+  }
+  destroyList(lTarget);
+  destroyList(lSource);
+}
+
+static void checkSpliceRange(uint32_t uiOptions) {
+  static const uint32_t cauiMovedBack[] = { 0, 1, 5, 6, 2, 3, 4, 7 };
+  static const uint32_t cauiMovedFront[] = { 4, 7, 0, 1, 5, 6, 2, 3 };
+  static const uint32_t cauiMovedIn[] = { 4, 9, 10, 7, 0, 1, 5, 6, 2, 3 };
+  static const uint32_t cauiMovedOut[] = { 8, 11, 12, 13, 14, 15 };
+  static const uint32_t cauiSource[] = { 8, 9, 10, 11, 12, 13, 14, 15 };
+  List lTarget = createFilledList(uiOptions, NULL, 0);
+  List lSource = createFilledList(uiOptions, NULL, TEST_ENTRIES);
+  if (!lTarget || !lSource) {
+    check(0, "create lists");
+    destroyList(lTarget);
+    destroyList(lSource);
+    return;
+  }
+  check(spliceList(lTarget, getEntry(lTarget, 6), lTarget, getEntry(lTarget, 2), getEntry(lTarget, 4)), "splice range within list");
+  checkOrder(lTarget, cauiMovedBack, TEST_ENTRIES, "splice range within list");
+  check(!spliceList(lTarget, getEntry(lTarget, 3), lTarget, getEntry(lTarget, 2), getEntry(lTarget, 4)), "reject iterator inside range");
+  check(!spliceList(lTarget, getEntry(lTarget, 2), lTarget, getEntry(lTarget, 2), getEntry(lTarget, 4)), "reject iterator at begin of range");
+  check(!spliceList(lTarget, getEntry(lTarget, 4), lTarget, getEntry(lTarget, 2), getEntry(lTarget, 4)), "reject iterator at end of range");
+  check(!spliceList(lTarget, getEntry(lTarget, 0), lTarget, getEntry(lTarget, 4), getEntry(lTarget, 2)), "reject backward range");
+  checkOrder(lTarget, cauiMovedBack, TEST_ENTRIES, "keep list on rejected splice");
+  check(spliceList(lTarget, NULL, lTarget, getEntry(lTarget, 6), getEnd(lTarget)), "splice range to front");
+  checkOrder(lTarget, cauiMovedFront, TEST_ENTRIES, "splice range to front");
+  // pooled iterators can not leave the slabs of their list one by one
+  Iterator itMoved = getEntry(lSource, 1);
+  if (uiOptions & LOPooledNodes) {
+    check(!spliceList(lTarget, getBegin(lTarget), lSource, getEntry(lSource, 1), getEntry(lSource, 2)), "reject pooled range from other list");
+    checkOrder(lTarget, cauiMovedFront, TEST_ENTRIES, "keep target on rejected splice");
+    checkOrder(lSource, cauiSource, TEST_ENTRIES, "keep source on rejected splice");
+  } else {
+    check(spliceList(lTarget, getBegin(lTarget), lSource, getEntry(lSource, 1), getEntry(lSource, 2)), "splice range from other list");
+    checkOrder(lTarget, cauiMovedIn, TEST_ENTRIES + 2, "splice range from other list");
+    checkOrder(lSource, cauiMovedOut, TEST_ENTRIES - 2, "splice range from other list");
+    check(!removeEntry(lSource, itMoved) && removeEntry(lTarget, itMoved), "move iterator to other list");
+    check(getSize(lTarget) == TEST_ENTRIES + 1 && getSize(lSource) == TEST_ENTRIES - 2, "move iterator to other list");
+  }
+  destroyList(lTarget);
+  destroyList(lSource);
+}
+
+static void checkSlabHandOver() {
+  uint32_t auiExpected[2 * TEST_ENTRIES];
+  List lTarget = createFilledList(LOPooledNodes | LOBorrowedItems, NULL, 0);
+  List lSource = createFilledList(LOPooledNodes | LOBorrowedItems, NULL, TEST_ENTRIES);
+  uint32_t i;
+  if (!lTarget || !lSource) {
+    check(0, "create lists");
+    destroyList(lTarget);
+    destroyList(lSource);
+    return;
+  }
+  for (i = 0; i < 2 * TEST_ENTRIES; ++i) {
+    auiExpected[i] = i;
+  }
+  check(spliceList(lTarget, getEnd(lTarget), lSource, NULL, NULL), "hand over slabs");
+  checkOrder(lTarget, auiExpected, 2 * TEST_ENTRIES, "hand over slabs");
+  // every third entry, from the slabs of both lists, is recycled and then reused by the adds
+  for (i = 2 * TEST_ENTRIES; i-- > 0;) {
+    if (!(i % 3)) {
+      check(removeEntry(lTarget, getEntry(lTarget, i)), "remove entry after hand over");
+    }
+  }
+  check(getSize(lTarget) == 2 * TEST_ENTRIES - (2 * TEST_ENTRIES + 2) / 3, "remove entry after hand over");
+  for (i = 0; i < 2 * TEST_ENTRIES; i += 3) {
+    check(addEntry(lTarget, i ? getEntry(lTarget, i - 1) : NULL, &auiValues[i]), "add entry after hand over");
+  }
+  checkOrder(lTarget, auiExpected, 2 * TEST_ENTRIES, "add entry after hand over");
+  check(getSize(lSource) == 0 && addEntry(lSource, NULL, &auiValues[0]), "add entry to emptied source");
+  checkOrder(lSource, auiExpected, 1, "add entry to emptied source");
+  destroyList(lTarget);
+  destroyList(lSource);
+}
+
+static void checkAppendRollback() {
+  struct FailingAllocator faContext = { UINT32_MAX, 0 };
+  struct Allocator aFailing = { &allocateFailing, NULL, &reallocateFailing, &freeFailing, &faContext };
+  uint32_t auiExpected[2 * TEST_ENTRIES];
+  void * apItems[TEST_ENTRIES];
+  uint32_t i;
+  for (i = 0; i < 2 * TEST_ENTRIES; ++i) {
+    auiExpected[i] = i;
+  }
+  for (i = 0; i < TEST_ENTRIES; ++i) {
+    apItems[i] = &auiValues[TEST_ENTRIES + i];
+  }
+  static const uint32_t cauiOptions[] = { LOBorrowedItems, LOPooledNodes | LOBorrowedItems };
+  for (i = 0; i < sizeof(cauiOptions) / sizeof(cauiOptions[0]); ++i) {
+    List list = createFilledList(cauiOptions[i], &aFailing, 0);
+    if (!list) {
+      check(0, "create list");
+      return;
+    }
+    uint32_t uiLive = faContext.uiLive;
+    apItems[TEST_ENTRIES / 2] = NULL;
+    check(!appendListEntries(list, apItems, TEST_ENTRIES), "reject NULL item");
+    checkOrder(list, auiExpected, TEST_ENTRIES, "keep list on NULL item");
+    apItems[TEST_ENTRIES / 2] = &auiValues[TEST_ENTRIES + TEST_ENTRIES / 2];
+    // a pooled list still has room in its slab, so only entries allocated one by one run out of memory
+    if (!(cauiOptions[i] & LOPooledNodes)) {
+      faContext.uiBudget = TEST_ENTRIES / 2;
+      check(!appendListEntries(list, apItems, TEST_ENTRIES), "fail append");
+      check(faContext.uiLive == uiLive, "release entries of failed append");
+      checkOrder(list, auiExpected, TEST_ENTRIES, "keep list on failed append");
+      faContext.uiBudget = UINT32_MAX;
+    }
+    check(appendListEntries(list, apItems, TEST_ENTRIES), "append after failure");
+    checkOrder(list, auiExpected, 2 * TEST_ENTRIES, "append after failure");
+    destroyList(list);
+  }
+  check(faContext.uiLive == 0, "free lists");
+  List list = createUnrolledList(sizeof(uint32_t));
+  for (i = 0; list && i < TEST_ENTRIES; ++i) {
+    check(addEntry(list, getEnd(list), &auiValues[i]), "append unrolled entry");
+  }
+  apItems[TEST_ENTRIES / 2] = NULL;
+  check(list && !appendListEntries(list, apItems, TEST_ENTRIES) && getSize(list) == TEST_ENTRIES, "reject NULL unrolled item");
+  destroyList(list);
+}
+
+static void checkSort(uint32_t uiOptions) {
+  List list = uiOptions & LOUnrolled ? createUnrolledList(sizeof(struct SortItem)) : createListWithOptions(uiOptions);
+  const struct SortItem * csiPrevious = NULL;
+  Iterator it;
+  uint32_t i;
+  if (!list) {
+    check(0, "create list");
+    return;
+  }
+  for (i = 0; i < TEST_UNROLLED_ENTRIES; ++i) {
+    check(addEntry(list, getEnd(list), &asiItems[i]), "add entry to sort");
+  }
+  check(sortList(list, &compareItems), "sort list");
+  for (i = 0, it = getBegin(list); it; moveNext(&it), ++i) {
+    const struct SortItem * csiItem = (const struct SortItem *)getCurrent(it);
+    check(csiItem->uiOrder < TEST_UNROLLED_ENTRIES && csiItem->uiKey == asiItems[csiItem->uiOrder].uiKey, "keep sorted data");
+    if (csiPrevious) {
+      check(csiPrevious->uiKey <= csiItem->uiKey, "sort by key");
+      check(csiPrevious->uiKey != csiItem->uiKey || csiPrevious->uiOrder < csiItem->uiOrder, "keep order of equal keys");
+    }
+    csiPrevious = csiItem;
+  }
+  check(i == TEST_UNROLLED_ENTRIES && getSize(list) == TEST_UNROLLED_ENTRIES, "keep sorted entries");
+  for (i = 0, it = getEnd(list); it; movePrevious(&it)) {
+    ++i;
+  }
+  check(i == TEST_UNROLLED_ENTRIES, "walk sorted list backward");
+  destroyList(list);
+}
+
+static int compareItems(const void * cpLeft, const void * cpRight) {
+  uint32_t uiLeft = ((const struct SortItem *)cpLeft)->uiKey;
+  uint32_t uiRight = ((const struct SortItem *)cpRight)->uiKey;
+  return (uiLeft > uiRight) - (uiLeft < uiRight);
+}
+
+static void checkOrder(List list, const uint32_t * cpuiExpected, uint32_t uiCount, const char * ccaName) {
+  Iterator it;
+  uint32_t i;
+  check(getSize(list) == uiCount, ccaName);
+  for (i = 0, it = getBegin(list); it; moveNext(&it), ++i) {
+    check(i < uiCount && getCurrent(it) == &auiValues[cpuiExpected[i]], ccaName);
+  }
+  check(i == uiCount, ccaName);
+  for (i = uiCount, it = getEnd(list); it && i; movePrevious(&it)) {
+    check(getCurrent(it) == &auiValues[cpuiExpected[--i]], ccaName);
+  }
+  check(!it && !i, ccaName);
+}
+
+static void * allocateFailing(void * pContext, size_t szSize, enum AllocationTags atTag) {
+  struct FailingAllocator * pfaContext = (struct FailingAllocator *)pContext;
+  void * pMemory = pfaContext->uiBudget ? malloc(szSize) : NULL;
+  if (pMemory) {
+    --pfaContext->uiBudget;
+    ++pfaContext->uiLive;
+  }
+  return pMemory;
+}
+
+static void * reallocateFailing(void * pContext, void * pMemory, size_t szSize, enum AllocationTags atTag) {
+  struct FailingAllocator * pfaContext = (struct FailingAllocator *)pContext;
+  if (!pMemory) {
+    return allocateFailing(pContext, szSize, atTag);
+  }
+  pMemory = pfaContext->uiBudget ? realloc(pMemory, szSize) : NULL;
+  if (pMemory) {
+    --pfaContext->uiBudget;
+  }
+  return pMemory;
+}
+
+static void freeFailing(void * pContext, void * pMemory) {
+  if (pMemory) {
+    --((struct FailingAllocator *)pContext)->uiLive;
+    free(pMemory);
+  }
+}
+
+static void checkUnrolled(uint32_t uiItemSize) {
+  unsigned char aucItem[UNROLLED_ITEM_MAX];
+  List list = createUnrolledList(uiItemSize);
+  Iterator it;
+  uint32_t i;
+  if (!list) {
+    check(0, "create unrolled list");
+    return;
+  }
+  for (i = 0; i < TEST_UNROLLED_ENTRIES; ++i) {
+    fillItem(aucItem, uiItemSize, i);
+    check(addEntry(list, getEnd(list), aucItem), "append unrolled entry");
+  }
+  check(getSize(list) == TEST_UNROLLED_ENTRIES, "unrolled size");
+  for (i = 0, it = getBegin(list); it; moveNext(&it), ++i) {
+    fillItem(aucItem, uiItemSize, i);
+    check(i < TEST_UNROLLED_ENTRIES && !memcmp(getCurrent(it), aucItem, uiItemSize), "walk unrolled list forward");
+    check(!((uintptr_t)getCurrent(it) & 1), "even unrolled payload");
+  }
+  check(i == TEST_UNROLLED_ENTRIES, "walk unrolled list forward");
+  for (i = TEST_UNROLLED_ENTRIES, it = getEnd(list); it; movePrevious(&it)) {
+    fillItem(aucItem, uiItemSize, --i);
+    check(!memcmp(getCurrent(it), aucItem, uiItemSize), "walk unrolled list backward");
+  }
+  check(i == 0, "walk unrolled list backward");
+  fillItem(aucItem, uiItemSize, TEST_UNROLLED_ENTRIES / 2);
+  check(!memcmp(getCurrent(getEntry(list, TEST_UNROLLED_ENTRIES / 2)), aucItem, uiItemSize), "get unrolled entry");
+  // removing moves entries within their node, so each removal looks its entry up again
+  for (i = TEST_UNROLLED_ENTRIES; i-- > 0;) {
+    if (i & 1) {
+      check(removeEntry(list, getEntry(list, i)), "remove unrolled entry");
+    }
+  }
+  check(getSize(list) == TEST_UNROLLED_ENTRIES / 2, "unrolled size after removal");
+  for (i = 0, it = getBegin(list); it; moveNext(&it), i += 2) {
+    fillItem(aucItem, uiItemSize, i);
+    check(i < TEST_UNROLLED_ENTRIES && !memcmp(getCurrent(it), aucItem, uiItemSize), "walk unrolled list after removal");
+  }
+  check(i == TEST_UNROLLED_ENTRIES, "walk unrolled list after removal");
+  destroyList(list);
+}
+
+static void fillItem(unsigned char * pucItem, uint32_t uiItemSize, uint32_t uiValue) {
+  uint32_t i;
+  for (i = 0; i < uiItemSize; ++i) {
+    pucItem[i] = (unsigned char)(uiValue * 7 + i);
+  }
+}
+
+static void check(int iCondition, const char * ccaName) {
+  if (!iCondition) {
+    fprintf(stderr, "list: %s failed\n", ccaName);
+    ++uiFailures;
+  }
+}
@@ -0,0 +1,146 @@
+/*! \file patterns.c
+  \brief Pattern matrix cache test.
+  Builds and caches a matrix, checks the cache is loaded, then patches one cell out of range and checks the cache is rejected and rebuilt.
+  Also checks digits of pattern codes, including positions past the end of a word.
+*/
+
+#include "../src/dictionary.h"
+#include "../src/feedback.h"
+#include "../src/patterns.h"
+#include "../src/word.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TEST_DATA_OFFSET 64                       //!< Offset of the matrix in a cache file.
+#define TEST_CELL 7                               //!< Cell patched in the cache file.
+
+// ----------------- Local Variables --------------------------------------
+
+static const char * ccaWords[] = { "crane", "about", "zebra", "moist", "plumb" }; //!< Words of test dictionary.
+static uint32_t uiFailures;                       //!< Amount of failed checks.
+
+// ----------------- Local Function declarations --------------------------
+
+/*! \brief Checks matrix.
+  Compares every cell of a matrix with the pattern computed for its pair of words.
+  \param pmPatterns Matrix to check.
+  \param dWords Dictionary of matrix.
+  \return 1 when all cells match, else 0.
+*/
+static int8_t checkMatrix(PatternMatrix pmPatterns, Dictionary dWords);
+/*! \brief Access cache cell.
+  Reads a cell of a cache file and optionally overwrites it.
+  \param ccaPath Path of cache file.
+  \param pPattern Value to write, or NULL to only read.
+  \return Cell read before writing, or -1 when file could not be accessed.
+*/
+static int accessCell(const char * ccaPath, const Pattern * pPattern);
+/*! \brief Checks condition.
+  \param iCondition Condition that must hold.
+  \param ccaName Name of check reported on failure.
+*/
+static void check(int iCondition, const char * ccaName);
+
+// ----------------- Global Function definitions --------------------------
+
+int main(void) {
+  PackedWord apwWords[sizeof(ccaWords) / sizeof(ccaWords[0])];
+  uint8_t auiDigits[WORD_LENGTH] = { 2, 0, 1, 2, 1 };
+  Pattern pPattern = encodePattern(auiDigits);
+  uint32_t i;
+  for (i = 0; i < WORD_LENGTH; ++i) {
+    check(getPatternDigit(pPattern, (uint8_t)i) == auiDigits[i], "read digit");
+  }
+  // positions past the end must not wrap around to the first digits
+  for (i = WORD_LENGTH; i <= UINT8_MAX && getPatternDigit(pPattern, (uint8_t)i) == INVALID_DIGIT; ++i) {
+  }
+  check(i > UINT8_MAX, "reject digit out of range");
+  for (i = 0; i < sizeof(ccaWords) / sizeof(ccaWords[0]); ++i) {
+    apwWords[i] = encodeWord(ccaWords[i]);
+  }
+  Dictionary dWords = createPackedDictionary(apwWords, sizeof(apwWords) / sizeof(apwWords[0]));
+  char caListPath[] = "/tmp/patternsXXXXXX";
+  int iFile = mkstemp(caListPath);
+  if (!dWords || iFile < 0) {
+    return 1;
+  }
+  close(iFile);
+  char caCachePath[sizeof(caListPath) + sizeof(".patterns")];
+  snprintf(caCachePath, sizeof(caCachePath), "%s.patterns", caListPath);
+
+  PatternMatrix pmPatterns = openPatternMatrix(caListPath, dWords, 1);
+  check(pmPatterns && checkMatrix(pmPatterns, dWords), "build");
+  destroyPatternMatrix(pmPatterns);
+  pmPatterns = loadPatternMatrix(caCachePath, dWords);
+  check(pmPatterns && checkMatrix(pmPatterns, dWords), "load cache");
+  destroyPatternMatrix(pmPatterns);
+  int iCell = accessCell(caCachePath, NULL);
+  check(iCell >= 0 && iCell < PATTERN_COUNT, "read cell");
+
+  // every value from PATTERN_COUNT up to 255, the increment wraps to 0 after the last
+  Pattern pBad = PATTERN_COUNT;
+  for (; pBad >= PATTERN_COUNT; ++pBad) {
+    accessCell(caCachePath, &pBad);
+    pmPatterns = loadPatternMatrix(caCachePath, dWords);
+    check(!pmPatterns, "reject cell out of range");
+    destroyPatternMatrix(pmPatterns);
+  }
+  pmPatterns = openPatternMatrix(caListPath, dWords, 1);
+  check(pmPatterns && checkMatrix(pmPatterns, dWords), "rebuild");
+  destroyPatternMatrix(pmPatterns);
+  check(accessCell(caCachePath, NULL) == iCell, "rewrite cache");
+  pmPatterns = loadPatternMatrix(caCachePath, dWords);
+  check(pmPatterns && checkMatrix(pmPatterns, dWords), "load rewritten cache");
+  destroyPatternMatrix(pmPatterns);
+
+  unlink(caCachePath);
+  unlink(caListPath);
+  destroyDictionary(dWords);
+  printf("patterns: %u failures\n", uiFailures);
+  return uiFailures ? 1 : 0;
+}
+
+// ----------------- Local Function definitions ---------------------------
+
+static int8_t checkMatrix(PatternMatrix pmPatterns, Dictionary dWords) {
+  uint32_t i, j;
+  if (getPatternMatrixSize(pmPatterns) != getWordCount(dWords)) {
+    return 0;
+  }
+  for (i = 0; i < getWordCount(dWords); ++i) {
+    const Pattern * cpRow = getPatternRow(pmPatterns, i);
+    for (j = 0; j < getWordCount(dWords); ++j) {
+      if (cpRow[j] != computePattern(getWord(dWords, i), getWord(dWords, j))) {
+	return 0;
+      }
+    }
+  }
+  return 1;
+}
+
+static int accessCell(const char * ccaPath, const Pattern * pPattern) {
+  FILE * file = fopen(ccaPath, "r+b");
+  Pattern pCell;
+  if (!file) {
+    return -1;
+  }
+  int8_t iResult = !fseek(file, TEST_DATA_OFFSET + TEST_CELL, SEEK_SET) && fread(&pCell, 1, 1, file) == 1;
+  if (iResult && pPattern) {
+    iResult = !fseek(file, TEST_DATA_OFFSET + TEST_CELL, SEEK_SET) && fwrite(pPattern, 1, 1, file) == 1;
+  }
+  if (fclose(file)) {
+    iResult = 0;
+  }
+  return iResult ? pCell : -1;
+}
+
+static void check(int iCondition, const char * ccaName) {
+  if (!iCondition) {
+    fprintf(stderr, "patterns: %s failed\n", ccaName);
+    ++uiFailures;
+  }
+}
@@ -0,0 +1,218 @@
+/*! \file reload.c
+  \brief Dictionary reload test.
+  Publishes snapshots while reader threads acquire them and checks every reader sees a consistent snapshot.
+  Then watches a binary dictionary, rewrites it in place and checks the new words are published while the old snapshot stays readable.
+*/
+
+#include "../src/dictionary.h"
+#include "../src/parallel.h"
+#include "../src/reload.h"
+#include "../src/word.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define TEST_READERS 4                            //!< Most reader threads, more readers than cores only starve the publisher.
+#define TEST_PUBLICATIONS 3000                    //!< Amount of dictionaries published while readers run.
+#define TEST_SIZES 50                             //!< Amount of distinct dictionary sizes, a snapshot of version v holds v % TEST_SIZES + 1 words.
+#define TEST_WAIT_MS 5000                         //!< Longest wait for the watcher to publish a rewritten list.
+
+// ----------------- Local Variables --------------------------------------
+
+static DictionarySource dsShared;                 //!< Source readers acquire from.
+static int iStop;                                 //!< Set to end reader threads, accessed atomically.
+static uint64_t auiReads[TEST_READERS];           //!< Amount of snapshots acquired per reader.
+static uint32_t uiFailures;                       //!< Amount of failed checks.
+
+// ----------------- Local Function declarations --------------------------
+
+/*! \brief Creates dictionary.
+  \param uiCount Amount of distinct words.
+  \param uiFirst Index of first word, words are numbered in base 26.
+  \return Created dictionary or NULL when memory could not be allocated.
+*/
+static Dictionary createTestDictionary(uint32_t uiCount, uint32_t uiFirst);
+/*! \brief Read snapshots.
+  Reader thread acquiring snapshots until 'iStop' is set, checks the size of each matches its version.
+  \param pArgument Index of reader.
+  \return NULL.
+*/
+static void * readSnapshots(void * pArgument);
+/*! \brief Load copied dictionary.
+  Loader of watched lists, reads binary dictionaries into memory.
+  \param ccaPath Path of dictionary file.
+  \return Loaded dictionary or NULL.
+*/
+static Dictionary loadCopied(const char * ccaPath);
+/*! \brief Rewrite in place.
+  Writes a dictionary to a second file and copies that into an existing file, truncating it first.
+  \param dWords Dictionary to write.
+  \param ccaPath Path of existing file.
+  \return 1 on success, else 0.
+*/
+static int8_t rewriteInPlace(Dictionary dWords, const char * ccaPath);
+/*! \brief Checks dictionary.
+  \param dWords Dictionary to check.
+  \param uiCount Expected amount of words.
+  \param uiFirst Expected index of first word.
+  \return 1 when dictionary holds the words of 'createTestDictionary(uiCount, uiFirst)', else 0.
+*/
+static int8_t checkDictionary(Dictionary dWords, uint32_t uiCount, uint32_t uiFirst);
+/*! \brief Checks condition.
+  \param iCondition Condition that must hold.
+  \param ccaName Name of check reported on failure.
+*/
+static void check(int iCondition, const char * ccaName);
+
+// ----------------- Global Function definitions --------------------------
+
+int main(void) {
+  pthread_t atReaders[TEST_READERS];
+  uint32_t uiReaders = getCoreCount() < TEST_READERS ? getCoreCount() : TEST_READERS;
+  uint32_t i;
+  uint64_t uiReads = 0;
+  dsShared = createDictionarySource(createTestDictionary(1, 0));
+  if (!dsShared) {
+    return 1;
+  }
+  for (i = 0; i < uiReaders; ++i) {
+    if (pthread_create(&atReaders[i], NULL, &readSnapshots, (void *)(uintptr_t)i)) {
+      return 1;
+    }
+  }
+  for (i = 1; i <= TEST_PUBLICATIONS; ++i) {
+    check(publishDictionary(dsShared, createTestDictionary(i % TEST_SIZES + 1, 0)), "publish");
+  }
+  __atomic_store_n(&iStop, 1, __ATOMIC_SEQ_CST);
+  for (i = 0; i < uiReaders; ++i) {
+    pthread_join(atReaders[i], NULL);
+    uiReads += auiReads[i];
+    check(auiReads[i] > 0, "read snapshots");
+  }
+  destroyDictionarySource(dsShared);
+
+  // a served binary list rewritten in place must neither change nor truncate the snapshot matches still use
+  char caPath[] = "/tmp/reloadXXXXXX";
+  int iFile = mkstemp(caPath);
+  Dictionary dOld = createTestDictionary(100, 0);
+  Dictionary dNew = createTestDictionary(3, 1000);
+  if (iFile < 0 || !dOld || !dNew) {
+    return 1;
+  }
+  close(iFile);
+  check(writeDictionary(dOld, caPath, 1), "write dictionary");
+  DictionarySource dsSource = createDictionarySource(loadCopied(caPath));
+  check(dsSource && watchWordList(dsSource, caPath, &loadCopied), "watch dictionary");
+  if (dsSource) {
+    DictionarySnapshot dsOld = acquireSnapshot(dsSource);
+    check(rewriteInPlace(dNew, caPath), "rewrite dictionary");
+    DictionarySnapshot dsCurrent = acquireSnapshot(dsSource);
+    struct timespec tsWait = { 0, 1000000 };
+    for (i = 0; i < TEST_WAIT_MS && !getSnapshotVersion(dsCurrent); ++i) {
+      releaseSnapshot(dsCurrent);
+      nanosleep(&tsWait, NULL);
+      dsCurrent = acquireSnapshot(dsSource);
+    }
+    check(getSnapshotVersion(dsCurrent) == 1 && checkDictionary(getSnapshotDictionary(dsCurrent), 3, 1000), "reload rewritten dictionary");
+    check(checkDictionary(getSnapshotDictionary(dsOld), 100, 0), "keep old snapshot");
+    releaseSnapshot(dsCurrent);
+    releaseSnapshot(dsOld);
+  }
+  destroyDictionarySource(dsSource);
+  destroyDictionary(dOld);
+  destroyDictionary(dNew);
+  unlink(caPath);
+  printf("reload: %lu reads, %u failures\n", (unsigned long)uiReads, uiFailures);
+  return uiFailures ? 1 : 0;
+}
+
+// ----------------- Local Function definitions ---------------------------
+
+static Dictionary createTestDictionary(uint32_t uiCount, uint32_t uiFirst) {
+  PackedWord * pwWords = (PackedWord *)malloc(sizeof(PackedWord) * uiCount);
+  char caWord[WORD_LENGTH + 1] = "aaaaa";
+  uint32_t i, j, uiIndex;
+  if (!pwWords) {
+    return NULL;
+  }
+  for (i = 0; i < uiCount; ++i) {
+    for (j = 0, uiIndex = uiFirst + i; j < WORD_LENGTH; ++j, uiIndex /= 26) {
+      caWord[j] = (char)('a' + uiIndex % 26);
+    }
+    pwWords[i] = encodeWord(caWord);
+  }
+  Dictionary dWords = createPackedDictionary(pwWords, uiCount);
+  free(pwWords);
+  return dWords;
+}
+
+static void * readSnapshots(void * pArgument) {
+  uint32_t uiReader = (uint32_t)(uintptr_t)pArgument;
+  while (!__atomic_load_n(&iStop, __ATOMIC_SEQ_CST)) {
+    DictionarySnapshot dsSnapshot = acquireSnapshot(dsShared);
+    if (getWordCount(getSnapshotDictionary(dsSnapshot)) != getSnapshotVersion(dsSnapshot) % TEST_SIZES + 1) {
+      check(0, "consistent snapshot");
+      __atomic_store_n(&iStop, 1, __ATOMIC_SEQ_CST);
+    }
+    releaseSnapshot(dsSnapshot);
+    ++auiReads[uiReader];
+  }
+  return NULL;
+}
+
+static Dictionary loadCopied(const char * ccaPath) {
+  return loadDictionaryWithOptions(ccaPath, DOCopied);
+}
+
+static int8_t rewriteInPlace(Dictionary dWords, const char * ccaPath) {
+  char caTemporary[] = "/tmp/reloadXXXXXX";
+  int iFile = mkstemp(caTemporary);
+  if (iFile < 0) {
+    return 0;
+  }
+  close(iFile);
+  FILE * fileIn = writeDictionary(dWords, caTemporary, 1) ? fopen(caTemporary, "rb") : NULL;
+  FILE * fileOut = fileIn ? fopen(ccaPath, "wb") : NULL;
+  int8_t iResult = fileOut != NULL;
+  char acBuffer[65536];
+  size_t szRead;
+  while (iResult && (szRead = fread(acBuffer, 1, sizeof(acBuffer), fileIn)) > 0) {
+    iResult = fwrite(acBuffer, 1, szRead, fileOut) == szRead;
+  }
+  if (fileOut && fclose(fileOut)) {
+    iResult = 0;
+  }
+  if (fileIn) {
+    fclose(fileIn);
+  }
+  unlink(caTemporary);
+  return iResult;
+}
+
+static int8_t checkDictionary(Dictionary dWords, uint32_t uiCount, uint32_t uiFirst) {
+  Dictionary dExpected;
+  uint32_t i;
+  int8_t iResult;
+  if (getWordCount(dWords) != uiCount) {
+    return 0;
+  }
+  dExpected = createTestDictionary(uiCount, uiFirst);
+  iResult = dExpected != NULL;
+  for (i = 0; iResult && i < uiCount; ++i) {
+    iResult = containsPackedWord(dWords, getWord(dExpected, i)) && containsPackedWord(dExpected, getWord(dWords, i));
+  }
+  destroyDictionary(dExpected);
+  return iResult;
+}
+
+static void check(int iCondition, const char * ccaName) {
+  if (!iCondition) {
+    fprintf(stderr, "reload: %s failed\n", ccaName);
+    __atomic_add_fetch(&uiFailures, 1, __ATOMIC_SEQ_CST);
+  }
+}
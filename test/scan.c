@@ -0,0 +1,104 @@
+/*! \file scan.c
+  \brief Scanner test.
+  Checks the SSE2 and AVX2 scanners against the scalar one at every alignment of a cache line and every length up to three AVX2 blocks, so every tail length around the 16 and 32 byte boundaries is covered.
+  Runs end either at a non-letter, including every non-ASCII byte, or at the end of the buffer while letters follow it.
+  The AVX2 scanner is skipped when the CPU does not support it.
+*/
+
+#include "../src/scan.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST_ALIGNMENTS 64                        //!< Amount of start offsets checked, one cache line.
+#define TEST_MAX_LENGTH 96                        //!< Longest buffer checked, three AVX2 blocks.
+#define TEST_BUFFER_SIZE (TEST_ALIGNMENTS + TEST_MAX_LENGTH + 32) //!< Size of test buffer, leaves letters behind the longest run.
+
+// ----------------- Local Variables --------------------------------------
+
+static const unsigned char aucStoppers[] = { 0x00, '\n', ';', '@', '[', '`', '{', 0x7F, 0x80, 0x9A, 0xC1, 0xDA, 0xE1, 0xFA, 0xFF }; //!< Bytes ending runs, next to the letter ranges, with and without the case bit and high bit set.
+static uint64_t uiChecks;                         //!< Amount of checks run.
+static uint64_t uiFailures;                       //!< Amount of failed checks.
+
+// ----------------- Local Function declarations --------------------------
+
+/*! \brief Checks scanners on buffer.
+  Compares every vectorized scanner supported by the CPU to the scalar scanner and reports differences.
+  \param ccaData Buffer to scan.
+  \param szLength Amount of bytes to scan.
+  \param iAVX2 1 when AVX2 scanner is checked, 0 otherwise.
+*/
+static void checkScanners(const char * ccaData, size_t szLength, int iAVX2);
+/*! \brief Fills buffer with letters.
+  Alternates lower and upper case letters, including the first and last of each range.
+  \param pData Buffer to fill.
+  \param szLength Amount of bytes to fill.
+*/
+static void fillLetters(char * pData, size_t szLength);
+
+// ----------------- Global Function definitions --------------------------
+
+int main(void) {
+  int iAVX2 = __builtin_cpu_supports("avx2");
+  char * pBuffer = (char *)aligned_alloc(64, TEST_BUFFER_SIZE);
+  char * pData;
+  size_t szAlign, szLength, szStop, i;
+  uint32_t uiByte;
+  if (!pBuffer) {
+    return 1;
+  }
+  for (szAlign = 0; szAlign < TEST_ALIGNMENTS; ++szAlign) {
+    pData = pBuffer + szAlign;
+    for (szLength = 0; szLength <= TEST_MAX_LENGTH; ++szLength) {
+      fillLetters(pBuffer, TEST_BUFFER_SIZE);
+      checkScanners(pData, szLength, iAVX2);
+      for (szStop = 0; szStop < szLength; ++szStop) {
+	for (i = 0; i < sizeof(aucStoppers); ++i) {
+	  pData[szStop] = (char)aucStoppers[i];
+	  checkScanners(pData, szLength, iAVX2);
+	}
+	pData[szStop] = 'q';
+      }
+    }
+  }
+  // every byte value at every position of one AVX2 block, which spans two SSE2 blocks
+  for (szAlign = 0; szAlign < TEST_ALIGNMENTS; ++szAlign) {
+    pData = pBuffer + szAlign;
+    fillLetters(pBuffer, TEST_BUFFER_SIZE);
+    for (szStop = 0; szStop < 32; ++szStop) {
+      for (uiByte = 0; uiByte < 256; ++uiByte) {
+	pData[szStop] = (char)uiByte;
+	checkScanners(pData, 32, iAVX2);
+	checkScanners(pData, szStop + 1, iAVX2);
+      }
+      pData[szStop] = 'q';
+    }
+  }
+  free(pBuffer);
+  printf("scan: %llu checks, %llu failures%s\n", (unsigned long long)uiChecks, (unsigned long long)uiFailures, iAVX2 ? "" : ", AVX2 not supported");
+  return uiFailures ? 1 : 0;
+}
+
+// ----------------- Local Function definitions ---------------------------
+
+static void checkScanners(const char * ccaData, size_t szLength, int iAVX2) {
+  size_t szExpected = scanLettersScalar(ccaData, szLength);
+  size_t szSSE2 = scanLettersSSE2(ccaData, szLength);
+  size_t szAVX2 = iAVX2 ? scanLettersAVX2(ccaData, szLength) : szExpected;
+  size_t szDispatched = scanLetters(ccaData, szLength);
+  ++uiChecks;
+  if (szSSE2 != szExpected || szAVX2 != szExpected || szDispatched != szExpected) {
+    if (uiFailures++ < 16) {
+      fprintf(stderr, "scan: offset %u length %zu: scalar %zu, SSE2 %zu, AVX2 %zu, dispatched %zu\n", (unsigned)((uintptr_t)ccaData % 64), szLength, szExpected, szSSE2, szAVX2, szDispatched);
+    }
+  }
+}
+
+static void fillLetters(char * pData, size_t szLength) {
+  static const char ccaLetters[] = "azAZbyBYmnMN";
+  size_t i;
+  for (i = 0; i < szLength; ++i) {
+    pData[i] = ccaLetters[i % (sizeof(ccaLetters) - 1)];
+  }
+}
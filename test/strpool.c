@@ -0,0 +1,117 @@
+/*! \file strpool.c
+  \brief String pool test.
+  Stores and interns strings of all sizes, including strings larger than a block, and checks them after clearing and refilling the pool.
+  Allocations go through a memory counter, so memory left behind after destroying the pool is reported.
+*/
+
+#include "../src/alloc.h"
+#include "../src/strpool.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_STRINGS 4000                         //!< Amount of strings stored per round.
+#define TEST_LONG_LENGTH (100 * 1024)             //!< Length of strings larger than a pool block.
+
+// ----------------- Local Variables --------------------------------------
+
+static char acText[TEST_LONG_LENGTH + 8];         //!< Source of string contents, strings start at its first seven characters.
+static uint32_t uiFailures;                       //!< Amount of failed checks.
+
+// ----------------- Local Function declarations --------------------------
+
+/*! \brief Length of test string.
+  Every 1000th string is larger than a pool block, the others are short.
+  \param uiIndex Index of string.
+  \return Length of string.
+*/
+static uint32_t getTestLength(uint32_t uiIndex);
+/*! \brief Fills pool.
+  Stores test strings, interns every string twice and checks all copies.
+  \param spPool Pool to fill.
+*/
+static void fillPool(StringPool spPool);
+/*! \brief Checks condition.
+  \param iCondition Condition that must hold.
+  \param ccaName Name of check reported on failure.
+*/
+static void check(int iCondition, const char * ccaName);
+
+// ----------------- Global Function definitions --------------------------
+
+int main(void) {
+  struct MemoryStats msStats;
+  uint32_t uiRound;
+  uint32_t i;
+  for (i = 0; i < sizeof(acText); ++i) {
+    acText[i] = 'a' + i % 23;
+  }
+  MemoryCounter mcCounter = createMemoryCounter(NULL);
+  if (!mcCounter) {
+    return 1;
+  }
+  setDefaultAllocator(getCounterAllocator(mcCounter));
+  StringPool spPool = createStringPool();
+  check(spPool != NULL, "create");
+  for (uiRound = 0; spPool && uiRound < 3; ++uiRound) {
+    fillPool(spPool);
+    clearStringPool(spPool);
+    check(getPooledStringCount(spPool) == 0 && getStringPoolSize(spPool) == 0, "clear");
+  }
+  destroyStringPool(spPool);
+  getMemoryStats(mcCounter, ATDictionaryWords, &msStats);
+  check(msStats.uiLive == 0 && msStats.szBytes == 0, "release all memory");
+  setDefaultAllocator(NULL);
+  destroyMemoryCounter(mcCounter);
+  printf("strpool: %u failures\n", uiFailures);
+  return uiFailures ? 1 : 0;
+}
+
+// ----------------- Local Function definitions ---------------------------
+
+static uint32_t getTestLength(uint32_t uiIndex) {
+  return uiIndex % 1000 == 999 ? TEST_LONG_LENGTH : uiIndex % 37;
+}
+
+static void fillPool(StringPool spPool) {
+  static const char * ccaStored[TEST_STRINGS];
+  static const char * ccaInterned[TEST_STRINGS];
+  size_t szBytes = 0;
+  uint32_t uiStrings = TEST_STRINGS;
+  uint32_t uiLength;
+  uint32_t uiFirst;
+  uint32_t i;
+  for (i = 0; i < TEST_STRINGS; ++i) {
+    uiLength = getTestLength(i);
+    ccaStored[i] = storeString(spPool, acText + i % 7, uiLength);
+    ccaInterned[i] = internString(spPool, acText + i % 7, uiLength);
+    szBytes += (size_t)uiLength + 1;
+    check(ccaStored[i] && ccaInterned[i] && ccaStored[i] != ccaInterned[i], "store");
+  }
+  for (i = 0; i < TEST_STRINGS; ++i) {
+    uiLength = getTestLength(i);
+    // equal strings come back as the copy interned first
+    uiFirst = 0;
+    while (getTestLength(uiFirst) != uiLength || memcmp(acText + uiFirst % 7, acText + i % 7, uiLength)) {
+      ++uiFirst;
+    }
+    if (uiFirst == i) {
+      szBytes += (size_t)uiLength + 1;
+      ++uiStrings;
+    }
+    check(ccaStored[i] && strlen(ccaStored[i]) == uiLength && !memcmp(ccaStored[i], acText + i % 7, uiLength), "stored copy");
+    check(ccaInterned[i] && ccaInterned[i] == ccaInterned[uiFirst], "interned copy");
+    check(internString(spPool, acText + i % 7, uiLength) == ccaInterned[i], "intern again");
+  }
+  check(getPooledStringCount(spPool) == uiStrings, "count");
+  check(getStringPoolSize(spPool) == szBytes, "size");
+}
+
+static void check(int iCondition, const char * ccaName) {
+  if (!iCondition) {
+    fprintf(stderr, "strpool: %s failed\n", ccaName);
+    ++uiFailures;
+  }
+}
@@ -0,0 +1,455 @@
+/*! \file tokenizer.c
+  \brief Parallel tokenizer test.
+  Parses generated lists with the serial and the parallel tokenizer and checks both send the same tokens in the same order,
+  return the same result and report an error at the same line and column.
+  Lists are made of long tokens, so chunk boundaries fall inside tokens, or of short tokens between long runs of skipped characters,
+  the word lists have no comments and skip characters that are neither letters nor separators instead.
+  A list without newlines puts the errors on the first line of a chunk, whose column depends on all chunks before it.
+  Errors are placed in the last chunk.
+  Then parses a list with tokens copied into an arena and through a memory counter, and checks all memory is released.
+  Finally runs out of memory while copying and batching tokens, which must be reported as such.
+*/
+
+#include "../src/alloc.h"
+#include "../src/tokenizer.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TEST_LONG_TOKEN 4000                      //!< Longest token of lists made of long tokens.
+#define TEST_SHORT_TOKEN 12                       //!< Longest token of lists with skipped runs.
+#define TEST_SKIPPED_RUN 3000                     //!< Longest run of skipped characters.
+#define TEST_REPORT_SIZE 256                      //!< Size of buffer of a captured error report.
+
+// ----------------- Struct definitions -----------------------------------
+
+/*! \enum InputKinds
+  \brief Kinds of generated lists.
+*/
+enum InputKinds {
+  IKLongTokens = 0,                               //!< Long tokens on lines of any ending.
+  IKSkippedRuns,                                  //!< Short tokens, each followed by a run of skipped characters.
+  IKSingleLine,                                   //!< Long tokens separated by spaces only.
+  IKCount                                         //!< Amount of kinds.
+};
+
+/*! \struct TokenLog
+  \brief Tokens received by a parse, each followed by a newline.
+*/
+struct TokenLog {
+  char * pData;                                   //!< Text of tokens.
+  size_t szLength;                                //!< Amount of characters used.
+  size_t szCapacity;                              //!< Amount of characters allocated.
+};
+
+// ----------------- Local Variables --------------------------------------
+
+static const size_t cszLengths[] = { 5 << 19, 9 << 19 }; //!< Lengths of generated lists, large enough to be split into 2 to 4 chunks.
+static const uint32_t cauiThreads[] = { 2, 5 };   //!< Thread counts of parallel parses.
+static const char * ccaErrors[] = { NULL, "Ab cD", "Ab\n", ";" }; //!< Texts placed behind a ';' late in the list, NULL for none.
+static struct TokenLog tlKept;                    //!< Tokens received by 'keepToken'.
+static const struct Allocator * cpaTokens;        //!< Allocator tokens received by 'keepToken' are released through.
+static uint32_t uiBudget;                         //!< Amount of allocations the failing allocator still grants.
+static uint32_t uiFailures;                       //!< Amount of failed checks.
+
+// ----------------- Local Function declarations --------------------------
+
+/*! \brief Creates list.
+  \param uiKind Kind of list, as 'enum InputKinds'.
+  \param szLength Least length of list.
+  \param ccaError Text placed behind the first ';' after nine tenths of the list, NULL for none.
+  \param pszLength Receives length of list.
+  \return Created list or NULL when memory could not be allocated.
+*/
+static char * createInput(uint32_t uiKind, size_t szLength, const char * ccaError, size_t * pszLength);
+/*! \brief Parses list and captures error report.
+  \param ccaPath Path of list.
+  \param uiThreads Amount of threads, 1 for the serial tokenizer.
+  \param ptlLog Receives tokens.
+  \param caReport Receives error report printed by the tokenizer, empty when none.
+  \return Result of parse.
+*/
+static enum ParseResults captureParse(const char * ccaPath, uint32_t uiThreads, struct TokenLog * ptlLog, char * caReport);
+/*! \brief Logs token.
+  \param pContext 'TokenLog' receiving token.
+  \param ttType Type of token, ignored.
+  \param ptvToken Token to log.
+  \return 1 on success, 0 when memory could not be allocated.
+*/
+static int8_t logToken(void * pContext, enum TokenType ttType, const struct TokenView * ptvToken);
+/*! \brief Checks parses with allocators.
+  \param ccaPath Path of list without errors.
+*/
+static void checkAllocators(const char * ccaPath);
+/*! \brief Checks parses running out of memory.
+  \param ccaPath Path to write list to.
+*/
+static void checkOutOfMemory(const char * ccaPath);
+/*! \brief Allocates unless budget is spent.
+  \param pContext Unused.
+  \param szSize Amount of bytes.
+  \param atTag Tag of allocation, ignored.
+  \return Allocated memory or NULL.
+*/
+static void * allocateFailing(void * pContext, size_t szSize, enum AllocationTags atTag);
+/*! \brief Resizes unless budget is spent.
+  \param pContext Unused.
+  \param pMemory Memory to resize.
+  \param szSize Amount of bytes.
+  \param atTag Tag of allocation, ignored.
+  \return Resized memory or NULL.
+*/
+static void * reallocateFailing(void * pContext, void * pMemory, size_t szSize, enum AllocationTags atTag);
+/*! \brief Frees memory of failing allocator.
+  \param pContext Unused.
+  \param pMemory Memory to free.
+*/
+static void freeFailing(void * pContext, void * pMemory);
+/*! \brief Keeps token.
+  Logs token in 'tlKept' and releases it through 'cpaTokens'.
+  \param ttType Type of token, ignored.
+  \param token Token to keep.
+  \return 1 on success, 0 when memory could not be allocated.
+*/
+static int8_t keepToken(enum TokenType ttType, Token token);
+/*! \brief Counts tokens of batch.
+  \param pContext Amount of tokens so far, as 'uint32_t'.
+  \param ttType Type of tokens, ignored.
+  \param ptvTokens Tokens of batch, ignored.
+  \param uiCount Amount of tokens in batch.
+  \return 1.
+*/
+static int8_t countBatch(void * pContext, enum TokenType ttType, const struct TokenView * ptvTokens, uint32_t uiCount);
+/*! \brief Appends text to log.
+  \param ptlLog Log to append to.
+  \param ccaText Text of token, not NUL-terminated.
+  \param uiLength Amount of characters.
+  \return 1 on success, 0 when memory could not be allocated.
+*/
+static int8_t appendLog(struct TokenLog * ptlLog, const char * ccaText, uint32_t uiLength);
+/*! \brief Generates random number.
+  \param puiState State of generator.
+  \param uiRange Amount of possible numbers.
+  \return Number from 0 to 'uiRange' - 1.
+*/
+static uint32_t getRandom(uint64_t * puiState, uint32_t uiRange);
+/*! \brief Checks condition.
+  \param iCondition Condition that must hold.
+  \param ccaName Name of check reported on failure.
+*/
+static void check(int iCondition, const char * ccaName);
+
+// ----------------- Global Function definitions --------------------------
+
+int main(void) {
+  char caPath[] = "/tmp/tokenizerXXXXXX";
+  char caSerialReport[TEST_REPORT_SIZE];
+  char caParallelReport[TEST_REPORT_SIZE];
+  int iFile = mkstemp(caPath);
+  uint32_t uiKind, i, j, k;
+  if (iFile < 0) {
+    return 1;
+  }
+  close(iFile);
+  for (uiKind = 0; uiKind < IKCount; ++uiKind) {
+    for (i = 0; i < sizeof(cszLengths) / sizeof(cszLengths[0]); ++i) {
+      for (j = 0; j < sizeof(ccaErrors) / sizeof(ccaErrors[0]); ++j) {
+	size_t szLength;
+	char * caInput = createInput(uiKind, cszLengths[i], ccaErrors[j], &szLength);
+	FILE * file = caInput ? fopen(caPath, "wb") : NULL;
+	int8_t iWritten = file && fwrite(caInput, 1, szLength, file) == szLength;
+	if (file && fclose(file)) {
+	  iWritten = 0;
+	}
+	free(caInput);
+	if (!iWritten) {
+	  check(0, "write list");
+	  continue;
+	}
+	struct TokenLog tlSerial = { NULL, 0, 0 };
+	enum ParseResults prSerial = captureParse(caPath, 1, &tlSerial, caSerialReport);
+	check(tlSerial.szLength > 0, "serial tokens");
+	check(ccaErrors[j] ? prSerial != ROk && caSerialReport[0] : prSerial == ROk && !caSerialReport[0], "serial result");
+	for (k = 0; k < sizeof(cauiThreads) / sizeof(cauiThreads[0]); ++k) {
+	  struct TokenLog tlParallel = { NULL, 0, 0 };
+	  enum ParseResults prParallel = captureParse(caPath, cauiThreads[k], &tlParallel, caParallelReport);
+	  check(tlParallel.szLength == tlSerial.szLength && !memcmp(tlParallel.pData, tlSerial.pData, tlSerial.szLength), "same tokens in same order");
+	  check(prParallel == prSerial, "same result");
+	  check(!strcmp(caParallelReport, caSerialReport), "same error line and column");
+	  free(tlParallel.pData);
+	}
+	free(tlSerial.pData);
+      }
+    }
+  }
+  size_t szLength;
+  char * caInput = createInput(IKSkippedRuns, cszLengths[0], NULL, &szLength);
+  FILE * file = caInput ? fopen(caPath, "wb") : NULL;
+  int8_t iWritten = file && fwrite(caInput, 1, szLength, file) == szLength;
+  if (file && fclose(file)) {
+    iWritten = 0;
+  }
+  free(caInput);
+  check(iWritten, "write list");
+  if (iWritten) {
+    checkAllocators(caPath);
+  }
+  checkOutOfMemory(caPath);
+  unlink(caPath);
+  printf("tokenizer: %u failures\n", uiFailures);
+  return uiFailures ? 1 : 0;
+}
+
+// ----------------- Local Function definitions ---------------------------
+
+static char * createInput(uint32_t uiKind, size_t szLength, const char * ccaError, size_t * pszLength) {
+  static const char ccaSkipped[] = "0123456789.,:-_+#*()";
+  static const char * ccaSeparators[] = { " ", "", "\n", "\r\n", "\n\r", "\r" };
+  size_t szCapacity = szLength + TEST_LONG_TOKEN + TEST_SKIPPED_RUN + 16;
+  char * caInput = (char *)malloc(szCapacity);
+  uint32_t uiSeparators = uiKind == IKSingleLine ? 2 : sizeof(ccaSeparators) / sizeof(ccaSeparators[0]);
+  uint64_t uiState = 0x9E3779B97F4A7C15ULL + uiKind;
+  size_t szUsed = 0;
+  uint32_t i, uiCount;
+  if (!caInput) {
+    return NULL;
+  }
+  while (szUsed < szLength) {
+    uiCount = 1 + getRandom(&uiState, uiKind == IKSkippedRuns ? TEST_SHORT_TOKEN : TEST_LONG_TOKEN);
+    for (i = 0; i < uiCount; ++i) {
+      uint32_t uiLetter = getRandom(&uiState, 52);
+      caInput[szUsed++] = (char)(uiLetter < 26 ? 'a' + uiLetter : 'A' + uiLetter - 26);
+    }
+    caInput[szUsed++] = ';';
+    const char * ccaSeparator = ccaSeparators[getRandom(&uiState, uiSeparators)];
+    memcpy(caInput + szUsed, ccaSeparator, strlen(ccaSeparator));
+    szUsed += strlen(ccaSeparator);
+    // skipped characters never end a token, so they only follow a ';'
+    uiCount = uiKind == IKSkippedRuns ? getRandom(&uiState, TEST_SKIPPED_RUN) : 0;
+    for (i = 0; i < uiCount; ++i) {
+      caInput[szUsed++] = ccaSkipped[getRandom(&uiState, sizeof(ccaSkipped) - 1)];
+    }
+  }
+  caInput[szUsed++] = '\n';
+  if (ccaError) {
+    char * pSeparator = (char *)memchr(caInput + szUsed / 10 * 9, ';', szUsed - szUsed / 10 * 9);
+    if (!pSeparator || (size_t)(caInput + szUsed - pSeparator) <= strlen(ccaError) + 1) {
+      free(caInput);
+      return NULL;
+    }
+    memcpy(pSeparator + 1, ccaError, strlen(ccaError));
+  }
+  *pszLength = szUsed;
+  return caInput;
+}
+
+static enum ParseResults captureParse(const char * ccaPath, uint32_t uiThreads, struct TokenLog * ptlLog, char * caReport) {
+  char caReportPath[] = "/tmp/tokenizerXXXXXX";
+  int iReport = mkstemp(caReportPath);
+  int iStdout = dup(STDOUT_FILENO);
+  enum ParseResults result;
+  caReport[0] = '\0';
+  if (iReport < 0 || iStdout < 0) {
+    check(0, "capture report");
+    return RErrFileAccess;
+  }
+  unlink(caReportPath);
+  fflush(stdout);
+  dup2(iReport, STDOUT_FILENO);
+  if (uiThreads > 1) {
+    result = parseFileParallel(ccaPath, &logToken, ptlLog, uiThreads, PPODefault);
+  } else {
+    result = parseFileMappedWithContext(ccaPath, &logToken, ptlLog);
+  }
+  fflush(stdout);
+  dup2(iStdout, STDOUT_FILENO);
+  close(iStdout);
+  ssize_t szRead = pread(iReport, caReport, TEST_REPORT_SIZE - 1, 0);
+  caReport[szRead > 0 ? szRead : 0] = '\0';
+  close(iReport);
+  return result;
+}
+
+static void checkAllocators(const char * ccaPath) {
+  struct TokenLog tlExpected = { NULL, 0, 0 };
+  struct TokenLog tlParallel = { NULL, 0, 0 };
+  struct MemoryStats msStats;
+  char caReport[TEST_REPORT_SIZE];
+  uint32_t uiTokens = 0;
+  size_t i;
+  check(captureParse(ccaPath, 1, &tlExpected, caReport) == ROk, "parse list");
+  for (i = 0; i < tlExpected.szLength; ++i) {
+    uiTokens += tlExpected.pData[i] == '\n';
+  }
+  MemoryCounter mcCounter = createMemoryCounter(NULL);
+  if (!mcCounter) {
+    check(0, "create counter");
+    free(tlExpected.pData);
+    return;
+  }
+  setDefaultAllocator(getCounterAllocator(mcCounter));
+
+  // tokens copied into an arena are released with it, releasing them one by one does nothing
+  Arena aArena = createArena(0, ATTokenBuffers);
+  struct ParseOptions poOptions = { 0, 0, CCAny, getArenaAllocator(aArena) };
+  cpaTokens = poOptions.cpaAllocator;
+  check(aArena && parseFileWithOptions(ccaPath, &keepToken, &poOptions) == ROk, "parse into arena");
+  check(tlKept.szLength == tlExpected.szLength && !memcmp(tlKept.pData, tlExpected.pData, tlExpected.szLength), "same tokens in arena");
+  check(getArenaSize(aArena) >= tlExpected.szLength, "copy tokens into arena");
+  destroyArena(aArena);
+  getMemoryStats(mcCounter, ATTokenBuffers, &msStats);
+  check(msStats.uiLive == 0 && msStats.szBytes == 0, "release arena");
+
+  // through a counter every token is an allocation of its own, released by the callback
+  poOptions.cpaAllocator = getCounterAllocator(mcCounter);
+  cpaTokens = poOptions.cpaAllocator;
+  tlKept.szLength = 0;
+  struct MemoryStats msBefore;
+  getMemoryStats(mcCounter, ATTokenBuffers, &msBefore);
+  check(parseFileWithOptions(ccaPath, &keepToken, &poOptions) == ROk, "parse through counter");
+  check(tlKept.szLength == tlExpected.szLength && !memcmp(tlKept.pData, tlExpected.pData, tlExpected.szLength), "same tokens through counter");
+  getMemoryStats(mcCounter, ATTokenBuffers, &msStats);
+  check(msStats.uiAllocations - msBefore.uiAllocations >= uiTokens, "count tokens");
+  check(msStats.uiLive == 0 && msStats.szBytes == 0, "release tokens");
+
+  // batched and parallel parses release all their buffers of the default allocator
+  uint32_t uiBatched = 0;
+  check(parseFileBatched(ccaPath, &countBatch, &uiBatched) == ROk && uiBatched == uiTokens, "parse batched through counter");
+  check(parseFileParallel(ccaPath, &logToken, &tlParallel, 2, PPODefault) == ROk, "parse parallel through counter");
+  check(tlParallel.szLength == tlExpected.szLength && !memcmp(tlParallel.pData, tlExpected.pData, tlExpected.szLength), "same tokens in parallel through counter");
+  getMemoryStats(mcCounter, ATTokenBuffers, &msStats);
+  check(msStats.uiLive == 0 && msStats.szBytes == 0 && msStats.szPeakBytes > 0, "release buffers");
+
+  setDefaultAllocator(NULL);
+  destroyMemoryCounter(mcCounter);
+  free(tlExpected.pData);
+  free(tlParallel.pData);
+  free(tlKept.pData);
+  tlKept.pData = NULL;
+  tlKept.szLength = 0;
+  tlKept.szCapacity = 0;
+}
+
+static void checkOutOfMemory(const char * ccaPath) {
+  static const struct Allocator caFailing = { &allocateFailing, NULL, &reallocateFailing, &freeFailing, NULL };
+  struct ParseOptions poOptions = { 0, 0, CCAny, &caFailing };
+  char caReport[TEST_REPORT_SIZE];
+  FILE * file = fopen(ccaPath, "wb");
+  int8_t iWritten = file && fputs("ab;\ncd;\nef;\n", file) >= 0;
+  if (file && fclose(file)) {
+    iWritten = 0;
+  }
+  if (!iWritten) {
+    check(0, "write list");
+    return;
+  }
+  // the list is mapped, so the only allocations are copies of tokens
+  cpaTokens = &caFailing;
+  tlKept.szLength = 0;
+  uiBudget = 1;
+  fflush(stdout);
+  int iStdout = dup(STDOUT_FILENO);
+  char caReportPath[] = "/tmp/tokenizerXXXXXX";
+  int iReport = mkstemp(caReportPath);
+  if (iStdout < 0 || iReport < 0) {
+    check(0, "capture report");
+    return;
+  }
+  unlink(caReportPath);
+  dup2(iReport, STDOUT_FILENO);
+  enum ParseResults prCopied = parseFileWithOptions(ccaPath, &keepToken, &poOptions);
+  // batches allocate their views first, then fail to allocate their text
+  uiBudget = 1;
+  uint32_t uiBatched = 0;
+  enum ParseResults prBatched = parseFileBatchedWithOptions(ccaPath, &countBatch, &uiBatched, &poOptions);
+  fflush(stdout);
+  dup2(iStdout, STDOUT_FILENO);
+  close(iStdout);
+  ssize_t szRead = pread(iReport, caReport, TEST_REPORT_SIZE - 1, 0);
+  caReport[szRead > 0 ? szRead : 0] = '\0';
+  close(iReport);
+  check(prCopied == RErrOutOfMemory && tlKept.szLength == 3 && !memcmp(tlKept.pData, "ab\n", 3), "run out of memory copying tokens");
+  check(prBatched == RErrOutOfMemory && !uiBatched, "run out of memory batching tokens");
+  check(strstr(caReport, "Out of memory at line 2[3]\n") && strstr(caReport, "Out of memory at line 1[3]\n") && !strstr(caReport, "Unexpected"), "report out of memory");
+  free(tlKept.pData);
+  tlKept.pData = NULL;
+  tlKept.szCapacity = 0;
+}
+
+static void * allocateFailing(void * pContext, size_t szSize, enum AllocationTags atTag) {
+  (void)pContext;
+  (void)atTag;
+  if (!uiBudget) {
+    return NULL;
+  }
+  --uiBudget;
+  return malloc(szSize);
+}
+
+static void * reallocateFailing(void * pContext, void * pMemory, size_t szSize, enum AllocationTags atTag) {
+  (void)pContext;
+  (void)atTag;
+  if (!uiBudget) {
+    return NULL;
+  }
+  --uiBudget;
+  return realloc(pMemory, szSize);
+}
+
+static void freeFailing(void * pContext, void * pMemory) {
+  (void)pContext;
+  free(pMemory);
+}
+
+static int8_t keepToken(enum TokenType ttType, Token token) {
+  int8_t iResult = appendLog(&tlKept, token, (uint32_t)strlen(token));
+  (void)ttType;
+  freeMemory(cpaTokens, (void *)token);
+  return iResult;
+}
+
+static int8_t countBatch(void * pContext, enum TokenType ttType, const struct TokenView * ptvTokens, uint32_t uiCount) {
+  (void)ttType;
+  (void)ptvTokens;
+  *(uint32_t *)pContext += uiCount;
+  return 1;
+}
+
+static int8_t logToken(void * pContext, enum TokenType ttType, const struct TokenView * ptvToken) {
+  (void)ttType;
+  return appendLog((struct TokenLog *)pContext, ptvToken->pText, ptvToken->uiLength);
+}
+
+static int8_t appendLog(struct TokenLog * ptlLog, const char * ccaText, uint32_t uiLength) {
+  if (ptlLog->szLength + uiLength + 1 > ptlLog->szCapacity) {
+    size_t szCapacity = ptlLog->szCapacity ? ptlLog->szCapacity : 4096;
+    while (szCapacity < ptlLog->szLength + uiLength + 1) {
+      szCapacity *= 2;
+    }
+    char * pData = (char *)realloc(ptlLog->pData, szCapacity);
+    if (!pData) {
+      return 0;
+    }
+    ptlLog->pData = pData;
+    ptlLog->szCapacity = szCapacity;
+  }
+  memcpy(ptlLog->pData + ptlLog->szLength, ccaText, uiLength);
+  ptlLog->szLength += uiLength;
+  ptlLog->pData[ptlLog->szLength++] = '\n';
+  return 1;
+}
+
+static uint32_t getRandom(uint64_t * puiState, uint32_t uiRange) {
+  *puiState = *puiState * 6364136223846793005ULL + 1442695040888963407ULL;
+  return (uint32_t)((*puiState >> 33) % uiRange);
+}
+
+static void check(int iCondition, const char * ccaName) {
+  if (!iCondition) {
+    fprintf(stderr, "tokenizer: %s failed\n", ccaName);
+    ++uiFailures;
+  }
+}